@@ -14,9 +14,13 @@
 #ifndef ARITHMETIC_SEQUENCE_DOMAIN_HPP
 #define ARITHMETIC_SEQUENCE_DOMAIN_HPP
 
+#include <istream>
 #include <memory>
+#include <mutex>
+#include <ostream>
 
 #include <libfqfft/evaluation_domain/evaluation_domain.hpp>
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.hpp>
 
 namespace libfqfft {
 
@@ -25,24 +29,65 @@ namespace libfqfft {
   public:
     
     bool precomputation_sentinel;
-    std::vector<std::vector<std::vector<FieldT> > > subproduct_tree;
+    flat_subproduct_tree<FieldT> subproduct_tree;
     std::vector<FieldT> arithmetic_sequence;
     FieldT arithmetic_generator;
     void do_precomputation();
 
+    /**
+     * Compute the tables above (subproduct_tree, arithmetic_sequence) if they have not been
+     * computed yet, using all threads under MULTICORE. This is safe to call concurrently;
+     * every transform calls it first, but calling it ahead of time takes the cost off the
+     * first transform. Once computed, the tables are not modified again, so threads
+     * sharing the domain can read them concurrently.
+     *
+     * (do_precomputation() recomputes the tables unconditionally and is not thread-safe.)
+     */
+    void precompute();
+
+    /**
+     * Write the tables above (computing them first if needed) as binary records (see
+     * binary_serialization.hpp), or read them back, so that a later process does not
+     * need to compute them. The tables must have been saved by a domain of the same size
+     * and field (a SerializationException is thrown otherwise); if this domain already
+     * has its tables, the saved ones are dropped. Both are safe to call concurrently
+     * with transforms.
+     */
+    void save_precomputation(std::ostream &out);
+    void load_precomputation(std::istream &in);
+
     arithmetic_sequence_domain(const size_t m);
     static std::shared_ptr<arithmetic_sequence_domain<FieldT>> create_ptr(const size_t m);
+    static bool supports(const size_t m);
+
+    using evaluation_domain<FieldT>::FFT;
+    using evaluation_domain<FieldT>::iFFT;
+    using evaluation_domain<FieldT>::cosetFFT;
+    using evaluation_domain<FieldT>::icosetFFT;
 
     void FFT(std::vector<FieldT> &a);
     void iFFT(std::vector<FieldT> &a);
     void cosetFFT(std::vector<FieldT> &a, const FieldT &g);
     void icosetFFT(std::vector<FieldT> &a, const FieldT &g);
     std::vector<FieldT> evaluate_all_lagrange_polynomials(const FieldT &t);
+    void evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out);
+    void evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out);
     FieldT get_domain_element(const size_t idx);
     FieldT compute_vanishing_polynomial(const FieldT &t);
     void add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H);
     void divide_by_Z_on_coset(std::vector<FieldT> &P);
 
+  private:
+
+    std::once_flag precomputation_flag;
+
+    /* The barycentric weights of the domain, computed on the first Lagrange evaluation */
+    std::once_flag lagrange_flag;
+    std::vector<FieldT> lagrange_weights;
+
+    void precompute_lagrange();
+    void evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out);
+
   };
 
 } // libfqfft
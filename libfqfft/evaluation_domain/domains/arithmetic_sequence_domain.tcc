@@ -14,12 +14,13 @@
 #ifndef ARITHMETIC_SEQUENCE_DOMAIN_TCC_
 #define ARITHMETIC_SEQUENCE_DOMAIN_TCC_
 
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
 #include <libfqfft/polynomial_arithmetic/basis_change.hpp>
-
-#ifdef MULTICORE
-#include <omp.h>
-#endif
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/binary_serialization.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -33,12 +34,18 @@ arithmetic_sequence_domain<FieldT>::arithmetic_sequence_domain(const size_t m) :
   precomputation_sentinel = 0;
 }
 
+template<typename FieldT>
+bool arithmetic_sequence_domain<FieldT>::supports(const size_t m)
+{
+  if (m <= 1) return false;
+  return !(FieldT::arithmetic_generator() == FieldT::zero());
+}
+
 template<typename FieldT>
 std::shared_ptr<arithmetic_sequence_domain<FieldT>> arithmetic_sequence_domain<FieldT>::create_ptr(const size_t m)
 {
   std::shared_ptr<arithmetic_sequence_domain<FieldT>> result;
-  if (m <= 1) return result;
-  if (FieldT::arithmetic_generator() == FieldT::zero()) return result;
+  if (!supports(m)) return result;
 
   result.reset(new arithmetic_sequence_domain<FieldT>(m));
   return result;
@@ -47,55 +54,63 @@ std::shared_ptr<arithmetic_sequence_domain<FieldT>> arithmetic_sequence_domain<F
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::FFT(std::vector<FieldT> &a)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::FFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   if (a.size() != this->m) throw DomainSizeException("arithmetic: expected a.size() == this->m");
 
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   /* Monomial to Newton */
   monomial_to_newton_basis(a, this->subproduct_tree, this->m);
   
   /* Newton to Evaluation */
-  std::vector<FieldT> S(this->m); /* i! * arithmetic_generator */
-  S[0] = FieldT::one();
+  std::vector<FieldT> S_inverse(this->m); /* i! * arithmetic_generator */
+  S_inverse[0] = FieldT::one();
 
   FieldT factorial = FieldT::one();
   for (size_t i = 1; i < this->m; i++)
   {
     factorial *= FieldT(i);
-    S[i] = (factorial * this->arithmetic_generator).inverse();
+    S_inverse[i] = factorial * this->arithmetic_generator;
   }
 
+  std::vector<FieldT> S(S_inverse);
+  batch_inversion(S);
+
   _polynomial_multiplication(a, a, S);
   a.resize(this->m);
 
-#ifdef MULTICORE
-  #pragma omp parallel for
-#endif
-  for (size_t i = 0; i < this->m; i++)
-  {
-    a[i] *= S[i].inverse();
-  }
+  parallel_for(this->m, [&](const size_t i) {
+      a[i] *= S_inverse[i];
+    });
 }
 
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::iFFT(std::vector<FieldT> &a)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::iFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   if (a.size() != this->m) throw DomainSizeException("arithmetic: expected a.size() == this->m");
   
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   /* Interpolation to Newton */
   std::vector<FieldT> S(this->m); /* i! * arithmetic_generator */
   S[0] = FieldT::one();
 
+  FieldT factorial = FieldT::one();
+  for (size_t i = 1; i < this->m; i++)
+  {
+    factorial *= FieldT(i);
+    S[i] = factorial * this->arithmetic_generator;
+  }
+  batch_inversion(S);
+
   std::vector<FieldT> W(this->m);
   W[0] = a[0] * S[0];
 
-  FieldT factorial = FieldT::one();
   for (size_t i = 1; i < this->m; i++)
   {
-    factorial *= FieldT(i);
-    S[i] = (factorial * this->arithmetic_generator).inverse();
     W[i] = a[i] * S[i];
     if (i % 2 == 1) S[i] = -S[i];
   }
@@ -110,6 +125,8 @@ void arithmetic_sequence_domain<FieldT>::iFFT(std::vector<FieldT> &a)
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::cosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   _multiply_by_coset(a, g);
   FFT(a);
 }
@@ -117,6 +134,8 @@ void arithmetic_sequence_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::icosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   iFFT(a);
   _multiply_by_coset(a, g.inverse());
 }
@@ -124,61 +143,34 @@ void arithmetic_sequence_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const
 template<typename FieldT>
 std::vector<FieldT> arithmetic_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t)
 {
-  /* Compute Lagrange polynomial of size m, with m+1 points (x_0, y_0), ... ,(x_m, y_m) */
-  /* Evaluate for x = t */
-  /* Return coeffs for each l_j(x) = (l / l_i[j]) * w[j] */
-
-  if (!this->precomputation_sentinel) do_precomputation();
-
-  /**
-   * If t equals one of the arithmetic progression values,
-   * then output 1 at the right place, and 0 elsewhere.
-   */
-  for (size_t i = 0; i < this->m; ++i)
-  {
-    if (this->arithmetic_sequence[i] == t) // i.e., t equals this->arithmetic_sequence[i]
-    {
-      std::vector<FieldT> res(this->m, FieldT::zero());
-      res[i] = FieldT::one();
-      return res;
-    }
-  }
-
-  /**
-   * Otherwise, if t does not equal any of the arithmetic progression values,
-   * then compute each Lagrange coefficient.
-   */
-  std::vector<FieldT> l(this->m);
-  l[0] = t - this->arithmetic_sequence[0];
-
-  FieldT l_vanish = l[0];
-  FieldT g_vanish = FieldT::one();
-
-  for (size_t i = 1; i < this->m; i++)
-  {
-    l[i] = t - this->arithmetic_sequence[i];
-    l_vanish *= l[i];
-    g_vanish *= -this->arithmetic_sequence[i];
-  }
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  std::vector<FieldT> u(this->m);
+  LIBFQFFT_COUNT_ALLOCATION(this->m * sizeof(FieldT));
+  evaluate_lagrange_rows(&t, 1, u.data());
+  return u;
+}
 
-  std::vector<FieldT> w(this->m);
-  w[0] = g_vanish.inverse() * (this->arithmetic_generator^(this->m-1));
-  
-  l[0] = l_vanish * l[0].inverse() * w[0];
-  for (size_t i = 1; i < this->m; i++)
-  {
-    FieldT num = this->arithmetic_sequence[i-1] - this->arithmetic_sequence[this->m-1];
-    w[i] = w[i-1] * num * this->arithmetic_sequence[i].inverse();
-    l[i] = l_vanish * l[i].inverse() * w[i];
-  }
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out)
+{
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(&t, 1, out);
+}
 
-  return l;
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out)
+{
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::evaluate_all_lagrange_polynomials_batch");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(ts.data(), ts.size(), out);
 }
 
 template<typename FieldT>
 FieldT arithmetic_sequence_domain<FieldT>::get_domain_element(const size_t idx)
 {
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   return this->arithmetic_sequence[idx];
 }
@@ -186,7 +178,7 @@ FieldT arithmetic_sequence_domain<FieldT>::get_domain_element(const size_t idx)
 template<typename FieldT>
 FieldT arithmetic_sequence_domain<FieldT>::compute_vanishing_polynomial(const FieldT &t)
 {
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   /* Notes: Z = prod_{i = 0 to m} (t - a[i]) */
   FieldT Z = FieldT::one();
@@ -200,11 +192,13 @@ FieldT arithmetic_sequence_domain<FieldT>::compute_vanishing_polynomial(const Fi
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::add_poly_Z");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   libff::enter_block("arithmetic_sequence_domain::add_poly_Z");
 
   if (H.size() != this->m+1) throw DomainSizeException("arithmetic: expected H.size() == this->m+1");
 
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   std::vector<FieldT> x(2, FieldT::zero());
   x[0] = -this->arithmetic_sequence[0];
@@ -220,13 +214,9 @@ void arithmetic_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::ve
     _polynomial_multiplication(x, x, t);
   }
 
-#ifdef MULTICORE
-  #pragma omp parallel for
-#endif
-  for (size_t i = 0; i < this->m+1; i++)
-  {
-    H[i] += (x[i] * coeff);
-  }
+  parallel_for(this->m+1, [&](const size_t i) {
+      H[i] += (x[i] * coeff);
+    });
 
   libff::leave_block("arithmetic_sequence_domain::add_poly_Z");
 }
@@ -234,6 +224,8 @@ void arithmetic_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::ve
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT> &P)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::divide_by_Z_on_coset");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   const FieldT coset = this->arithmetic_generator; /* coset in arithmetic sequence? */
   const FieldT Z_inverse_at_coset = this->compute_vanishing_polynomial(coset).inverse();
   for (size_t i = 0; i < this->m; ++i)
@@ -245,19 +237,97 @@ void arithmetic_sequence_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT
 template<typename FieldT>
 void arithmetic_sequence_domain<FieldT>::do_precomputation()
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("arithmetic_sequence_domain::precompute");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   compute_subproduct_tree((size_t)log2(this->m), this->subproduct_tree);
 
   this->arithmetic_generator = FieldT::arithmetic_generator();
 
   this->arithmetic_sequence = std::vector<FieldT>(this->m);
-  for (size_t i = 0; i < this->m; i++)
-  {
-    this->arithmetic_sequence[i] = this->arithmetic_generator * FieldT(i);
-  }
+  parallel_for(this->m, [&](const size_t i) {
+      this->arithmetic_sequence[i] = this->arithmetic_generator * FieldT(i);
+    });
 
   this->precomputation_sentinel = 1;
 }
 
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::precompute()
+{
+  std::call_once(this->precomputation_flag, &arithmetic_sequence_domain<FieldT>::do_precomputation, this);
+}
+
+/*
+ With a = arithmetic_sequence and d = arithmetic_generator, the weights are
+ w_0 = d^{m-1} / prod_{k>0} (-a[k]) and w_i = w_{i-1} * (a[i-1] - a[m-1]) / a[i].
+ */
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::precompute_lagrange()
+{
+  precompute();
+
+  std::call_once(this->lagrange_flag, [this]() {
+    FieldT g_vanish = FieldT::one();
+    for (size_t i = 1; i < this->m; i++)
+    {
+      g_vanish *= -this->arithmetic_sequence[i];
+    }
+
+    /* arithmetic_sequence[0] is zero and unused below */
+    std::vector<FieldT> arithmetic_sequence_inverse(this->arithmetic_sequence);
+    batch_inversion(arithmetic_sequence_inverse.data() + 1, this->m - 1);
+
+    std::vector<FieldT> w(this->m);
+    w[0] = g_vanish.inverse() * (this->arithmetic_generator^(this->m-1));
+    for (size_t i = 1; i < this->m; i++)
+    {
+      FieldT num = this->arithmetic_sequence[i-1] - this->arithmetic_sequence[this->m-1];
+      w[i] = w[i-1] * num * arithmetic_sequence_inverse[i];
+    }
+
+    this->lagrange_weights.swap(w);
+  });
+}
+
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out)
+{
+  precompute_lagrange();
+
+  _barycentric_lagrange_evaluation<FieldT>(this->m, this->arithmetic_sequence.data(), FieldT::one(),
+                                           this->lagrange_weights.data(), FieldT::one(), ts, k, nullptr, out);
+}
+
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::save_precomputation(std::ostream &out)
+{
+  precompute();
+
+  write_binary(out, this->subproduct_tree);
+  write_binary(out, this->arithmetic_sequence);
+  write_binary(out, &this->arithmetic_generator, 1);
+}
+
+template<typename FieldT>
+void arithmetic_sequence_domain<FieldT>::load_precomputation(std::istream &in)
+{
+  flat_subproduct_tree<FieldT> tree;
+  std::vector<FieldT> sequence, generator;
+  read_binary(in, tree);
+  read_binary(in, sequence);
+  read_binary(in, generator);
+
+  if (tree.size() != (size_t)log2(this->m) + 1 || sequence.size() != this->m || generator.size() != 1)
+    throw SerializationException("arithmetic: saved precomputation does not match the domain");
+
+  std::call_once(this->precomputation_flag, [&]() {
+    std::swap(this->subproduct_tree, tree);
+    this->arithmetic_sequence.swap(sequence);
+    this->arithmetic_generator = generator[0];
+    this->precomputation_sentinel = 1;
+  });
+}
+
 } // libfqfft
 
 #endif // ARITHMETIC_SEQUENCE_DOMAIN_TCC_
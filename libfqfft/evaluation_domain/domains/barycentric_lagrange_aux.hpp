@@ -0,0 +1,44 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for the evaluation of all the Lagrange polynomials of a
+ domain at several points, in barycentric form.
+
+ For a domain S = (x_i)_{i < m} with vanishing polynomial Z(z) = prod_i (z - x_i)
+ and barycentric weights v_i = 1 / prod_{k != i} (x_i - x_k),
+ \f[   L_{i,S}(t) = Z(t) * v_i / (t - x_i)   \f]
+ for t not in S (and L_{i,S}(x_i) = 1, L_{i,S}(x_k) = 0 for k != i). The domains
+ keep their weights (or a closed form of them), so that each point only costs the
+ differences t - x_i, their inverses, and one product per coefficient.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BARYCENTRIC_LAGRANGE_AUX_HPP_
+#define BARYCENTRIC_LAGRANGE_AUX_HPP_
+
+#include <cstddef>
+
+namespace libfqfft {
+
+/**
+ * Write the m Lagrange coefficients at ts[j] to out[j*m .. (j+1)*m), for j < k, with a
+ * single batch inversion for all the points, where
+ * - the points x_i of the domain are points[i], or omega^i if points is null,
+ * - the weights v_i are weights[i], or weight_scale * x_i if weights is null, and
+ * - Z[j] is the vanishing polynomial at ts[j], or, if Z is null, is computed as
+ *   prod_i (ts[j] - x_i).
+ */
+template<typename FieldT>
+void _barycentric_lagrange_evaluation(const size_t m, const FieldT *points, const FieldT &omega,
+                                      const FieldT *weights, const FieldT &weight_scale,
+                                      const FieldT *ts, const size_t k, const FieldT *Z, FieldT *out);
+
+} // libfqfft
+
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.tcc>
+
+#endif // BARYCENTRIC_LAGRANGE_AUX_HPP_
@@ -0,0 +1,157 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for the evaluation of all the Lagrange polynomials of a
+ domain at several points, in barycentric form.
+
+ See barycentric_lagrange_aux.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BARYCENTRIC_LAGRANGE_AUX_TCC_
+#define BARYCENTRIC_LAGRANGE_AUX_TCC_
+
+#include <algorithm>
+#include <vector>
+
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
+
+namespace libfqfft {
+
+template<typename FieldT>
+void _barycentric_lagrange_evaluation(const size_t m, const FieldT *points, const FieldT &omega,
+                                      const FieldT *weights, const FieldT &weight_scale,
+                                      const FieldT *ts, const size_t k, const FieldT *Z, FieldT *out)
+{
+    const size_t n = k * m;
+    if (n == 0) return;
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(n, (points ? 0 : n) + (Z ? 0 : n) + 2 * n, 0);
+
+    /* The k rows of m coefficients are split in chunks of consecutive coefficients, whatever k and m */
+    const size_t num_chunks = std::min(execution_concurrency(), n);
+
+    /* out[j*m + i] = ts[j] - x_i */
+    parallel_for(num_chunks, [&](const size_t c) {
+            const size_t start = c * n / num_chunks, end = (c + 1) * n / num_chunks;
+            size_t j = start / m, i = start - j * m;
+            FieldT x = (points ? FieldT::one() : omega^i);
+            for (size_t e = start; e < end; ++e)
+            {
+                out[e] = ts[j] - (points ? points[i] : x);
+                if (!points) x *= omega;
+                if (++i == m)
+                {
+                    i = 0;
+                    ++j;
+                    x = FieldT::one();
+                }
+            }
+        });
+
+    std::vector<FieldT> vanishing(k);
+    if (Z)
+    {
+        std::copy(Z, Z + k, vanishing.begin());
+    }
+    else
+    {
+        /* Z[j] = prod_i (ts[j] - x_i), by partial products over ranges of columns */
+        const size_t num_column_chunks = std::min(execution_concurrency(), m);
+        std::vector<FieldT> partial(num_column_chunks * k, FieldT::one());
+        parallel_for(num_column_chunks, [&](const size_t c) {
+                const size_t start = c * m / num_column_chunks, end = (c + 1) * m / num_column_chunks;
+                for (size_t j = 0; j < k; ++j)
+                {
+                    FieldT p = FieldT::one();
+                    for (size_t i = start; i < end; ++i)
+                    {
+                        p *= out[j * m + i];
+                    }
+                    partial[c * k + j] = p;
+                }
+            });
+
+        for (size_t j = 0; j < k; ++j)
+        {
+            vanishing[j] = partial[j];
+            for (size_t c = 1; c < num_column_chunks; ++c)
+            {
+                vanishing[j] *= partial[c * k + j];
+            }
+        }
+    }
+
+    /*
+     The points in S get 1 at their index and 0 elsewhere; their rows are set to 1 before the
+     inversion (hit[j] is m for the other points). The hits are found from the differences
+     themselves, as Z may not vanish exactly on S (e.g. for Double).
+     */
+    std::vector<size_t> hit(k, m);
+    parallel_for(k, [&](const size_t j) {
+            FieldT *row = out + j * m;
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (row[i] == FieldT::zero())
+                {
+                    hit[j] = i;
+                    break;
+                }
+            }
+            if (hit[j] < m) std::fill(row, row + m, FieldT::one());
+        });
+
+    batch_inversion(out, n);
+
+    /* The weights are folded in: the factor of row j is Z(ts[j]) * v_i */
+    std::vector<FieldT> row_factors(vanishing);
+    if (!weights)
+    {
+        for (size_t j = 0; j < k; ++j)
+        {
+            row_factors[j] *= weight_scale;
+        }
+    }
+
+    parallel_for(num_chunks, [&](const size_t c) {
+            const size_t start = c * n / num_chunks, end = (c + 1) * n / num_chunks;
+            size_t j = start / m, i = start - j * m;
+            /* Without tables, l = Z(ts[j]) * weight_scale * omega^i */
+            FieldT l = (points || weights ? FieldT::one() : row_factors[j] * (omega^i));
+            for (size_t e = start; e < end; ++e)
+            {
+                if (hit[j] < m)
+                {
+                    out[e] = (i == hit[j] ? FieldT::one() : FieldT::zero());
+                }
+                else if (weights)
+                {
+                    out[e] *= row_factors[j] * weights[i];
+                }
+                else if (points)
+                {
+                    out[e] *= row_factors[j] * points[i];
+                }
+                else
+                {
+                    out[e] *= l;
+                    l *= omega;
+                }
+                if (++i == m)
+                {
+                    i = 0;
+                    ++j;
+                    if (j < k) l = row_factors[j];
+                }
+            }
+        });
+}
+
+} // libfqfft
+
+#endif // BARYCENTRIC_LAGRANGE_AUX_TCC_
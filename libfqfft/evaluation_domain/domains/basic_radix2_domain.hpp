@@ -14,8 +14,11 @@
 #ifndef BASIC_RADIX2_DOMAIN_HPP_
 #define BASIC_RADIX2_DOMAIN_HPP_
 
-#include <vector>
+#include <istream>
 #include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
 
 #include <libfqfft/evaluation_domain/evaluation_domain.hpp>
 
@@ -27,18 +30,78 @@ public:
 
     FieldT omega;
 
+    /**
+     * Per-stage twiddle factors for omega and omega^{-1}
+     * (see _basic_radix2_twiddle_table), shared by FFT, iFFT and the coset variants.
+     */
+    std::vector<FieldT> twiddles;
+    std::vector<FieldT> inverse_twiddles;
+
     basic_radix2_domain(const size_t m);
     static std::shared_ptr<basic_radix2_domain<FieldT>> create_ptr(const size_t m);
+    static bool supports(const size_t m);
     void FFT(std::vector<FieldT> &a);
     void iFFT(std::vector<FieldT> &a);
     void cosetFFT(std::vector<FieldT> &a, const FieldT &g);
     void icosetFFT(std::vector<FieldT> &a, const FieldT &g);
+    void FFT(const FieldT *in, FieldT *out, const size_t n);
+    void iFFT(const FieldT *in, FieldT *out, const size_t n);
+    void cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
+    void icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
+    void FFT_batch(const std::vector<std::vector<FieldT>*> &as);
+    void iFFT_batch(const std::vector<std::vector<FieldT>*> &as);
+    void cosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g);
+    void icosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g);
     std::vector<FieldT> evaluate_all_lagrange_polynomials(const FieldT &t);
+    void evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out);
+    void evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out);
     FieldT get_domain_element(const size_t idx);
     FieldT compute_vanishing_polynomial(const FieldT &t);
     void add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H);
     void divide_by_Z_on_coset(std::vector<FieldT> &P);
 
+    /**
+     * Rebuild the twiddle tables so that together they take at most max_bytes bytes.
+     * Only the first stages that fit the budget are tabulated, the others compute
+     * their twiddle factors on the fly; a budget of 0 drops the tables altogether.
+     * By default the tables cover every stage (2*(m-1) field elements).
+     *
+     * Must not be called concurrently with a transform on this domain.
+     */
+    void set_twiddle_budget(const size_t max_bytes);
+
+    /**
+     * Write omega and the twiddle tables as binary records (see binary_serialization.hpp),
+     * or read them back in place of the current tables, which must have been saved by a
+     * domain of the same size and field (a SerializationException is thrown otherwise).
+     *
+     * load_precomputation must not be called concurrently with a transform on this domain.
+     */
+    void save_precomputation(std::ostream &out);
+    void load_precomputation(std::istream &in);
+
+    /**
+     * Get the table (g^i)_{i < m} used by cosetFFT or, if inverse is set, the table
+     * (g^{-i}/m)_{i < m} used by icosetFFT. The tables of the last few cosets are
+     * cached (this is safe to call from concurrent transforms).
+     */
+    std::shared_ptr<const std::vector<FieldT> > get_coset_powers(const FieldT &g, const bool inverse);
+
+private:
+
+    /* The Lagrange coefficients at ts[0..k), in barycentric form with v_i = omega^i / m */
+    void evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out);
+
+    struct coset_powers_entry {
+        FieldT g;
+        bool inverse;
+        std::shared_ptr<const std::vector<FieldT> > powers;
+    };
+
+    static const size_t max_cached_cosets = 4;
+    std::vector<coset_powers_entry> coset_powers_cache;
+    std::mutex coset_powers_mutex;
+
 };
 
 } // libfqfft
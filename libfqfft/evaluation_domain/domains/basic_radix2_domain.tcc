@@ -14,11 +14,16 @@
 #ifndef BASIC_RADIX2_DOMAIN_TCC_
 #define BASIC_RADIX2_DOMAIN_TCC_
 
+#include <algorithm>
+#include <limits>
+
 #include <libff/algebra/fields/field_utils.hpp>
 #include <libff/common/double.hpp>
 #include <libff/common/utils.hpp>
 
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/binary_serialization.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -39,22 +44,30 @@ basic_radix2_domain<FieldT>::basic_radix2_domain(const size_t m)
   bool success;
   omega = libff::get_root_of_unity2<FieldT>(m, &success);
   if (!success) throw DomainSizeException("libff::get_root_of_unity2 invalid argument");
+
+  set_twiddle_budget(std::numeric_limits<size_t>::max());
 }
 
 template<typename FieldT>
-std::shared_ptr<basic_radix2_domain<FieldT>> basic_radix2_domain<FieldT>::create_ptr(const size_t m)
+bool basic_radix2_domain<FieldT>::supports(const size_t m)
 {
-  std::shared_ptr<basic_radix2_domain<FieldT>> result;
-  if (m <= 1) return result;
+  if (m <= 1) return false;
 
   if (!std::is_same<FieldT, libff::Double>::value) {
     const size_t logm = libff::log2(m);
-    if (logm > (FieldT::s)) return result;
+    if (logm > (FieldT::s)) return false;
   }
 
   bool success;
   libff::get_root_of_unity2<FieldT>(m, &success);
-  if (!success) return result;
+  return success;
+}
+
+template<typename FieldT>
+std::shared_ptr<basic_radix2_domain<FieldT>> basic_radix2_domain<FieldT>::create_ptr(const size_t m)
+{
+  std::shared_ptr<basic_radix2_domain<FieldT>> result;
+  if (!supports(m)) return result;
 
   result.reset(new basic_radix2_domain<FieldT>(m));
   return result;
@@ -63,43 +76,163 @@ std::shared_ptr<basic_radix2_domain<FieldT>> basic_radix2_domain<FieldT>::create
 template<typename FieldT>
 void basic_radix2_domain<FieldT>::FFT(std::vector<FieldT> &a)
 {
-    if (a.size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
-
-    _basic_radix2_FFT(a, omega);
+    FFT(a.data(), a.data(), a.size());
 }
 
 template<typename FieldT>
 void basic_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a)
 {
-    if (a.size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+    iFFT(a.data(), a.data(), a.size());
+}
 
-    _basic_radix2_FFT(a, omega.inverse());
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    cosetFFT(a.data(), a.data(), a.size(), g);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    icosetFFT(a.data(), a.data(), a.size(), g);
+}
 
-    const FieldT sconst = FieldT(a.size()).inverse();
-    for (size_t i = 0; i < a.size(); ++i)
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::FFT(const FieldT *in, FieldT *out, const size_t n)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::FFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+
+    if (in != out) std::copy(in, in + n, out);
+    _basic_radix2_FFT(out, n, omega, twiddles);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::iFFT(const FieldT *in, FieldT *out, const size_t n)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::iFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+
+    if (in != out) std::copy(in, in + n, out);
+    _basic_radix2_FFT_scaled(out, n, omega.inverse(), inverse_twiddles, std::vector<FieldT>(), FieldT(this->m).inverse(), std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::cosetFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+
+    if (in != out) std::copy(in, in + n, out);
+    const std::shared_ptr<const std::vector<FieldT> > powers = get_coset_powers(g, false);
+    _basic_radix2_FFT_scaled(out, n, omega, twiddles, *powers, FieldT::one(), std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::icosetFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+
+    if (in != out) std::copy(in, in + n, out);
+    const std::shared_ptr<const std::vector<FieldT> > powers = get_coset_powers(g, true);
+    _basic_radix2_FFT_scaled(out, n, omega.inverse(), inverse_twiddles, std::vector<FieldT>(), FieldT::one(), *powers);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::FFT_batch(const std::vector<std::vector<FieldT>*> &as)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::FFT_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    for (size_t i = 0; i < as.size(); ++i)
     {
-        a[i] *= sconst;
+        if (as[i]->size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
     }
+
+    _basic_radix2_FFT_batch(as, omega, twiddles, std::vector<FieldT>(), FieldT::one(), std::vector<FieldT>());
 }
 
 template<typename FieldT>
-void basic_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
+void basic_radix2_domain<FieldT>::iFFT_batch(const std::vector<std::vector<FieldT>*> &as)
 {
-    _multiply_by_coset(a, g);
-    FFT(a);
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::iFFT_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        if (as[i]->size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+    }
+
+    _basic_radix2_FFT_batch(as, omega.inverse(), inverse_twiddles, std::vector<FieldT>(), FieldT(this->m).inverse(), std::vector<FieldT>());
 }
 
 template<typename FieldT>
-void basic_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
+void basic_radix2_domain<FieldT>::cosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::cosetFFT_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        if (as[i]->size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+    }
+
+    const std::shared_ptr<const std::vector<FieldT> > powers = get_coset_powers(g, false);
+    _basic_radix2_FFT_batch(as, omega, twiddles, *powers, FieldT::one(), std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::icosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g)
 {
-    iFFT(a);
-    _multiply_by_coset(a, g.inverse());
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::icosetFFT_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        if (as[i]->size() != this->m) throw DomainSizeException("basic_radix2: expected a.size() == this->m");
+    }
+
+    const std::shared_ptr<const std::vector<FieldT> > powers = get_coset_powers(g, true);
+    _basic_radix2_FFT_batch(as, omega.inverse(), inverse_twiddles, std::vector<FieldT>(), FieldT::one(), *powers);
 }
 
 template<typename FieldT>
 std::vector<FieldT> basic_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t)
 {
-    return _basic_radix2_evaluate_all_lagrange_polynomials(this->m, t);
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::evaluate_all_lagrange_polynomials");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    std::vector<FieldT> u(this->m);
+    LIBFQFFT_COUNT_ALLOCATION(this->m * sizeof(FieldT));
+    evaluate_lagrange_rows(&t, 1, u.data());
+    return u;
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::evaluate_all_lagrange_polynomials");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    evaluate_lagrange_rows(&t, 1, out);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::evaluate_all_lagrange_polynomials_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    evaluate_lagrange_rows(ts.data(), ts.size(), out);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out)
+{
+    std::vector<FieldT> Z(k);
+    for (size_t j = 0; j < k; ++j)
+    {
+        Z[j] = compute_vanishing_polynomial(ts[j]);
+    }
+    _barycentric_lagrange_evaluation<FieldT>(this->m, nullptr, omega, nullptr, FieldT(this->m).inverse(), ts, k, Z.data(), out);
 }
 
 template<typename FieldT>
@@ -117,6 +250,8 @@ FieldT basic_radix2_domain<FieldT>::compute_vanishing_polynomial(const FieldT &t
 template<typename FieldT>
 void basic_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H)
 {
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::add_poly_Z");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
     libff::enter_block("basic_radix2_domain::add_poly_Z");
 
     if (H.size() != this->m+1) throw DomainSizeException("basic_radix2: expected H.size() == this->m+1");
@@ -130,6 +265,8 @@ void basic_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<Fi
 template<typename FieldT>
 void basic_radix2_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT> &P)
 {
+    LIBFQFFT_INSTRUMENT_SCOPE("basic_radix2_domain::divide_by_Z_on_coset");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
     const FieldT coset = FieldT::multiplicative_generator;
     const FieldT Z_inverse_at_coset = this->compute_vanishing_polynomial(coset).inverse();
     for (size_t i = 0; i < this->m; ++i)
@@ -138,6 +275,94 @@ void basic_radix2_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT> &P)
     }
 }
 
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::set_twiddle_budget(const size_t max_bytes)
+{
+    const size_t logm = libff::log2(this->m);
+
+    /* Both tables take 2^num_stages - 1 elements each */
+    const size_t max_elements = max_bytes / (2 * sizeof(FieldT));
+    size_t num_stages = 0;
+    while (num_stages < logm && ((size_t)1 << (num_stages + 1)) - 1 <= max_elements)
+    {
+        ++num_stages;
+    }
+
+    twiddles = _basic_radix2_twiddle_table(this->m, omega, num_stages);
+    inverse_twiddles = _basic_radix2_twiddle_table(this->m, omega.inverse(), num_stages);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::save_precomputation(std::ostream &out)
+{
+    write_binary(out, &omega, 1);
+    write_binary(out, twiddles);
+    write_binary(out, inverse_twiddles);
+}
+
+template<typename FieldT>
+void basic_radix2_domain<FieldT>::load_precomputation(std::istream &in)
+{
+    std::vector<FieldT> saved_omega, saved_twiddles, saved_inverse_twiddles;
+    read_binary(in, saved_omega);
+    read_binary(in, saved_twiddles);
+    read_binary(in, saved_inverse_twiddles);
+
+    /* Both tables cover the same 2^num_stages - 1 elements, with num_stages <= log2(m) */
+    const size_t n = saved_twiddles.size() + 1;
+    if (saved_omega.size() != 1 || !(saved_omega[0] == omega) ||
+        saved_inverse_twiddles.size() != saved_twiddles.size() ||
+        libff::get_power_of_two(n) != n || n > this->m)
+        throw SerializationException("basic_radix2: saved precomputation does not match the domain");
+
+    twiddles.swap(saved_twiddles);
+    inverse_twiddles.swap(saved_inverse_twiddles);
+}
+
+template<typename FieldT>
+std::shared_ptr<const std::vector<FieldT> > basic_radix2_domain<FieldT>::get_coset_powers(const FieldT &g, const bool inverse)
+{
+    {
+        std::lock_guard<std::mutex> lock(coset_powers_mutex);
+        for (size_t i = 0; i < coset_powers_cache.size(); ++i)
+        {
+            if (coset_powers_cache[i].inverse == inverse && coset_powers_cache[i].g == g)
+            {
+                return coset_powers_cache[i].powers;
+            }
+        }
+    }
+
+    /* Build the table without the lock, so that the transforms of other cosets do not wait for it */
+    coset_powers_entry entry;
+    entry.g = g;
+    entry.inverse = inverse;
+    if (inverse)
+        entry.powers.reset(new std::vector<FieldT>(_basic_radix2_powers_table(this->m, FieldT(this->m).inverse(), g.inverse())));
+    else
+        entry.powers.reset(new std::vector<FieldT>(_basic_radix2_powers_table(this->m, FieldT::one(), g)));
+
+    std::lock_guard<std::mutex> lock(coset_powers_mutex);
+
+    /* A concurrent call may have cached the same table meanwhile; keep the first one */
+    for (size_t i = 0; i < coset_powers_cache.size(); ++i)
+    {
+        if (coset_powers_cache[i].inverse == inverse && coset_powers_cache[i].g == g)
+        {
+            return coset_powers_cache[i].powers;
+        }
+    }
+
+    /* Evict the oldest entry */
+    if (coset_powers_cache.size() == max_cached_cosets)
+    {
+        coset_powers_cache.erase(coset_powers_cache.begin());
+    }
+    coset_powers_cache.push_back(entry);
+
+    return entry.powers;
+}
+
 } // libfqfft
 
 #endif // BASIC_RADIX2_DOMAIN_TCC_
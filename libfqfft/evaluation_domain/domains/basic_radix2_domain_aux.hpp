@@ -25,11 +25,106 @@ namespace libfqfft {
 template<typename FieldT>
 void _basic_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega);
 
+/**
+ * Same as above, but reading the twiddle factors of the first stages from the table
+ * built by _basic_radix2_twiddle_table (stages not covered by the table compute
+ * their twiddle factors on the fly).
+ */
+template<typename FieldT>
+void _basic_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles);
+
+/**
+ * Same as above, on the n elements starting at a.
+ */
+template<typename FieldT>
+void _basic_radix2_FFT(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles);
+
+/**
+ * Same as _basic_radix2_FFT, but leaves the output in bit-reversed order,
+ * i.e. a[bitreverse(i)] holds the evaluation at omega^i. This skips the
+ * bit-reversal permutation when the caller only needs pointwise products.
+ */
+template<typename FieldT>
+void _basic_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega);
+
+template<typename FieldT>
+void _basic_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles);
+
+/**
+ * Same as _basic_radix2_FFT, but expects its input in bit-reversed order
+ * (e.g. as left by _basic_radix2_FFT_bitreversed_output) and
+ * produces the output in natural order.
+ */
+template<typename FieldT>
+void _basic_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega);
+
+template<typename FieldT>
+void _basic_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles);
+
+/**
+ * Select the kernel that the radix-2 FFTs of every domain (basic, extended, step,
+ * streaming and distributed) run on the sub-transforms that fit in cache: radix-2
+ * stages (radix = 2) or radix-4 ones (radix = 4); both give the same results. The
+ * default is LIBFQFFT_FFT_RADIX, or 2 if it is not defined. Any other radix throws an
+ * InvalidSizeException. The setting is process-wide and may change while transforms run.
+ */
+inline void set_fft_leaf_radix(const size_t radix);
+inline size_t fft_leaf_radix();
+
 /**
  * A multi-thread version of _basic_radix2_FFT.
+ *
+ * The work is that of the serial FFT, whatever the number of threads, and the
+ * transform runs in place. (_basic_radix2_FFT and the bit-reversed variants
+ * above resolve to the multi-thread versions, which run on the threads of the
+ * execution policy of the caller, see execution_policy.hpp.)
+ */
+template<typename FieldT>
+void _basic_parallel_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega);
+
+/**
+ * Compute the FFT over omega of (a_i * in_powers[i])_i, and then multiply its i-th
+ * entry by out_powers[i]. An empty in_powers (resp. out_powers) stands for all ones
+ * (resp. out_scale everywhere). The input scaling is applied during the bit-reversal
+ * permutation and the output scaling during the last butterfly stage, so neither
+ * takes a pass of its own.
+ */
+template<typename FieldT>
+void _basic_radix2_FFT_scaled(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                              const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers);
+
+template<typename FieldT>
+void _basic_radix2_FFT_scaled(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                              const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers);
+
+/**
+ * Same as _basic_radix2_FFT_scaled, for each vector in as (all of the same size).
+ *
+ * When there are enough vectors, or they are small enough, each thread
+ * transforms whole vectors; otherwise the vectors go one at a time through
+ * the multi-thread FFT.
  */
 template<typename FieldT>
-void _parallel_basic_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega);
+void _basic_radix2_FFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                             const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers);
+
+/**
+ * Compute the table (c * g^i)_{i < n}.
+ */
+template<typename FieldT>
+std::vector<FieldT> _basic_radix2_powers_table(const size_t n, const FieldT &c, const FieldT &g);
+
+/**
+ * Compute the twiddle factors of the first num_stages stages of a radix-2 FFT
+ * of size n over omega, in per-stage layout: the butterflies of half-size m
+ * use the m entries starting at index m-1, namely (omega^{n/(2m)})^j for j < m.
+ * The table has 2^{num_stages} - 1 entries.
+ *
+ * The stage twiddles only depend on the 2m-th root of unity, so the table of
+ * a size-n FFT over omega also serves every FFT of size n/2^i over omega^{2^i}.
+ */
+template<typename FieldT>
+std::vector<FieldT> _basic_radix2_twiddle_table(const size_t n, const FieldT &omega, const size_t num_stages);
 
 /**
  * Translate the vector a to a coset defined by g.
@@ -37,6 +132,9 @@ void _parallel_basic_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega);
 template<typename FieldT>
 void _multiply_by_coset(std::vector<FieldT> &a, const FieldT &g);
 
+template<typename FieldT>
+void _multiply_by_coset(FieldT *a, const size_t n, const FieldT &g);
+
 /**
  * Compute the m Lagrange coefficients, relative to the set S={omega^{0},...,omega^{m-1}}, at the field element t.
  */
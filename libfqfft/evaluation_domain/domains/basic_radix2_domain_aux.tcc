@@ -15,15 +15,16 @@
 #define BASIC_RADIX2_DOMAIN_AUX_TCC_
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 
-#ifdef MULTICORE
-#include <omp.h>
-#endif
-
 #include <libff/algebra/fields/field_utils.hpp>
 
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.hpp>
+#include <libfqfft/tools/batch_inversion.hpp>
 #include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 #ifdef DEBUG
 #include <libff/common/profiling.hpp>
@@ -31,21 +32,26 @@
 
 namespace libfqfft {
 
-#ifdef MULTICORE
+/* The parallel versions fall back to the serial ones when the execution policy runs on one thread */
 #define _basic_radix2_FFT _basic_parallel_radix2_FFT
-#else
-#define _basic_radix2_FFT _basic_serial_radix2_FFT
-#endif
+#define _basic_radix2_FFT_bitreversed_output _basic_parallel_radix2_FFT_bitreversed_output
+#define _basic_radix2_FFT_bitreversed_input _basic_parallel_radix2_FFT_bitreversed_input
+#define _basic_radix2_FFT_scaled _basic_parallel_radix2_FFT_scaled
 
 /*
- Below we make use of pseudocode from [CLRS 2n Ed, pp. 864].
- Also, note that it's the caller's responsibility to multiply by 1/N.
+ Sub-transforms of up to LIBFQFFT_FFT_BLOCK_BYTES bytes are computed one stage at a
+ time. Larger ones are first split in halves, recursively, so that every sub-transform
+ below the threshold stays in cache while all of its stages run (instead of having
+ each of the log(n) stages sweep the whole vector).
  */
+#ifndef LIBFQFFT_FFT_BLOCK_BYTES
+#define LIBFQFFT_FFT_BLOCK_BYTES ((size_t)1 << 17)
+#endif
+
 template<typename FieldT>
-void _basic_serial_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
+void _basic_radix2_bitreverse_permute(FieldT *a, const size_t n)
 {
-    const size_t n = a.size(), logn = libff::log2(n);
-    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+    const size_t logn = libff::log2(n);
 
     /* swapping in place (from Storer's book) */
     for (size_t k = 0; k < n; ++k)
@@ -54,15 +60,189 @@ void _basic_serial_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
         if (k < rk)
             std::swap(a[k], a[rk]);
     }
+}
 
-    size_t m = 1; // invariant: m = 2^{s-1}
-    for (size_t s = 1; s <= logn; ++s)
+/*
+ Same as above, but also multiplies each a[k] by powers[k] on the way,
+ for the k in [k0, k1) (so that disjoint ranges can go to different threads).
+ */
+template<typename FieldT>
+void _basic_radix2_bitreverse_permute_scaled(FieldT *a, const size_t n, const FieldT *powers, const size_t k0, const size_t k1)
+{
+    const size_t logn = libff::log2(n);
+
+    for (size_t k = k0; k < k1; ++k)
     {
-        // w_m is 2^s-th root of unity now
-        const FieldT w_m = omega^(n/(2*m));
+        const size_t rk = libff::bitreverse(k, logn);
+        if (k < rk)
+        {
+            const FieldT t = a[k] * powers[k];
+            a[k] = a[rk] * powers[rk];
+            a[rk] = t;
+        }
+        else if (k == rk)
+        {
+            a[k] *= powers[k];
+        }
+    }
+}
+
+/*
+ Fully unrolled transforms of a compile-time size N, for the first log(N) DIT stages (resp.
+ the last log(N) DIF stages) of the FFTs, which work on blocks of N consecutive elements.
+ w holds the per-stage twiddle factors of these stages (see _basic_radix2_twiddle_table).
+ The first butterfly of each stage, whose twiddle factor is 1, does not multiply.
+ */
+template<typename FieldT, size_t N>
+struct _basic_radix2_codelet {
+    static void DIT(FieldT *a, const FieldT *w)
+    {
+        const size_t m = N/2;
+        _basic_radix2_codelet<FieldT, m>::DIT(a, w);
+        _basic_radix2_codelet<FieldT, m>::DIT(a + m, w);
+
+        const FieldT t0 = a[m];
+        a[m] = a[0] - t0;
+        a[0] += t0;
+        for (size_t j = 1; j < m; ++j)
+        {
+            const FieldT t = w[m-1+j] * a[j+m];
+            a[j+m] = a[j] - t;
+            a[j] += t;
+        }
+    }
+
+    static void DIF(FieldT *a, const FieldT *w)
+    {
+        const size_t m = N/2;
+        const FieldT t0 = a[0] - a[m];
+        a[0] += a[m];
+        a[m] = t0;
+        for (size_t j = 1; j < m; ++j)
+        {
+            const FieldT t = a[j] - a[j+m];
+            a[j] += a[j+m];
+            a[j+m] = w[m-1+j] * t;
+        }
+
+        _basic_radix2_codelet<FieldT, m>::DIF(a, w);
+        _basic_radix2_codelet<FieldT, m>::DIF(a + m, w);
+    }
+};
+
+template<typename FieldT>
+struct _basic_radix2_codelet<FieldT, 1> {
+    static void DIT(FieldT *, const FieldT *) {}
+    static void DIF(FieldT *, const FieldT *) {}
+};
+
+/*
+ The codelet size: transforms of up to this size, and the blocks of this size at the
+ leaves of larger ones, go through the codelets above (1 turns them off).
+ */
+#ifndef LIBFQFFT_FFT_CODELET_SIZE
+#define LIBFQFFT_FFT_CODELET_SIZE ((size_t)32)
+#endif
+
+/*
+ The twiddle factors of the stages of half-size m < N of a size-n FFT over omega: from
+ the table if it covers them (N - 1 entries), or else computed into local.
+ */
+template<typename FieldT>
+const FieldT *_basic_radix2_codelet_twiddles(FieldT *local, const size_t N, const size_t n, const FieldT &omega,
+                                             const std::vector<FieldT> &twiddles)
+{
+    if (N - 1 <= twiddles.size()) return twiddles.data();
+
+    /* Stage m uses (omega^{n/(2m)})^j = w_N^{j * N/(2m)}, for j < m, where w_N = omega^{n/N} */
+    const size_t h = N/2;
+    FieldT *last = local + h - 1;
+    last[0] = FieldT::one();
+    if (h > 1) last[1] = omega^(n/N);
+    for (size_t j = 2; j < h; ++j)
+    {
+        last[j] = last[j-1] * last[1];
+    }
+    for (size_t m = h/2; m >= 1; m /= 2)
+    {
+        for (size_t j = 0; j < m; ++j)
+        {
+            local[m-1+j] = last[j * (h/m)];
+        }
+    }
+    return local;
+}
+
+/* Run codelet N on each block of N elements of a[0..n) */
+template<typename FieldT, size_t N>
+void _basic_radix2_codelet_blocks(FieldT *a, const size_t n, const FieldT *w, const bool dit)
+{
+    for (size_t k = 0; k < n; k += N)
+    {
+        if (dit)
+            _basic_radix2_codelet<FieldT, N>::DIT(a + k, w);
+        else
+            _basic_radix2_codelet<FieldT, N>::DIF(a + k, w);
+    }
+}
+
+/*
+ Run the stages of half-size m < N, for N = min(n, LIBFQFFT_FFT_CODELET_SIZE), through
+ the codelets, and return N (the half-size of the next DIT stage, or twice that of the
+ last DIF stage left).
+ */
+template<typename FieldT>
+size_t _basic_radix2_codelet_stages(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles, const bool dit)
+{
+    static_assert(LIBFQFFT_FFT_CODELET_SIZE >= 1 && LIBFQFFT_FFT_CODELET_SIZE <= 32 &&
+                  (LIBFQFFT_FFT_CODELET_SIZE & (LIBFQFFT_FFT_CODELET_SIZE - 1)) == 0,
+                  "LIBFQFFT_FFT_CODELET_SIZE must be a power of 2, at most 32");
+
+    const size_t N = std::min(n, LIBFQFFT_FFT_CODELET_SIZE);
+    if (N < 2) return 1;
+
+    FieldT local[LIBFQFFT_FFT_CODELET_SIZE];
+    const FieldT *w = _basic_radix2_codelet_twiddles(local, N, n, omega, twiddles);
+
+    switch (N)
+    {
+    case 2: _basic_radix2_codelet_blocks<FieldT, 2>(a, n, w, dit); break;
+    case 4: _basic_radix2_codelet_blocks<FieldT, 4>(a, n, w, dit); break;
+    case 8: _basic_radix2_codelet_blocks<FieldT, 8>(a, n, w, dit); break;
+    case 16: _basic_radix2_codelet_blocks<FieldT, 16>(a, n, w, dit); break;
+    default: _basic_radix2_codelet_blocks<FieldT, 32>(a, n, w, dit); break;
+    }
+
+    return N;
+}
+
+/*
+ One DIT stage of half-size m on a[0..n), where omega is an n-th root of unity.
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_stage(FieldT *a, const size_t n, const size_t m, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
 #ifndef _MSC_VER
-        asm volatile  ("/* pre-inner */");
+    asm volatile  ("/* pre-inner */");
 #endif
+    if (2*m - 1 <= twiddles.size())
+    {
+        // w[j] = w_m^j, read from the per-stage twiddle table
+        const FieldT *w = &twiddles[m-1];
+        for (size_t k = 0; k < n; k += 2*m)
+        {
+            for (size_t j = 0; j < m; ++j)
+            {
+                const FieldT t = w[j] * a[k+j+m];
+                a[k+j+m] = a[k+j] - t;
+                a[k+j] += t;
+            }
+        }
+    }
+    else
+    {
+        // w_m is 2^s-th root of unity now
+        const FieldT w_m = omega^(n/(2*m));
         for (size_t k = 0; k < n; k += 2*m)
         {
             FieldT w = FieldT::one();
@@ -74,114 +254,821 @@ void _basic_serial_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
                 w *= w_m;
             }
         }
+    }
 #ifndef _MSC_VER
-        asm volatile ("/* post-inner */");
+    asm volatile ("/* post-inner */");
 #endif
-        m *= 2;
-    }
 }
 
+/*
+ The two DIT stages of half-sizes m and 2m on a[0..n) in one pass: each radix-4 butterfly
+ takes a[k+j], a[k+j+m], a[k+j+2m], a[k+j+3m] through both stages, with the twiddle factors
+ w_{2m}^j (twice), then w_{4m}^j and w_{4m}^{j+m}.
+ */
 template<typename FieldT>
-void _basic_parallel_radix2_FFT_inner(std::vector<FieldT> &a, const FieldT &omega, const size_t log_cpus)
+void _basic_radix4_DIT_stage(FieldT *a, const size_t n, const size_t m, const FieldT &omega, const std::vector<FieldT> &twiddles)
 {
-    const size_t num_cpus = ((size_t)1) <<log_cpus;
+    const bool use_table = (4*m - 1 <= twiddles.size());
+    const FieldT w_2m = (use_table ? FieldT::one() : omega^(n/(2*m)));
+    const FieldT w_4m = (use_table ? FieldT::one() : omega^(n/(4*m)));
+    const FieldT w_4 = (use_table ? FieldT::one() : w_4m^m);
 
-    const size_t m = a.size();
-    const size_t log_m = libff::log2(m);
-    if (m != ((size_t)1) <<log_m) throw DomainSizeException("expected m == ((size_t)1)<<log_m");
+    for (size_t k = 0; k < n; k += 4*m)
+    {
+        FieldT *x = a + k;
+        FieldT w2 = FieldT::one(), w4 = FieldT::one();
+        for (size_t j = 0; j < m; ++j)
+        {
+            if (use_table)
+            {
+                w2 = twiddles[m-1+j];
+                w4 = twiddles[2*m-1+j];
+            }
+            const FieldT t1 = w2 * x[j+m];
+            const FieldT t3 = w2 * x[j+3*m];
+            const FieldT b0 = x[j] + t1;
+            const FieldT b1 = x[j] - t1;
+            const FieldT b2 = x[j+2*m] + t3;
+            const FieldT b3 = x[j+2*m] - t3;
+            const FieldT u = w4 * b2;
+            const FieldT v = (use_table ? twiddles[3*m-1+j] : w4 * w_4) * b3;
+            x[j] = b0 + u;
+            x[j+2*m] = b0 - u;
+            x[j+m] = b1 + v;
+            x[j+3*m] = b1 - v;
+            if (!use_table)
+            {
+                w2 *= w_2m;
+                w4 *= w_4m;
+            }
+        }
+    }
+}
 
-    if (log_m < log_cpus)
+/*
+ Below we make use of pseudocode from [CLRS 2n Ed, pp. 864].
+ The input a[0..n) is expected in bit-reversed order; omega is an n-th root of unity.
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_iterative(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    for (size_t m = _basic_radix2_codelet_stages(a, n, omega, twiddles, true); m < n; m *= 2)
     {
-        _basic_serial_radix2_FFT(a, omega);
-        return;
+        _basic_radix2_DIT_stage(a, n, m, omega, twiddles);
     }
+}
 
-    std::vector<std::vector<FieldT> > tmp(num_cpus);
-    for (size_t j = 0; j < num_cpus; ++j)
+/*
+ Same as above, with the stages past the codelets taken two at a time by radix-4
+ butterflies (and the last one on its own, if their number is odd), so that the
+ transform makes half as many passes over a.
+ */
+template<typename FieldT>
+void _basic_radix4_DIT_iterative(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    size_t m = _basic_radix2_codelet_stages(a, n, omega, twiddles, true);
+    for (; 4*m <= n; m *= 4)
     {
-        tmp[j].resize(((size_t)1) <<(log_m-log_cpus), FieldT::zero());
+        _basic_radix4_DIT_stage(a, n, m, omega, twiddles);
     }
+    if (m < n)
+    {
+        _basic_radix2_DIT_stage(a, n, m, omega, twiddles);
+    }
+}
 
-#ifdef MULTICORE
-    #pragma omp parallel for
+/* The radix of the leaf kernel until set_fft_leaf_radix is called */
+#ifndef LIBFQFFT_FFT_RADIX
+#define LIBFQFFT_FFT_RADIX 2
 #endif
-    for (size_t j = 0; j < num_cpus; ++j)
+
+inline std::atomic<size_t>& _fft_leaf_radix()
+{
+    static std::atomic<size_t> radix(LIBFQFFT_FFT_RADIX == 4 ? 4 : 2);
+    return radix;
+}
+
+inline void set_fft_leaf_radix(const size_t radix)
+{
+    if (radix != 2 && radix != 4)
     {
-        const FieldT omega_j = omega^j;
-        const FieldT omega_step = omega^(j<<(log_m - log_cpus));
+        throw InvalidSizeException("set_fft_leaf_radix: expected a radix of 2 or 4");
+    }
+    _fft_leaf_radix().store(radix, std::memory_order_relaxed);
+}
 
-        FieldT elt = FieldT::one();
-        for (size_t i = 0; i < ((size_t)1) <<(log_m - log_cpus); ++i)
+inline size_t fft_leaf_radix()
+{
+    return _fft_leaf_radix().load(std::memory_order_relaxed);
+}
+
+/*
+ The kernel that the FFTs run on their leaves (the sub-transforms that fit in
+ LIBFQFFT_FFT_BLOCK_BYTES): radix-2 stages, or radix-4 ones (see set_fft_leaf_radix).
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_leaf(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    if (fft_leaf_radix() == 4)
+    {
+        _basic_radix4_DIT_iterative(a, n, omega, twiddles);
+    }
+    else
+    {
+        _basic_radix2_DIT_iterative(a, n, omega, twiddles);
+    }
+}
+
+/*
+ The Gentleman-Sande counterpart of the above: a[0..n) is given in natural order
+ and the output is left in bit-reversed order.
+ */
+template<typename FieldT>
+void _basic_radix2_DIF_iterative(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t N = std::min(n, LIBFQFFT_FFT_CODELET_SIZE);
+    for (size_t m = n/2; m >= N; m /= 2)
+    {
+        if (2*m - 1 <= twiddles.size())
+        {
+            const FieldT *w = &twiddles[m-1];
+            for (size_t k = 0; k < n; k += 2*m)
+            {
+                for (size_t j = 0; j < m; ++j)
+                {
+                    const FieldT t = a[k+j] - a[k+j+m];
+                    a[k+j] += a[k+j+m];
+                    a[k+j+m] = w[j] * t;
+                }
+            }
+        }
+        else
         {
-            for (size_t s = 0; s < num_cpus; ++s)
+            const FieldT w_m = omega^(n/(2*m));
+            for (size_t k = 0; k < n; k += 2*m)
             {
-                // invariant: elt is omega^(j*idx)
-                const size_t idx = (i + (s<<(log_m - log_cpus))) % (((size_t)1) << log_m);
-                tmp[j][i] += a[idx] * elt;
-                elt *= omega_step;
+                FieldT w = FieldT::one();
+                for (size_t j = 0; j < m; ++j)
+                {
+                    const FieldT t = a[k+j] - a[k+j+m];
+                    a[k+j] += a[k+j+m];
+                    a[k+j+m] = w * t;
+                    w *= w_m;
+                }
             }
-            elt *= omega_j;
         }
     }
 
-    const FieldT omega_num_cpus = omega^num_cpus;
+    _basic_radix2_codelet_stages(a, n, omega, twiddles, false);
+}
 
-#ifdef MULTICORE
-    #pragma omp parallel for
-#endif
-    for (size_t j = 0; j < num_cpus; ++j)
+/*
+ A single butterfly stage on a[0..2m), where w_m is a 2m-th root of unity.
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_butterflies(FieldT *a, const size_t m, const FieldT &w_m, const std::vector<FieldT> &twiddles)
+{
+    if (2*m - 1 <= twiddles.size())
     {
-        _basic_serial_radix2_FFT(tmp[j], omega_num_cpus);
+        const FieldT *w = &twiddles[m-1];
+        for (size_t j = 0; j < m; ++j)
+        {
+            const FieldT t = w[j] * a[j+m];
+            a[j+m] = a[j] - t;
+            a[j] += t;
+        }
+    }
+    else
+    {
+        FieldT w = FieldT::one();
+        for (size_t j = 0; j < m; ++j)
+        {
+            const FieldT t = w * a[j+m];
+            a[j+m] = a[j] - t;
+            a[j] += t;
+            w *= w_m;
+        }
     }
+}
 
-#ifdef MULTICORE
-    #pragma omp parallel for
-#endif
-    for (size_t i = 0; i < num_cpus; ++i)
+template<typename FieldT>
+void _basic_radix2_DIF_butterflies(FieldT *a, const size_t m, const FieldT &w_m, const std::vector<FieldT> &twiddles)
+{
+    if (2*m - 1 <= twiddles.size())
+    {
+        const FieldT *w = &twiddles[m-1];
+        for (size_t j = 0; j < m; ++j)
+        {
+            const FieldT t = a[j] - a[j+m];
+            a[j] += a[j+m];
+            a[j+m] = w[j] * t;
+        }
+    }
+    else
     {
-        for (size_t j = 0; j < ((size_t)1) <<(log_m - log_cpus); ++j)
+        FieldT w = FieldT::one();
+        for (size_t j = 0; j < m; ++j)
         {
-            // now: i = idx >> (log_m - log_cpus) and j = idx % (1u << (log_m - log_cpus)), for idx = ((i<<(log_m-log_cpus))+j) % (1u << log_m)
-            a[(j<<log_cpus) + i] = tmp[i][j];
+            const FieldT t = a[j] - a[j+m];
+            a[j] += a[j+m];
+            a[j+m] = w * t;
+            w *= w_m;
         }
     }
 }
 
 template<typename FieldT>
-void _basic_parallel_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
+void _basic_radix2_DIT_recursive(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
 {
-#ifdef MULTICORE
-    const size_t num_cpus = omp_get_max_threads();
+    if (n <= 2 || n * sizeof(FieldT) <= LIBFQFFT_FFT_BLOCK_BYTES)
+    {
+        _basic_radix2_DIT_leaf(a, n, omega, twiddles);
+        return;
+    }
+
+    const size_t m = n/2;
+    const FieldT omega_squared = omega.squared();
+    _basic_radix2_DIT_recursive(a, m, omega_squared, twiddles);
+    _basic_radix2_DIT_recursive(a + m, m, omega_squared, twiddles);
+    _basic_radix2_DIT_butterflies(a, m, omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_radix2_DIF_recursive(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    if (n <= 2 || n * sizeof(FieldT) <= LIBFQFFT_FFT_BLOCK_BYTES)
+    {
+        _basic_radix2_DIF_iterative(a, n, omega, twiddles);
+        return;
+    }
+
+    const size_t m = n/2;
+    const FieldT omega_squared = omega.squared();
+    _basic_radix2_DIF_butterflies(a, m, omega, twiddles);
+    _basic_radix2_DIF_recursive(a, m, omega_squared, twiddles);
+    _basic_radix2_DIF_recursive(a + m, m, omega_squared, twiddles);
+}
+
+/*
+ The last DIT stage of a size-n FFT (half-size n/2) over the butterflies j in [j0, j1),
+ multiplying output i by out_powers[i], or by out_scale when out_powers is null.
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_last_stage_scaled(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                                         const FieldT &out_scale, const FieldT *out_powers, const size_t j0, const size_t j1)
+{
+    const size_t m = n/2;
+    const bool use_table = (2*m - 1 <= twiddles.size());
+
+    FieldT w = (use_table ? FieldT::one() : omega^j0);
+    for (size_t j = j0; j < j1; ++j)
+    {
+        const FieldT t = (use_table ? twiddles[m-1+j] : w) * a[j+m];
+        const FieldT x = a[j];
+        if (out_powers)
+        {
+            a[j] = (x + t) * out_powers[j];
+            a[j+m] = (x - t) * out_powers[j+m];
+        }
+        else
+        {
+            a[j] = (x + t) * out_scale;
+            a[j+m] = (x - t) * out_scale;
+        }
+        if (!use_table) w *= omega;
+    }
+}
+
+/*
+ Count the n/2 * log(n) butterflies of a transform of size n, and the num_scalings
+ passes of n multiplications around it, for the instrumentation (see instrumentation.hpp).
+ */
+inline void _basic_radix2_count_FFT(const size_t n, const size_t num_scalings)
+{
+#ifdef LIBFQFFT_INSTRUMENTATION
+    const uint64_t logn = libff::log2(n);
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(n * logn, (n/2) * logn + num_scalings * n, 0);
 #else
-    const size_t num_cpus = 1;
+    (void)n; (void)num_scalings;
 #endif
-    const size_t log_cpus = ((num_cpus & (num_cpus - 1)) == 0 ? libff::log2(num_cpus) : libff::log2(num_cpus) - 1);
+}
+
+/*
+ Note that it's the caller's responsibility to multiply by 1/N.
+ */
+template<typename FieldT>
+void _basic_serial_radix2_FFT(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_radix2_bitreverse_permute(a, n);
+    _basic_radix2_DIT_recursive(a, n, omega, twiddles);
+}
+
+/*
+ The radix-4 FFT, over the whole of a at once (without the cache blocking of the above).
+ */
+template<typename FieldT>
+void _basic_serial_radix4_FFT(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_radix2_bitreverse_permute(a, n);
+    _basic_radix4_DIT_iterative(a, n, omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    _basic_serial_radix2_FFT(a.data(), a.size(), omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_serial_radix2_FFT(a, omega, std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_scaled(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                                     const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+    if (!in_powers.empty() && in_powers.size() != n) throw InvalidSizeException("expected in_powers.size() == n");
+    if (!out_powers.empty() && out_powers.size() != n) throw InvalidSizeException("expected out_powers.size() == n");
+
+    _basic_radix2_count_FFT(n, (in_powers.empty() ? 0 : 1) + (out_powers.empty() && out_scale == FieldT::one() ? 0 : 1));
+    if (in_powers.empty())
+        _basic_radix2_bitreverse_permute(a, n);
+    else
+        _basic_radix2_bitreverse_permute_scaled(a, n, in_powers.data(), 0, n);
+
+    if (out_powers.empty() && out_scale == FieldT::one())
+    {
+        _basic_radix2_DIT_recursive(a, n, omega, twiddles);
+    }
+    else if (n == 1)
+    {
+        a[0] *= (out_powers.empty() ? out_scale : out_powers[0]);
+    }
+    else
+    {
+        /* All stages but the last, which then applies the output scaling */
+        const size_t m = n/2;
+        const FieldT omega_squared = omega.squared();
+        _basic_radix2_DIT_recursive(a, m, omega_squared, twiddles);
+        _basic_radix2_DIT_recursive(a + m, m, omega_squared, twiddles);
+        _basic_radix2_DIT_last_stage_scaled(a, n, omega, twiddles, out_scale,
+                                            (out_powers.empty() ? (const FieldT*)nullptr : out_powers.data()), 0, m);
+    }
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_scaled(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                                     const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers)
+{
+    _basic_serial_radix2_FFT_scaled(a.data(), a.size(), omega, twiddles, in_powers, out_scale, out_powers);
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t n = a.size(), logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_radix2_DIF_recursive(a.data(), n, omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_serial_radix2_FFT_bitreversed_output(a, omega, std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t n = a.size(), logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_radix2_DIT_recursive(a.data(), n, omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_serial_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_serial_radix2_FFT_bitreversed_input(a, omega, std::vector<FieldT>());
+}
+
+/*
+ Viewing a[0..n) as a row-major (n/L) x L matrix, the DIT stages of half-size m >= L
+ only pair up elements within the same column. Below we run all of these stages on
+ the columns c0 <= c < c1, so that disjoint column ranges can go to different threads.
+ */
+template<typename FieldT>
+void _basic_radix2_DIT_column_stages(FieldT *a, const size_t n, const size_t L, const FieldT &omega,
+                                     const std::vector<FieldT> &twiddles, const size_t c0, const size_t c1)
+{
+    for (size_t m = L; m < n; m *= 2)
+    {
+        const bool use_table = (2*m - 1 <= twiddles.size());
+        const FieldT w_m = (use_table ? FieldT::one() : omega^(n/(2*m)));
+        for (size_t k = 0; k < n; k += 2*m)
+        {
+            for (size_t r = 0; r < m; r += L)
+            {
+                FieldT *x = a + k + r;
+                if (use_table)
+                {
+                    const FieldT *w = &twiddles[m-1+r];
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        const FieldT t = w[c] * x[c+m];
+                        x[c+m] = x[c] - t;
+                        x[c] += t;
+                    }
+                }
+                else
+                {
+                    FieldT w = w_m^(r + c0);
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        const FieldT t = w * x[c+m];
+                        x[c+m] = x[c] - t;
+                        x[c] += t;
+                        w *= w_m;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ Same as above, for the DIF stages of half-size m >= L (which come first in a DIF FFT).
+ */
+template<typename FieldT>
+void _basic_radix2_DIF_column_stages(FieldT *a, const size_t n, const size_t L, const FieldT &omega,
+                                     const std::vector<FieldT> &twiddles, const size_t c0, const size_t c1)
+{
+    for (size_t m = n/2; m >= L; m /= 2)
+    {
+        const bool use_table = (2*m - 1 <= twiddles.size());
+        const FieldT w_m = (use_table ? FieldT::one() : omega^(n/(2*m)));
+        for (size_t k = 0; k < n; k += 2*m)
+        {
+            for (size_t r = 0; r < m; r += L)
+            {
+                FieldT *x = a + k + r;
+                if (use_table)
+                {
+                    const FieldT *w = &twiddles[m-1+r];
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        const FieldT t = x[c] - x[c+m];
+                        x[c] += x[c+m];
+                        x[c+m] = w[c] * t;
+                    }
+                }
+                else
+                {
+                    FieldT w = w_m^(r + c0);
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        const FieldT t = x[c] - x[c+m];
+                        x[c] += x[c+m];
+                        x[c+m] = w * t;
+                        w *= w_m;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ The parallel kernels split a[0..n) into num_tiles contiguous tiles of size L = n/num_tiles.
+ The log(L) stages that stay within a tile run as independent (cache-blocked) serial
+ sub-FFTs over omega^num_tiles, one tile at a time per thread; the remaining log(num_tiles)
+ stages are split across threads by column ranges (see above). The work is that of the
+ serial FFT for any number of threads, and everything happens in place.
+
+ There are a few tiles per thread so that the dynamic schedule keeps every thread busy
+ even when the thread count is not a power of two.
+ */
+template<typename FieldT>
+size_t _basic_parallel_radix2_num_tiles(const size_t n, const size_t num_threads)
+{
+    return std::min(libff::get_power_of_two(num_threads) * 4, n);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_bitreverse_permute(FieldT *a, const size_t n)
+{
+    const size_t logn = libff::log2(n);
+
+    parallel_for(n, [a, logn](const size_t k) {
+            const size_t rk = libff::bitreverse(k, logn);
+            if (k < rk)
+                std::swap(a[k], a[rk]);
+        });
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_DIT(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles, const size_t num_threads)
+{
+    const size_t num_tiles = _basic_parallel_radix2_num_tiles<FieldT>(n, num_threads);
+    const size_t L = n / num_tiles;
+    const FieldT omega_L = omega^num_tiles;
+
+    parallel_for(num_tiles, [&](const size_t t) {
+            _basic_radix2_DIT_recursive(a + t*L, L, omega_L, twiddles);
+        });
+
+    const size_t num_chunks = std::min(num_threads, L);
+    parallel_for(num_chunks, [&](const size_t i) {
+            _basic_radix2_DIT_column_stages(a, n, L, omega, twiddles, i*L/num_chunks, (i+1)*L/num_chunks);
+        });
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_DIF(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles, const size_t num_threads)
+{
+    const size_t num_tiles = _basic_parallel_radix2_num_tiles<FieldT>(n, num_threads);
+    const size_t L = n / num_tiles;
+    const FieldT omega_L = omega^num_tiles;
+
+    const size_t num_chunks = std::min(num_threads, L);
+    parallel_for(num_chunks, [&](const size_t i) {
+            _basic_radix2_DIF_column_stages(a, n, L, omega, twiddles, i*L/num_chunks, (i+1)*L/num_chunks);
+        });
+
+    parallel_for(num_tiles, [&](const size_t t) {
+            _basic_radix2_DIF_recursive(a + t*L, L, omega_L, twiddles);
+        });
+}
+
+template<typename FieldT>
+size_t _basic_parallel_radix2_num_threads()
+{
+    const size_t num_threads = execution_concurrency();
 
 #ifdef DEBUG
-    libff::print_indent(); printf("* Invoking parallel FFT on 2^%zu CPUs (omp_get_max_threads = %zu)\n", log_cpus, num_cpus);
+    libff::print_indent(); printf("* Invoking parallel FFT on %zu threads\n", num_threads);
 #endif
 
-    if (log_cpus == 0)
+    return num_threads;
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    const size_t num_threads = _basic_parallel_radix2_num_threads<FieldT>();
+    if (num_threads == 1)
+    {
+        _basic_serial_radix2_FFT(a, n, omega, twiddles);
+        return;
+    }
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_parallel_radix2_bitreverse_permute(a, n);
+    _basic_parallel_radix2_DIT(a, n, omega, twiddles, num_threads);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    _basic_parallel_radix2_FFT(a.data(), a.size(), omega, twiddles);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_parallel_radix2_FFT(a, omega, std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT_scaled(FieldT *a, const size_t n, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                                       const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    const size_t num_threads = _basic_parallel_radix2_num_threads<FieldT>();
+    if (num_threads == 1 || n == 1)
     {
-        _basic_serial_radix2_FFT(a, omega);
+        _basic_serial_radix2_FFT_scaled(a, n, omega, twiddles, in_powers, out_scale, out_powers);
+        return;
+    }
+
+    if (!in_powers.empty() && in_powers.size() != n) throw InvalidSizeException("expected in_powers.size() == n");
+    if (!out_powers.empty() && out_powers.size() != n) throw InvalidSizeException("expected out_powers.size() == n");
+
+    _basic_radix2_count_FFT(n, (in_powers.empty() ? 0 : 1) + (out_powers.empty() && out_scale == FieldT::one() ? 0 : 1));
+    if (in_powers.empty())
+    {
+        _basic_parallel_radix2_bitreverse_permute(a, n);
     }
     else
     {
-        _basic_parallel_radix2_FFT_inner(a, omega, log_cpus);
+        const size_t num_chunks = std::min(num_threads, n);
+        parallel_for(num_chunks, [&](const size_t i) {
+                _basic_radix2_bitreverse_permute_scaled(a, n, in_powers.data(), i*n/num_chunks, (i+1)*n/num_chunks);
+            });
     }
+
+    if (out_powers.empty() && out_scale == FieldT::one())
+    {
+        _basic_parallel_radix2_DIT(a, n, omega, twiddles, num_threads);
+        return;
+    }
+
+    /* All stages but the last, which then applies the output scaling */
+    const size_t m = n/2;
+    const FieldT omega_squared = omega.squared();
+    _basic_parallel_radix2_DIT(a, m, omega_squared, twiddles, num_threads);
+    _basic_parallel_radix2_DIT(a + m, m, omega_squared, twiddles, num_threads);
+
+    const FieldT *out = (out_powers.empty() ? (const FieldT*)nullptr : out_powers.data());
+    const size_t num_chunks = std::min(num_threads, m);
+    parallel_for(num_chunks, [&](const size_t i) {
+            _basic_radix2_DIT_last_stage_scaled(a, n, omega, twiddles, out_scale, out, i*m/num_chunks, (i+1)*m/num_chunks);
+        });
 }
 
 template<typename FieldT>
-void _multiply_by_coset(std::vector<FieldT> &a, const FieldT &g)
+void _basic_parallel_radix2_FFT_scaled(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                                       const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers)
+{
+    _basic_parallel_radix2_FFT_scaled(a.data(), a.size(), omega, twiddles, in_powers, out_scale, out_powers);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t n = a.size(), logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    const size_t num_threads = _basic_parallel_radix2_num_threads<FieldT>();
+    if (num_threads == 1)
+    {
+        _basic_serial_radix2_FFT_bitreversed_output(a, omega, twiddles);
+        return;
+    }
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_parallel_radix2_DIF(a.data(), n, omega, twiddles, num_threads);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT_bitreversed_output(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_parallel_radix2_FFT_bitreversed_output(a, omega, std::vector<FieldT>());
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega, const std::vector<FieldT> &twiddles)
+{
+    const size_t n = a.size(), logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+
+    const size_t num_threads = _basic_parallel_radix2_num_threads<FieldT>();
+    if (num_threads == 1)
+    {
+        _basic_serial_radix2_FFT_bitreversed_input(a, omega, twiddles);
+        return;
+    }
+
+    _basic_radix2_count_FFT(n, 0);
+    _basic_parallel_radix2_DIT(a.data(), n, omega, twiddles, num_threads);
+}
+
+template<typename FieldT>
+void _basic_parallel_radix2_FFT_bitreversed_input(std::vector<FieldT> &a, const FieldT &omega)
+{
+    _basic_parallel_radix2_FFT_bitreversed_input(a, omega, std::vector<FieldT>());
+}
+
+template<typename FieldT>
+std::vector<FieldT> _basic_radix2_powers_table(const size_t n, const FieldT &c, const FieldT &g)
+{
+    std::vector<FieldT> powers(n);
+    LIBFQFFT_COUNT_ALLOCATION(n * sizeof(FieldT));
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(0, n, 0);
+
+    const size_t num_chunks = std::min(execution_concurrency(), std::max(n, (size_t)1));
+    parallel_for(num_chunks, [&](const size_t i) {
+            const size_t start = i*n/num_chunks, end = (i+1)*n/num_chunks;
+            FieldT u = c * (g^start);
+            for (size_t j = start; j < end; ++j)
+            {
+                powers[j] = u;
+                u *= g;
+            }
+        });
+
+    return powers;
+}
+
+template<typename FieldT>
+void _basic_radix2_FFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &omega, const std::vector<FieldT> &twiddles,
+                             const std::vector<FieldT> &in_powers, const FieldT &out_scale, const std::vector<FieldT> &out_powers)
 {
+    if (as.empty()) return;
+
+    const size_t n = as[0]->size();
+
+    const size_t num_threads = execution_concurrency();
+
+    /* Transforms that fit in a cache block gain little from being split, so have each thread take whole vectors instead */
+    const bool by_vector = (as.size() > 1 && num_threads > 1 &&
+                            (as.size() >= num_threads || n * sizeof(FieldT) <= LIBFQFFT_FFT_BLOCK_BYTES));
+
+    if (by_vector)
+    {
+        /* Counted here, so that the work of the other threads goes to the calling one */
+        for (size_t i = 0; i < as.size(); ++i)
+        {
+            _basic_radix2_count_FFT(n, (in_powers.empty() ? 0 : 1) + (out_powers.empty() && out_scale == FieldT::one() ? 0 : 1));
+        }
+
+        parallel_for(as.size(), [&](const size_t i) {
+                LIBFQFFT_INSTRUMENT_PAUSE();
+                _basic_serial_radix2_FFT_scaled(*as[i], omega, twiddles, in_powers, out_scale, out_powers);
+            });
+    }
+    else
+    {
+        for (size_t i = 0; i < as.size(); ++i)
+        {
+            _basic_radix2_FFT_scaled(*as[i], omega, twiddles, in_powers, out_scale, out_powers);
+        }
+    }
+}
+
+template<typename FieldT>
+std::vector<FieldT> _basic_radix2_twiddle_table(const size_t n, const FieldT &omega, const size_t num_stages)
+{
+    const size_t logn = libff::log2(n);
+    if (n != ((size_t)1 << logn)) throw DomainSizeException("expected n == ((size_t)1 << logn)");
+    if (num_stages > logn) throw InvalidSizeException("expected num_stages <= logn");
+
+    std::vector<FieldT> twiddles;
+    if (num_stages == 0) return twiddles;
+
+    twiddles.resize(((size_t)1 << num_stages) - 1);
+    LIBFQFFT_COUNT_ALLOCATION(twiddles.size() * sizeof(FieldT));
+
+    /* Fill in the last stage with successive powers of its root of unity ... */
+    const size_t top_m = (size_t)1 << (num_stages - 1);
+    const FieldT w_m = omega^(n/(2*top_m));
+    FieldT w = FieldT::one();
+    for (size_t j = 0; j < top_m; ++j)
+    {
+        twiddles[top_m-1+j] = w;
+        w *= w_m;
+    }
+
+    /* ... and every earlier stage with every other entry of the stage after it. */
+    for (size_t m = top_m / 2; m >= 1; m /= 2)
+    {
+        for (size_t j = 0; j < m; ++j)
+        {
+            twiddles[m-1+j] = twiddles[2*m-1+2*j];
+        }
+    }
+
+    return twiddles;
+}
+
+template<typename FieldT>
+void _multiply_by_coset(FieldT *a, const size_t n, const FieldT &g)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(0, 2 * n, 0);
     FieldT u = g;
-    for (size_t i = 1; i < a.size(); ++i)
+    for (size_t i = 1; i < n; ++i)
     {
         a[i] *= u;
         u *= g;
     }
 }
 
+template<typename FieldT>
+void _multiply_by_coset(std::vector<FieldT> &a, const FieldT &g)
+{
+    _multiply_by_coset(a.data(), a.size(), g);
+}
+
 template<typename FieldT>
 std::vector<FieldT> _basic_radix2_evaluate_all_lagrange_polynomials(const size_t m, const FieldT &t)
 {
@@ -194,46 +1081,17 @@ std::vector<FieldT> _basic_radix2_evaluate_all_lagrange_polynomials(const size_t
 
     const FieldT omega = libff::get_root_of_unity<FieldT>(m);
 
-    std::vector<FieldT> u(m, FieldT::zero());
+    std::vector<FieldT> u(m);
+    LIBFQFFT_COUNT_ALLOCATION(m * sizeof(FieldT));
 
     /*
-     If t equals one of the roots of unity in S={omega^{0},...,omega^{m-1}}
-     then output 1 at the right place, and 0 elsewhere
-     */
-
-    if ((t^m) == (FieldT::one()))
-    {
-        FieldT omega_i = FieldT::one();
-        for (size_t i = 0; i < m; ++i)
-        {
-            if (omega_i == t) // i.e., t equals omega^i
-            {
-                u[i] = FieldT::one();
-                return u;
-            }
-
-            omega_i *= omega;
-        }
-    }
-
-    /*
-     Otherwise, if t does not equal any of the roots of unity in S,
-     then compute each L_{i,S}(t) as Z_{S}(t) * v_i / (t-\omega^i)
-     where:
+     Each L_{i,S}(t) is Z_{S}(t) * v_i / (t-\omega^i) (or 1 at the right place, and 0 elsewhere,
+     if t equals one of the roots of unity in S), where:
      - Z_{S}(t) = \prod_{j} (t-\omega^j) = (t^m-1), and
-     - v_{i} = 1 / \prod_{j \neq i} (\omega^i-\omega^j).
-     Below we use the fact that v_{0} = 1/m and v_{i+1} = \omega * v_{i}.
+     - v_{i} = 1 / \prod_{j \neq i} (\omega^i-\omega^j) = \omega^i / m.
      */
-
-    const FieldT Z = (t^m)-FieldT::one();
-    FieldT l = Z * FieldT(m).inverse();
-    FieldT r = FieldT::one();
-    for (size_t i = 0; i < m; ++i)
-    {
-        u[i] = l * (t - r).inverse();
-        l *= omega;
-        r *= omega;
-    }
+    const FieldT Z = (t^m) - FieldT::one();
+    _barycentric_lagrange_evaluation<FieldT>(m, nullptr, omega, nullptr, FieldT(m).inverse(), &t, 1, &Z, u.data());
 
     return u;
 }
@@ -0,0 +1,95 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for the "distributed radix-2" evaluation domain.
+
+ This is the domain of basic_radix2_domain (the m-th roots of unity, for m = 2^k),
+ for vectors split between P nodes (P a power of 2 with P^2 <= m), each of which holds
+ L = m / P of the elements and runs the transforms on its own part, together with the
+ other nodes. The transforms go through the decomposition m = L * P of the FFT:
+ local FFTs of size L, twiddle factors, one exchange between all the nodes (an
+ all-to-all, i.e. a global transpose), then local FFTs of size P. The local FFTs run
+ through the kernels of basic_radix2_domain_aux.hpp.
+
+ So that a single exchange is enough, the elements are not split in consecutive ranges:
+ - the input of FFT and cosetFFT (and output of iFFT and icosetFFT) is split
+   cyclically: node p holds the elements p + P * j, for j < L;
+ - the output of FFT and cosetFFT (and input of iFFT and icosetFFT) is split in
+   blocks of B = L / P elements: node p holds block p of each run of L elements, i.e.
+   the elements L * (j / B) + B * p + (j % B), for j < L.
+ (input_index and output_index give these indices.)
+
+ The exchange goes through a transport: a function that each node calls at the same
+ time with P blocks of block_size elements in send (block q to be sent to node q), and
+ that returns, in recv, the P blocks sent to this node (block q from node q). This is
+ the semantics of MPI_Alltoall, see distributed_radix2_domain_mpi.hpp.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef DISTRIBUTED_RADIX2_DOMAIN_HPP_
+#define DISTRIBUTED_RADIX2_DOMAIN_HPP_
+
+#include <functional>
+#include <vector>
+
+namespace libfqfft {
+
+template<typename FieldT>
+class distributed_radix2_domain {
+public:
+
+    typedef std::function<void(const FieldT *send, FieldT *recv, const size_t block_size)> transport_type;
+
+    const size_t m;
+    const size_t num_nodes;
+    const size_t rank;
+    FieldT omega;
+
+    /**
+     * The part of node rank (of num_nodes) of a domain of size m, exchanging through transport
+     * (which is not called when num_nodes is 1).
+     */
+    distributed_radix2_domain(const size_t m, const size_t num_nodes, const size_t rank, const transport_type &transport);
+
+    /**
+     * The number of elements held by each node, L = m / num_nodes.
+     */
+    size_t local_size() const;
+
+    /**
+     * The index in the whole vector of element j of this node, for the input of FFT
+     * (and output of iFFT), or for the output of FFT (and input of iFFT).
+     */
+    size_t input_index(const size_t j) const;
+    size_t output_index(const size_t j) const;
+
+    /**
+     * Transform the part a (of local_size() elements) of this node, together with the other nodes.
+     */
+    void FFT(std::vector<FieldT> &a);
+    void iFFT(std::vector<FieldT> &a);
+    void cosetFFT(std::vector<FieldT> &a, const FieldT &g);
+    void icosetFFT(std::vector<FieldT> &a, const FieldT &g);
+
+private:
+
+    size_t L;
+    size_t B;
+    transport_type transport;
+    std::vector<FieldT> twiddles;
+    std::vector<FieldT> inverse_twiddles;
+
+    void forward(std::vector<FieldT> &a, const FieldT &in_g);
+    void inverse(std::vector<FieldT> &a, const FieldT &out_g);
+    void exchange(std::vector<FieldT> &a);
+};
+
+} // libfqfft
+
+#include <libfqfft/evaluation_domain/domains/distributed_radix2_domain.tcc>
+
+#endif // DISTRIBUTED_RADIX2_DOMAIN_HPP_
@@ -0,0 +1,215 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for the "distributed radix-2" evaluation domain.
+
+ See distributed_radix2_domain.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef DISTRIBUTED_RADIX2_DOMAIN_TCC_
+#define DISTRIBUTED_RADIX2_DOMAIN_TCC_
+
+#include <algorithm>
+
+#include <libff/algebra/fields/field_utils.hpp>
+#include <libff/common/double.hpp>
+#include <libff/common/utils.hpp>
+
+#include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
+namespace libfqfft {
+
+template<typename FieldT>
+distributed_radix2_domain<FieldT>::distributed_radix2_domain(const size_t m, const size_t num_nodes, const size_t rank,
+                                                             const transport_type &transport) :
+    m(m), num_nodes(num_nodes), rank(rank), transport(transport)
+{
+    if (m <= 1) throw InvalidSizeException("distributed_radix2(): expected m > 1");
+
+    const size_t logm = libff::log2(m);
+    if (m != ((size_t)1 << logm)) throw DomainSizeException("distributed_radix2(): expected m to be a power of 2");
+    if (!std::is_same<FieldT, libff::Double>::value)
+    {
+        if (logm > (FieldT::s)) throw DomainSizeException("distributed_radix2(): expected logm <= FieldT::s");
+    }
+
+    if (num_nodes == 0 || num_nodes != ((size_t)1 << libff::log2(num_nodes)) || num_nodes * num_nodes > m)
+        throw InvalidSizeException("distributed_radix2(): expected num_nodes to be a power of 2 with num_nodes^2 <= m");
+    if (rank >= num_nodes) throw InvalidSizeException("distributed_radix2(): expected rank < num_nodes");
+    if (num_nodes > 1 && !transport) throw InvalidSizeException("distributed_radix2(): expected a transport");
+
+    bool success;
+    omega = libff::get_root_of_unity2<FieldT>(m, &success);
+    if (!success) throw DomainSizeException("libff::get_root_of_unity2 invalid argument");
+
+    L = m / num_nodes;
+    B = L / num_nodes;
+
+    /* The tables of the size-L FFTs over omega^P also serve the size-P FFTs over omega^L */
+    const size_t logL = libff::log2(L);
+    twiddles = _basic_radix2_twiddle_table(L, omega^num_nodes, logL);
+    inverse_twiddles = _basic_radix2_twiddle_table(L, omega.inverse()^num_nodes, logL);
+}
+
+template<typename FieldT>
+size_t distributed_radix2_domain<FieldT>::local_size() const
+{
+    return L;
+}
+
+template<typename FieldT>
+size_t distributed_radix2_domain<FieldT>::input_index(const size_t j) const
+{
+    return rank + num_nodes * j;
+}
+
+template<typename FieldT>
+size_t distributed_radix2_domain<FieldT>::output_index(const size_t j) const
+{
+    return L * (j / B) + B * rank + j % B;
+}
+
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::FFT(std::vector<FieldT> &a)
+{
+    forward(a, FieldT::one());
+}
+
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a)
+{
+    inverse(a, FieldT::one());
+}
+
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    forward(a, g);
+}
+
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    inverse(a, g.inverse());
+}
+
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::exchange(std::vector<FieldT> &a)
+{
+    if (num_nodes == 1) return;
+
+    std::vector<FieldT> received(L);
+    transport(a.data(), received.data(), B);
+    a.swap(received);
+}
+
+/*
+ With i = p + P * l and k = k1 + L * k2 (for l, k1 < L and p, k2 < P),
+ X[k] = sum_p (omega^L)^{p * k2} * omega^{p * k1} * [sum_l a[i] * (omega^P)^{l * k1}]:
+ node p computes the bracket, for all k1, and node q the outer sums, for k1 in its block.
+ */
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::forward(std::vector<FieldT> &a, const FieldT &in_g)
+{
+    if (a.size() != L) throw DomainSizeException("distributed_radix2: expected a.size() == local_size()");
+
+    if (!(in_g == FieldT::one()))
+    {
+        FieldT p = in_g^rank;
+        const FieldT step = in_g^num_nodes;
+        for (size_t l = 0; l < L; l++)
+        {
+            a[l] *= p;
+            p *= step;
+        }
+    }
+
+    _basic_radix2_FFT(a.data(), L, omega^num_nodes, twiddles);
+
+    const FieldT t = omega^rank;
+    FieldT q = t;
+    for (size_t k1 = 1; k1 < L; k1++)
+    {
+        a[k1] *= q;
+        q *= t;
+    }
+
+    /* Block q (k1 in [q * B, (q + 1) * B)) goes to node q, and from node p, value k1 = rank * B + j lands at p * B + j */
+    exchange(a);
+
+    const FieldT omega_L = omega^L;
+    const size_t num_chunks = std::min(execution_concurrency(), B);
+    parallel_for(num_chunks, [&](const size_t c) {
+            std::vector<FieldT> column(num_nodes);
+            for (size_t j = c * B / num_chunks; j < (c + 1) * B / num_chunks; j++)
+            {
+                for (size_t p = 0; p < num_nodes; p++)
+                {
+                    column[p] = a[p * B + j];
+                }
+                _basic_radix2_FFT(column.data(), num_nodes, omega_L, twiddles);
+                for (size_t k2 = 0; k2 < num_nodes; k2++)
+                {
+                    a[k2 * B + j] = column[k2];
+                }
+            }
+        });
+}
+
+/*
+ The transpose of forward, over omega^{-1}: with i and k as above,
+ m * a[i] = sum_k1 (omega^{-P})^{l * k1} * [omega^{-p * k1} * sum_k2 X[k] * (omega^{-L})^{p * k2}]:
+ node q computes the bracket, for all p and k1 in its block, and node p the outer sum.
+ */
+template<typename FieldT>
+void distributed_radix2_domain<FieldT>::inverse(std::vector<FieldT> &a, const FieldT &out_g)
+{
+    if (a.size() != L) throw DomainSizeException("distributed_radix2: expected a.size() == local_size()");
+
+    const FieldT omega_inverse = omega.inverse();
+    const FieldT omega_inverse_L = omega_inverse^L;
+    const size_t num_chunks = std::min(execution_concurrency(), B);
+    parallel_for(num_chunks, [&](const size_t c) {
+            std::vector<FieldT> column(num_nodes);
+            for (size_t j = c * B / num_chunks; j < (c + 1) * B / num_chunks; j++)
+            {
+                for (size_t k2 = 0; k2 < num_nodes; k2++)
+                {
+                    column[k2] = a[k2 * B + j];
+                }
+                _basic_radix2_FFT(column.data(), num_nodes, omega_inverse_L, inverse_twiddles);
+
+                const FieldT t = omega_inverse^(rank * B + j);
+                FieldT q = FieldT::one();
+                for (size_t p = 0; p < num_nodes; p++)
+                {
+                    a[p * B + j] = column[p] * q;
+                    q *= t;
+                }
+            }
+        });
+
+    /* Block p goes to node p, and from node q, value k1 = q * B + j lands at k1 */
+    exchange(a);
+
+    _basic_radix2_FFT(a.data(), L, omega_inverse^num_nodes, inverse_twiddles);
+
+    FieldT p = FieldT(m).inverse() * (out_g^rank);
+    const FieldT step = out_g^num_nodes;
+    for (size_t l = 0; l < L; l++)
+    {
+        a[l] *= p;
+        p *= step;
+    }
+}
+
+} // libfqfft
+
+#endif // DISTRIBUTED_RADIX2_DOMAIN_TCC_
@@ -0,0 +1,58 @@
+/** @file
+ *****************************************************************************
+
+ An MPI transport for distributed_radix2_domain.
+
+ This header is not included by the rest of the library, so that only the programs
+ that use it need MPI (and get <mpi.h> from their MPI compiler wrapper).
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef DISTRIBUTED_RADIX2_DOMAIN_MPI_HPP_
+#define DISTRIBUTED_RADIX2_DOMAIN_MPI_HPP_
+
+#include <climits>
+
+#include <mpi.h>
+
+#include <libfqfft/evaluation_domain/domains/distributed_radix2_domain.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+
+namespace libfqfft {
+
+/**
+ * A transport through MPI_Alltoall on comm, sending the elements as raw bytes (so all the
+ * nodes must run on machines with the same representation of FieldT).
+ */
+template<typename FieldT>
+typename distributed_radix2_domain<FieldT>::transport_type mpi_all_to_all_transport(MPI_Comm comm)
+{
+    return [comm](const FieldT *send, FieldT *recv, const size_t block_size) {
+        if (block_size * sizeof(FieldT) > (size_t)INT_MAX)
+            throw InvalidSizeException("mpi_all_to_all_transport: expected blocks of at most INT_MAX bytes");
+
+        const int count = (int)(block_size * sizeof(FieldT));
+        if (MPI_Alltoall(const_cast<FieldT*>(send), count, MPI_BYTE, recv, count, MPI_BYTE, comm) != MPI_SUCCESS)
+            throw InvalidSizeException("mpi_all_to_all_transport: MPI_Alltoall failed");
+    };
+}
+
+/**
+ * The domain of size m for this process of comm.
+ */
+template<typename FieldT>
+distributed_radix2_domain<FieldT> mpi_distributed_radix2_domain(const size_t m, MPI_Comm comm)
+{
+    int num_nodes, rank;
+    MPI_Comm_size(comm, &num_nodes);
+    MPI_Comm_rank(comm, &rank);
+    return distributed_radix2_domain<FieldT>(m, (size_t)num_nodes, (size_t)rank, mpi_all_to_all_transport<FieldT>(comm));
+}
+
+} // libfqfft
+
+#endif // DISTRIBUTED_RADIX2_DOMAIN_MPI_HPP_
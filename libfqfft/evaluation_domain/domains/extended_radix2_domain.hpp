@@ -16,6 +16,8 @@
 #define EXTENDED_RADIX2_DOMAIN_HPP_
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <libfqfft/evaluation_domain/evaluation_domain.hpp>
 
@@ -31,16 +33,33 @@ public:
 
     extended_radix2_domain(const size_t m);
     static std::shared_ptr<extended_radix2_domain<FieldT>> create_ptr(const size_t m);
+    static bool supports(const size_t m);
     void FFT(std::vector<FieldT> &a);
     void iFFT(std::vector<FieldT> &a);
     void cosetFFT(std::vector<FieldT> &a, const FieldT &g);
     void icosetFFT(std::vector<FieldT> &a, const FieldT &g);
+    void FFT(const FieldT *in, FieldT *out, const size_t n);
+    void iFFT(const FieldT *in, FieldT *out, const size_t n);
+    void cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
+    void icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
     std::vector<FieldT> evaluate_all_lagrange_polynomials(const FieldT &t);
+    void evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out);
+    void evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out);
     FieldT get_domain_element(const size_t idx);
     FieldT compute_vanishing_polynomial(const FieldT &t);
     void add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H);
     void divide_by_Z_on_coset(std::vector<FieldT> &P);
 
+private:
+
+    /* The elements of the domain and their barycentric weights, computed on the first Lagrange evaluation */
+    std::once_flag lagrange_flag;
+    std::vector<FieldT> lagrange_points;
+    std::vector<FieldT> lagrange_weights;
+
+    void precompute_lagrange();
+    void evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out);
+
 };
 
 } // libfqfft
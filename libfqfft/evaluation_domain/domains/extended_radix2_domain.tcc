@@ -13,7 +13,9 @@
 
 #ifndef EXTENDED_RADIX2_DOMAIN_TCC_
 
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -42,21 +44,27 @@ extended_radix2_domain<FieldT>::extended_radix2_domain(const size_t m)
 }
 
 template <typename FieldT>
-std::shared_ptr<extended_radix2_domain<FieldT>> extended_radix2_domain<FieldT>::create_ptr(const size_t m)
+bool extended_radix2_domain<FieldT>::supports(const size_t m)
 {
-  std::shared_ptr<extended_radix2_domain<FieldT>> result;
-  if (m <= 1) return result;
+  if (m <= 1) return false;
 
   if (!std::is_same<FieldT, libff::Double>::value) {
     const size_t logm = libff::log2(m);
-    if (logm != (FieldT::s + 1)) return result;
+    if (logm != (FieldT::s + 1)) return false;
   }
 
   auto small_m = m / 2;
 
   bool success;
   libff::get_root_of_unity2<FieldT>(small_m, &success);
-  if (!success) return result;
+  return success;
+}
+
+template <typename FieldT>
+std::shared_ptr<extended_radix2_domain<FieldT>> extended_radix2_domain<FieldT>::create_ptr(const size_t m)
+{
+  std::shared_ptr<extended_radix2_domain<FieldT>> result;
+  if (!supports(m)) return result;
 
   result.reset(new extended_radix2_domain<FieldT>(m));
   return result;
@@ -64,43 +72,65 @@ std::shared_ptr<extended_radix2_domain<FieldT>> extended_radix2_domain<FieldT>::
 
 template <typename FieldT>
 void extended_radix2_domain<FieldT>::FFT(std::vector<FieldT> &a) {
-  if (a.size() != this->m)
-    throw DomainSizeException("extended_radix2: expected a.size() == this->m");
+  FFT(a.data(), a.data(), a.size());
+}
+
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a) {
+  iFFT(a.data(), a.data(), a.size());
+}
+
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a,
+                                              const FieldT &g) {
+  cosetFFT(a.data(), a.data(), a.size(), g);
+}
+
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a,
+                                               const FieldT &g) {
+  icosetFFT(a.data(), a.data(), a.size(), g);
+}
 
-  std::vector<FieldT> a0(small_m, FieldT::zero());
-  std::vector<FieldT> a1(small_m, FieldT::zero());
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::FFT(const FieldT *in, FieldT *out,
+                                         const size_t n) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::FFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  if (n != this->m)
+    throw DomainSizeException("extended_radix2: expected a.size() == this->m");
 
   const FieldT shift_to_small_m = shift ^ libff::bigint<1>(small_m);
 
+  // out[0..small_m) and out[small_m..m) take the two halves a0 and a1
   FieldT shift_i = FieldT::one();
   for (size_t i = 0; i < small_m; ++i) {
-    a0[i] = a[i] + a[small_m + i];
-    a1[i] = shift_i * (a[i] + shift_to_small_m * a[small_m + i]);
+    const FieldT x = in[i];
+    const FieldT y = in[small_m + i];
+    out[i] = x + y;
+    out[small_m + i] = shift_i * (x + shift_to_small_m * y);
 
     shift_i *= shift;
   }
 
-  _basic_radix2_FFT(a0, omega);
-  _basic_radix2_FFT(a1, omega);
-
-  for (size_t i = 0; i < small_m; ++i) {
-    a[i] = a0[i];
-    a[i + small_m] = a1[i];
-  }
+  _basic_radix2_FFT(out, small_m, omega, std::vector<FieldT>());
+  _basic_radix2_FFT(out + small_m, small_m, omega, std::vector<FieldT>());
 }
 
 template <typename FieldT>
-void extended_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a) {
-  if (a.size() != this->m)
+void extended_radix2_domain<FieldT>::iFFT(const FieldT *in, FieldT *out,
+                                          const size_t n) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::iFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  if (n != this->m)
     throw DomainSizeException("extended_radix2: expected a.size() == this->m");
 
-  // note: this is not in-place
-  std::vector<FieldT> a0(a.begin(), a.begin() + small_m);
-  std::vector<FieldT> a1(a.begin() + small_m, a.end());
+  if (in != out) std::copy(in, in + n, out);
 
   const FieldT omega_inverse = omega.inverse();
-  _basic_radix2_FFT(a0, omega_inverse);
-  _basic_radix2_FFT(a1, omega_inverse);
+  _basic_radix2_FFT(out, small_m, omega_inverse, std::vector<FieldT>());
+  _basic_radix2_FFT(out + small_m, small_m, omega_inverse,
+                    std::vector<FieldT>());
 
   const FieldT shift_to_small_m = shift ^ libff::bigint<1>(small_m);
   const FieldT sconst =
@@ -110,50 +140,104 @@ void extended_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a) {
   FieldT shift_inverse_i = FieldT::one();
 
   for (size_t i = 0; i < small_m; ++i) {
-    a[i] = sconst * (-shift_to_small_m * a0[i] + shift_inverse_i * a1[i]);
-    a[i + small_m] = sconst * (a0[i] - shift_inverse_i * a1[i]);
+    const FieldT a0 = out[i];
+    const FieldT a1 = out[i + small_m];
+    out[i] = sconst * (-shift_to_small_m * a0 + shift_inverse_i * a1);
+    out[i + small_m] = sconst * (a0 - shift_inverse_i * a1);
 
     shift_inverse_i *= shift_inverse;
   }
 }
 
 template <typename FieldT>
-void extended_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a,
+void extended_radix2_domain<FieldT>::cosetFFT(const FieldT *in, FieldT *out,
+                                              const size_t n,
                                               const FieldT &g) {
-  _multiply_by_coset(a, g);
-  FFT(a);
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::cosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  if (in != out) std::copy(in, in + n, out);
+  _multiply_by_coset(out, n, g);
+  FFT(out, out, n);
 }
 
 template <typename FieldT>
-void extended_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a,
+void extended_radix2_domain<FieldT>::icosetFFT(const FieldT *in, FieldT *out,
+                                               const size_t n,
                                                const FieldT &g) {
-  iFFT(a);
-  _multiply_by_coset(a, g.inverse());
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::icosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  iFFT(in, out, n);
+  _multiply_by_coset(out, n, g.inverse());
 }
 
 template <typename FieldT>
 std::vector<FieldT>
 extended_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(
     const FieldT &t) {
-  const std::vector<FieldT> T0 =
-      _basic_radix2_evaluate_all_lagrange_polynomials(small_m, t);
-  const std::vector<FieldT> T1 =
-      _basic_radix2_evaluate_all_lagrange_polynomials(small_m,
-                                                      t * shift.inverse());
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  std::vector<FieldT> u(this->m);
+  LIBFQFFT_COUNT_ALLOCATION(this->m * sizeof(FieldT));
+  evaluate_lagrange_rows(&t, 1, u.data());
+  return u;
+}
 
-  std::vector<FieldT> result(this->m, FieldT::zero());
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(
+    const FieldT &t, FieldT *out) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(&t, 1, out);
+}
 
-  const FieldT t_to_small_m = t ^ libff::bigint<1>(small_m);
-  const FieldT shift_to_small_m = shift ^ libff::bigint<1>(small_m);
-  const FieldT one_over_denom = (shift_to_small_m - FieldT::one()).inverse();
-  const FieldT T0_coeff = (t_to_small_m - shift_to_small_m) * (-one_over_denom);
-  const FieldT T1_coeff = (t_to_small_m - FieldT::one()) * one_over_denom;
-  for (size_t i = 0; i < small_m; ++i) {
-    result[i] = T0[i] * T0_coeff;
-    result[i + small_m] = T1[i] * T1_coeff;
-  }
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(
+    const std::vector<FieldT> &ts, FieldT *out) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::evaluate_all_lagrange_polynomials_batch");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(ts.data(), ts.size(), out);
+}
 
-  return result;
+/*
+ The domain is (omega^i)_{i < small_m} followed by (shift * omega^i)_{i < small_m}, the roots
+ of z^{small_m} - 1 and of z^{small_m} - shift^{small_m}, so that the weights v_i = 1 / Z'(x_i) are
+ x_i / (small_m * (1 - shift^{small_m})) for the former, and
+ x_i / (small_m * shift^{small_m} * (shift^{small_m} - 1)) for the latter.
+ */
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::precompute_lagrange() {
+  std::call_once(lagrange_flag, [this]() {
+    std::vector<FieldT> points(this->m), weights(this->m);
+    const FieldT shift_to_small_m = shift ^ libff::bigint<1>(small_m);
+    const FieldT T0_scale = (FieldT(small_m) * (FieldT::one() - shift_to_small_m)).inverse();
+    const FieldT T1_scale = (FieldT(small_m) * shift_to_small_m * (shift_to_small_m - FieldT::one())).inverse();
+
+    FieldT x = FieldT::one();
+    for (size_t i = 0; i < small_m; ++i) {
+      points[i] = x;
+      points[i + small_m] = shift * x;
+      weights[i] = T0_scale * points[i];
+      weights[i + small_m] = T1_scale * points[i + small_m];
+      x *= omega;
+    }
+
+    lagrange_points.swap(points);
+    lagrange_weights.swap(weights);
+  });
+}
+
+template <typename FieldT>
+void extended_radix2_domain<FieldT>::evaluate_lagrange_rows(const FieldT *ts,
+                                                            const size_t k,
+                                                            FieldT *out) {
+  precompute_lagrange();
+
+  std::vector<FieldT> Z(k);
+  for (size_t j = 0; j < k; ++j) {
+    Z[j] = compute_vanishing_polynomial(ts[j]);
+  }
+  _barycentric_lagrange_evaluation<FieldT>(this->m, lagrange_points.data(), FieldT::one(),
+                                           lagrange_weights.data(), FieldT::one(), ts, k, Z.data(), out);
 }
 
 template <typename FieldT>
@@ -174,6 +258,8 @@ FieldT extended_radix2_domain<FieldT>::compute_vanishing_polynomial(
 template <typename FieldT>
 void extended_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff,
                                                 std::vector<FieldT> &H) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::add_poly_Z");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   libff::enter_block("extended_radix2_domain::add_poly_Z");
 
   if (H.size() != this->m + 1)
@@ -192,6 +278,8 @@ void extended_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff,
 template <typename FieldT>
 void extended_radix2_domain<FieldT>::divide_by_Z_on_coset(
     std::vector<FieldT> &P) {
+  LIBFQFFT_INSTRUMENT_SCOPE("extended_radix2_domain::divide_by_Z_on_coset");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   const FieldT coset = FieldT::multiplicative_generator;
 
   const FieldT coset_to_small_m = coset ^ small_m;
@@ -14,12 +14,14 @@
 #ifndef GEOMETRIC_SEQUENCE_DOMAIN_TCC_
 #define GEOMETRIC_SEQUENCE_DOMAIN_TCC_
 
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
 #include <libfqfft/polynomial_arithmetic/basis_change.hpp>
-
-#ifdef MULTICORE
-#include <omp.h>
-#endif
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/binary_serialization.hpp>
+#include <libfqfft/tools/elementwise_operations.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -33,13 +35,19 @@ geometric_sequence_domain<FieldT>::geometric_sequence_domain(const size_t m) : e
   precomputation_sentinel = 0;
 }
 
+template<typename FieldT>
+bool geometric_sequence_domain<FieldT>::supports(const size_t m)
+{
+  if (m <= 1) return false;
+  return !(FieldT::geometric_generator() == FieldT::zero());
+}
+
 template<typename FieldT>
 std::shared_ptr<geometric_sequence_domain<FieldT>> geometric_sequence_domain<FieldT>::create_ptr(const size_t m)
 {
   std::shared_ptr<geometric_sequence_domain<FieldT>> result;
-  if (m <= 1) return result;
-  if (FieldT::geometric_generator() == FieldT::zero()) return result;
-  
+  if (!supports(m)) return result;
+
   result.reset(new geometric_sequence_domain<FieldT>(m));
   return result;
 }
@@ -47,71 +55,35 @@ std::shared_ptr<geometric_sequence_domain<FieldT>> geometric_sequence_domain<Fie
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::FFT(std::vector<FieldT> &a)
 { 
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::FFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   if (a.size() != this->m) throw DomainSizeException("geometric: expected a.size() == this->m");
 
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   monomial_to_newton_basis_geometric(a, this->geometric_sequence, this->geometric_triangular_sequence, this->m);
 
   /* Newton to Evaluation */
-  std::vector<FieldT> T(this->m);
-  T[0] = FieldT::one();
-
-  std::vector<FieldT> g(this->m);
-  g[0] = a[0];
-
-  for (size_t i = 1; i < this->m; i++)
-  {
-    T[i] = T[i-1] * (this->geometric_sequence[i] - FieldT::one()).inverse();
-    g[i] = this->geometric_triangular_sequence[i] * a[i];
-  }
-
-  _polynomial_multiplication(a, g, T);
-  a.resize(this->m);
-
-#ifdef MULTICORE
-  #pragma omp parallel for
-#endif
-  for (size_t i = 0; i < this->m; i++)
-  {
-    a[i] *= T[i].inverse();
-  }
+  elementwise_multiplication(a.data(), a.data(), this->geometric_triangular_sequence.data(), this->m);
+  _polynomial_multiplication_on_fft(a, this->FFT_convolution, a);
+  a.resize(this->m, FieldT::zero());
+  elementwise_multiplication(a.data(), a.data(), this->T_inverse.data(), this->m);
 }
 
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::iFFT(std::vector<FieldT> &a)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::iFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   if (a.size() != this->m) throw DomainSizeException("geometric: expected a.size() == this->m");
   
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   /* Interpolation to Newton */
-  std::vector<FieldT> T(this->m);
-  T[0] = FieldT::one();
-
-  std::vector<FieldT> W(this->m);
-  W[0] = a[0] * T[0];
-
-  FieldT prev_T = T[0];
-  for (size_t i = 1; i < this->m; i++)
-  {
-    prev_T *= (this->geometric_sequence[i] - FieldT::one()).inverse();
-
-    W[i] = a[i] * prev_T;
-    T[i] = this->geometric_triangular_sequence[i] * prev_T;
-    if (i % 2 == 1) T[i] = -T[i];
-  }
-
-  _polynomial_multiplication(a, W, T);
-  a.resize(this->m);
-
-#ifdef MULTICORE
-  #pragma omp parallel for
-#endif
-  for (size_t i = 0; i < this->m; i++)
-  {
-    a[i] *= this->geometric_triangular_sequence[i].inverse();
-  }
+  elementwise_multiplication(a.data(), a.data(), this->T.data(), this->m);
+  _polynomial_multiplication_on_fft(a, this->iFFT_convolution, a);
+  a.resize(this->m, FieldT::zero());
+  elementwise_multiplication(a.data(), a.data(), this->geometric_triangular_sequence_inverse.data(), this->m);
 
   newton_to_monomial_basis_geometric(a, this->geometric_sequence, this->geometric_triangular_sequence, this->m);
 }
@@ -119,6 +91,8 @@ void geometric_sequence_domain<FieldT>::iFFT(std::vector<FieldT> &a)
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::cosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   _multiply_by_coset(a, g);
   FFT(a);
 }
@@ -126,6 +100,8 @@ void geometric_sequence_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const F
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::icosetFFT");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   iFFT(a);
   _multiply_by_coset(a, g.inverse());
 }
@@ -133,70 +109,34 @@ void geometric_sequence_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const
 template<typename FieldT>
 std::vector<FieldT> geometric_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t)
 {
-  /* Compute Lagrange polynomial of size m, with m+1 points (x_0, y_0), ... ,(x_m, y_m) */
-  /* Evaluate for x = t */
-  /* Return coeffs for each l_j(x) = (l / l_i[j]) * w[j] */
-
-  /* for all i: w[i] = (1 / r) * w[i-1] * (1 - a[i]^m-i+1) / (1 - a[i]^-i) */
-
-  if (!this->precomputation_sentinel) do_precomputation();
-
-  /**
-   * If t equals one of the geometric progression values,
-   * then output 1 at the right place, and 0 elsewhere.
-   */
-  for (size_t i = 0; i < this->m; ++i)
-  {
-    if (this->geometric_sequence[i] == t) // i.e., t equals a[i]
-    {
-      std::vector<FieldT> res(this->m, FieldT::zero());
-      res[i] = FieldT::one();
-      return res;
-    }
-  }
-
-  /**
-   * Otherwise, if t does not equal any of the geometric progression values,
-   * then compute each Lagrange coefficient.
-   */
-  std::vector<FieldT> l(this->m);
-  l[0] = t - this->geometric_sequence[0];
-
-  std::vector<FieldT> g(this->m);
-  g[0] = FieldT::zero();
-
-  FieldT l_vanish = l[0];
-  FieldT g_vanish = FieldT::one();
-  for (size_t i = 1; i < this->m; i++)
-  {
-    l[i] = t - this->geometric_sequence[i];
-    g[i] = FieldT::one() - this->geometric_sequence[i];
-
-    l_vanish *= l[i];
-    g_vanish *= g[i];
-  }
-
-  FieldT r = this->geometric_sequence[this->m-1].inverse();
-  FieldT r_i = r;
-
-  std::vector<FieldT> g_i(this->m);
-  g_i[0] = g_vanish.inverse();
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  std::vector<FieldT> u(this->m);
+  LIBFQFFT_COUNT_ALLOCATION(this->m * sizeof(FieldT));
+  evaluate_lagrange_rows(&t, 1, u.data());
+  return u;
+}
 
-  l[0] = l_vanish * l[0].inverse() * g_i[0];
-  for (size_t i = 1; i < this->m; i++)
-  {
-    g_i[i] = g_i[i-1] * g[this->m-i] * -g[i].inverse() * this->geometric_sequence[i];
-    l[i] = l_vanish * r_i * l[i].inverse() * g_i[i];
-    r_i *= r;
-  }
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out)
+{
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::evaluate_all_lagrange_polynomials");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(&t, 1, out);
+}
 
-  return l;
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out)
+{
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::evaluate_all_lagrange_polynomials_batch");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
+  evaluate_lagrange_rows(ts.data(), ts.size(), out);
 }
 
 template<typename FieldT>
 FieldT geometric_sequence_domain<FieldT>::get_domain_element(const size_t idx)
 {
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   return this->geometric_sequence[idx];
 }
@@ -204,7 +144,7 @@ FieldT geometric_sequence_domain<FieldT>::get_domain_element(const size_t idx)
 template<typename FieldT>
 FieldT geometric_sequence_domain<FieldT>::compute_vanishing_polynomial(const FieldT &t)
 {
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   /* Notes: Z = prod_{i = 0 to m} (t - a[i]) */
   /* Better approach: Montgomery Trick + Divide&Conquer/FFT */
@@ -219,11 +159,13 @@ FieldT geometric_sequence_domain<FieldT>::compute_vanishing_polynomial(const Fie
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::add_poly_Z");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   libff::enter_block("geometric_sequence_domain::add_poly_Z");
 
   if (H.size() != this->m+1) throw DomainSizeException("geometric: expected H.size() == this->m+1");
 
-  if (!this->precomputation_sentinel) do_precomputation();
+  precompute();
 
   std::vector<FieldT> x(2, FieldT::zero());
   x[0] = -this->geometric_sequence[0];
@@ -239,13 +181,9 @@ void geometric_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vec
     _polynomial_multiplication(x, x, t);
   }
 
-#ifdef MULTICORE
-  #pragma omp parallel for
-#endif
-  for (size_t i = 0; i < this->m+1; i++)
-  {
-    H[i] += (x[i] * coeff);
-  }
+  parallel_for(this->m+1, [&](const size_t i) {
+      H[i] += (x[i] * coeff);
+    });
 
   libff::leave_block("geometric_sequence_domain::add_poly_Z");
 }
@@ -253,6 +191,8 @@ void geometric_sequence_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vec
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT> &P)
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::divide_by_Z_on_coset");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   const FieldT coset = FieldT::multiplicative_generator; /* coset in geometric sequence? */
   const FieldT Z_inverse_at_coset = this->compute_vanishing_polynomial(coset).inverse();
   for (size_t i = 0; i < this->m; ++i)
@@ -264,21 +204,159 @@ void geometric_sequence_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT>
 template<typename FieldT>
 void geometric_sequence_domain<FieldT>::do_precomputation()
 {
+  LIBFQFFT_INSTRUMENT_SCOPE("geometric_sequence_domain::precompute");
+  const execution_scope policy_scope(this->execution, this->execution_max_threads);
   this->geometric_sequence = std::vector<FieldT>(this->m, FieldT::zero());
-  this->geometric_sequence[0] = FieldT::one();
-
   this->geometric_triangular_sequence = std::vector<FieldT>(this->m, FieldT::zero());
-  this->geometric_triangular_sequence[0] = FieldT::one();
 
+  /*
+   * geometric_sequence[i] = g^i and geometric_triangular_sequence[i] = g^{i(i-1)/2},
+   * computed by running products over disjoint ranges (each range derives its first terms directly).
+   */
+  const FieldT g = FieldT::geometric_generator();
+  const size_t num_chunks = std::min(execution_concurrency(), this->m);
+  parallel_for(num_chunks, [&](const size_t c) {
+      const size_t start = c * this->m / num_chunks, end = (c + 1) * this->m / num_chunks;
+      if (start == end) return;
+
+      this->geometric_sequence[start] = g ^ start;
+      this->geometric_triangular_sequence[start] = (start == 0 ? FieldT::one() : g ^ (start * (start - 1) / 2));
+      for (size_t i = start + 1; i < end; i++)
+      {
+        this->geometric_sequence[i] = this->geometric_sequence[i-1] * g;
+        this->geometric_triangular_sequence[i] = this->geometric_triangular_sequence[i-1] * this->geometric_sequence[i-1];
+      }
+    });
+
+  /* The Newton-to-evaluation sequences, with one batch inversion for both T and the
+     inverse of geometric_triangular_sequence */
+  std::vector<FieldT> inverses(2 * this->m);
+  inverses[0] = FieldT::one();
   for (size_t i = 1; i < this->m; i++)
   {
-    this->geometric_sequence[i] = this->geometric_sequence[i-1] * FieldT::geometric_generator();
-    this->geometric_triangular_sequence[i] = this->geometric_triangular_sequence[i-1] * this->geometric_sequence[i-1];
+    inverses[i] = inverses[i-1] * (this->geometric_sequence[i] - FieldT::one());
   }
+  this->T_inverse.assign(inverses.begin(), inverses.begin() + this->m);
+  std::copy(this->geometric_triangular_sequence.begin(), this->geometric_triangular_sequence.end(), inverses.begin() + this->m);
+  batch_inversion(inverses);
+  this->T.assign(inverses.begin(), inverses.begin() + this->m);
+  this->geometric_triangular_sequence_inverse.assign(inverses.begin() + this->m, inverses.end());
+
+  const size_t n = libff::get_power_of_two(2 * this->m - 1);
+  this->FFT_convolution.assign(this->T, n);
+
+  std::vector<FieldT> iFFT_T(this->m);
+  for (size_t i = 0; i < this->m; i++)
+  {
+    iFFT_T[i] = this->geometric_triangular_sequence[i] * this->T[i];
+    if (i % 2 == 1) iFFT_T[i] = -iFFT_T[i];
+  }
+  this->iFFT_convolution.assign(iFFT_T, n);
 
   this->precomputation_sentinel = 1;
 }
 
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::precompute()
+{
+  std::call_once(this->precomputation_flag, &geometric_sequence_domain<FieldT>::do_precomputation, this);
+}
+
+/*
+ With a = geometric_sequence and r = a[m-1]^{-1}, the weights are v_i = r^i * g_i, where
+ g_0 = 1 / prod_{k>0} (1 - a[k]) and g_i = -g_{i-1} * a[i] * (1 - a[m-i]) / (1 - a[i]).
+ */
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::precompute_lagrange()
+{
+  precompute();
+
+  std::call_once(this->lagrange_flag, [this]() {
+    std::vector<FieldT> g(this->m);
+    g[0] = FieldT::zero();
+
+    FieldT g_vanish = FieldT::one();
+    for (size_t i = 1; i < this->m; i++)
+    {
+      g[i] = FieldT::one() - this->geometric_sequence[i];
+      g_vanish *= g[i];
+    }
+
+    /* g[0] is zero and unused below */
+    batch_inversion(g.data() + 1, this->m - 1);
+
+    const FieldT r = this->geometric_sequence[this->m-1].inverse();
+    FieldT r_i = r;
+
+    std::vector<FieldT> weights(this->m);
+    FieldT g_i = g_vanish.inverse();
+    weights[0] = g_i;
+    for (size_t i = 1; i < this->m; i++)
+    {
+      g_i = g_i * (FieldT::one() - this->geometric_sequence[this->m-i]) * -g[i] * this->geometric_sequence[i];
+      weights[i] = r_i * g_i;
+      r_i *= r;
+    }
+
+    this->lagrange_weights.swap(weights);
+  });
+}
+
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out)
+{
+  precompute_lagrange();
+
+  _barycentric_lagrange_evaluation<FieldT>(this->m, this->geometric_sequence.data(), FieldT::one(),
+                                           this->lagrange_weights.data(), FieldT::one(), ts, k, nullptr, out);
+}
+
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::save_precomputation(std::ostream &out)
+{
+  precompute();
+
+  write_binary(out, this->geometric_sequence);
+  write_binary(out, this->geometric_triangular_sequence);
+  write_binary(out, this->T);
+  write_binary(out, this->T_inverse);
+  write_binary(out, this->geometric_triangular_sequence_inverse);
+  write_binary(out, this->FFT_convolution);
+  write_binary(out, this->iFFT_convolution);
+}
+
+template<typename FieldT>
+void geometric_sequence_domain<FieldT>::load_precomputation(std::istream &in)
+{
+  std::vector<FieldT> sequence, triangular_sequence, saved_T, saved_T_inverse, triangular_sequence_inverse;
+  pretransformed_operand<FieldT> FFT_operand, iFFT_operand;
+  read_binary(in, sequence);
+  read_binary(in, triangular_sequence);
+  read_binary(in, saved_T);
+  read_binary(in, saved_T_inverse);
+  read_binary(in, triangular_sequence_inverse);
+  read_binary(in, FFT_operand);
+  read_binary(in, iFFT_operand);
+
+  const size_t n = libff::get_power_of_two(2 * this->m - 1);
+  if (sequence.size() != this->m || triangular_sequence.size() != this->m || saved_T.size() != this->m ||
+      saved_T_inverse.size() != this->m || triangular_sequence_inverse.size() != this->m ||
+      FFT_operand.size() != this->m || FFT_operand.transform_size() != n ||
+      iFFT_operand.size() != this->m || iFFT_operand.transform_size() != n)
+    throw SerializationException("geometric: saved precomputation does not match the domain");
+
+  std::call_once(this->precomputation_flag, [&]() {
+    this->geometric_sequence.swap(sequence);
+    this->geometric_triangular_sequence.swap(triangular_sequence);
+    this->T.swap(saved_T);
+    this->T_inverse.swap(saved_T_inverse);
+    this->geometric_triangular_sequence_inverse.swap(triangular_sequence_inverse);
+    this->FFT_convolution = FFT_operand;
+    this->iFFT_convolution = iFFT_operand;
+    this->precomputation_sentinel = 1;
+  });
+}
+
 } // libfqfft
 
 #endif // GEOMETRIC_SEQUENCE_DOMAIN_TCC_
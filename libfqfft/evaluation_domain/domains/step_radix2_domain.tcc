@@ -13,7 +13,10 @@
 
 #ifndef STEP_RADIX2_DOMAIN_TCC_
 
+#include <libfqfft/evaluation_domain/domains/barycentric_lagrange_aux.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -48,24 +51,28 @@ step_radix2_domain<FieldT>::step_radix2_domain(const size_t m) : evaluation_doma
 }
 
 template<typename FieldT>
-std::shared_ptr<step_radix2_domain<FieldT>> step_radix2_domain<FieldT>::create_ptr(const size_t m)
+bool step_radix2_domain<FieldT>::supports(const size_t m)
 {
-  std::shared_ptr<step_radix2_domain<FieldT>> result;
-  if (m <= 1) return result;
+  if (m <= 1) return false;
 
   auto big_m = ((size_t)1)<<(libff::log2(m)-1);
   auto small_m = m - big_m;
 
-  if (small_m != ((size_t)1) << libff::log2(small_m)) return result;
+  if (small_m != ((size_t)1) << libff::log2(small_m)) return false;
 
   bool success;
-  auto omega =
-      libff::get_root_of_unity2<FieldT>(((size_t)1) << libff::log2(m), &success);
-  if (!success) return result;
+  libff::get_root_of_unity2<FieldT>(((size_t)1) << libff::log2(m), &success);
+  if (!success) return false;
 
-  auto big_omega = omega.squared();
-  auto small_omega = libff::get_root_of_unity2<FieldT>(small_m, &success);
-  if (!success) return result;
+  libff::get_root_of_unity2<FieldT>(small_m, &success);
+  return success;
+}
+
+template<typename FieldT>
+std::shared_ptr<step_radix2_domain<FieldT>> step_radix2_domain<FieldT>::create_ptr(const size_t m)
+{
+  std::shared_ptr<step_radix2_domain<FieldT>> result;
+  if (!supports(m)) return result;
 
   result.reset(new step_radix2_domain<FieldT>(m));
   return result;
@@ -74,151 +81,209 @@ std::shared_ptr<step_radix2_domain<FieldT>> step_radix2_domain<FieldT>::create_p
 template<typename FieldT>
 void step_radix2_domain<FieldT>::FFT(std::vector<FieldT> &a)
 {
-    if (a.size() != this->m) throw DomainSizeException("step_radix2: expected a.size() == this->m");
+    FFT(a.data(), a.data(), a.size());
+}
 
-    std::vector<FieldT> c(big_m, FieldT::zero());
-    std::vector<FieldT> d(big_m, FieldT::zero());
+template<typename FieldT>
+void step_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a)
+{
+    iFFT(a.data(), a.data(), a.size());
+}
 
-    FieldT omega_i = FieldT::one();
-    for (size_t i = 0; i < big_m; ++i)
-    {
-        c[i] = (i < small_m ? a[i] + a[i+big_m] : a[i]);
-        d[i] = omega_i * (i < small_m ? a[i] - a[i+big_m] : a[i]);
-        omega_i *= omega;
-    }
+template<typename FieldT>
+void step_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    cosetFFT(a.data(), a.data(), a.size(), g);
+}
+
+template<typename FieldT>
+void step_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
+{
+    icosetFFT(a.data(), a.data(), a.size(), g);
+}
+
+template<typename FieldT>
+void step_radix2_domain<FieldT>::FFT(const FieldT *in, FieldT *out, const size_t n)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::FFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("step_radix2: expected a.size() == this->m");
+
+    /*
+     out[0..big_m) takes c[i] = a[i] + a[i+big_m] (or a[i] past small_m), and
+     out[big_m..m) takes e[i] = sum_j d[i + j*small_m], where d[i] = omega^i (a[i] - a[i+big_m])
+     (or omega^i a[i] past small_m). Only the first small_m entries of c differ from a.
+     */
+    if (in != out) std::copy(in + small_m, in + big_m, out + small_m);
 
-    std::vector<FieldT> e(small_m, FieldT::zero());
     const size_t compr = ((size_t)1) <<(libff::log2(big_m) - libff::log2(small_m));
+    const FieldT omega_small_m = omega^small_m;
+    FieldT omega_i = FieldT::one();
     for (size_t i = 0; i < small_m; ++i)
     {
-        for (size_t j = 0; j < compr; ++j)
+        const FieldT x = in[i];
+        const FieldT y = in[i+big_m];
+
+        FieldT e = omega_i * (x - y);
+        FieldT omega_ij = omega_i * omega_small_m;
+        for (size_t j = 1; j < compr; ++j)
         {
-            e[i] += d[i + j * small_m];
+            e += omega_ij * in[i + j * small_m];
+            omega_ij *= omega_small_m;
         }
-    }
-
-    _basic_radix2_FFT(c, omega.squared());
-    _basic_radix2_FFT(e, libff::get_root_of_unity<FieldT>(small_m));
 
-    for (size_t i = 0; i < big_m; ++i)
-    {
-        a[i] = c[i];
+        out[i] = x + y;
+        out[i+big_m] = e;
+        omega_i *= omega;
     }
 
-    for (size_t i = 0; i < small_m; ++i)
-    {
-        a[i+big_m] = e[i];
-    }
+    _basic_radix2_FFT(out, big_m, omega.squared(), std::vector<FieldT>());
+    _basic_radix2_FFT(out + big_m, small_m, libff::get_root_of_unity<FieldT>(small_m), std::vector<FieldT>());
 }
 
 template<typename FieldT>
-void step_radix2_domain<FieldT>::iFFT(std::vector<FieldT> &a)
+void step_radix2_domain<FieldT>::iFFT(const FieldT *in, FieldT *out, const size_t n)
 {
-    if (a.size() != this->m) throw DomainSizeException("step_radix2: expected a.size() == this->m");
-
-    std::vector<FieldT> U0(a.begin(), a.begin() + big_m);
-    std::vector<FieldT> U1(a.begin() + big_m, a.end());
-
-    _basic_radix2_FFT(U0, omega.squared().inverse());
-    _basic_radix2_FFT(U1, libff::get_root_of_unity<FieldT>(small_m).inverse());
-
-    const FieldT U0_size_inv = FieldT(big_m).inverse();
-    for (size_t i = 0; i < big_m; ++i)
-    {
-        U0[i] *= U0_size_inv;
-    }
-
-    const FieldT U1_size_inv = FieldT(small_m).inverse();
-    for (size_t i = 0; i < small_m; ++i)
-    {
-        U1[i] *= U1_size_inv;
-    }
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::iFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (n != this->m) throw DomainSizeException("step_radix2: expected a.size() == this->m");
 
-    std::vector<FieldT> tmp = U0;
-    FieldT omega_i = FieldT::one();
-    for (size_t i = 0; i < big_m; ++i)
-    {
-        tmp[i] *= omega_i;
-        omega_i *= omega;
-    }
+    if (in != out) std::copy(in, in + n, out);
 
-    // save A_suffix
-    for (size_t i = small_m; i < big_m; ++i)
-    {
-        a[i] = U0[i];
-    }
+    /* U0 = out[0..big_m) and U1 = out[big_m..m) */
+    _basic_radix2_FFT_scaled(out, big_m, omega.squared().inverse(), std::vector<FieldT>(),
+                             std::vector<FieldT>(), FieldT(big_m).inverse(), std::vector<FieldT>());
+    _basic_radix2_FFT_scaled(out + big_m, small_m, libff::get_root_of_unity<FieldT>(small_m).inverse(), std::vector<FieldT>(),
+                             std::vector<FieldT>(), FieldT(small_m).inverse(), std::vector<FieldT>());
 
+    /* A_suffix is already in place, as U0[small_m..big_m) */
     const size_t compr = ((size_t)1) <<(libff::log2(big_m) - libff::log2(small_m));
+    const FieldT omega_small_m = omega^small_m;
+    const FieldT omega_inv = omega.inverse();
+    const FieldT over_two = FieldT(2).inverse();
+    FieldT omega_i = FieldT::one();
+    FieldT omega_inv_i = FieldT::one();
     for (size_t i = 0; i < small_m; ++i)
     {
+        FieldT U1 = out[big_m + i];
+        FieldT omega_ij = omega_i * omega_small_m;
         for (size_t j = 1; j < compr; ++j)
         {
-            U1[i] -= tmp[i + j * small_m];
+            U1 -= omega_ij * out[i + j * small_m];
+            omega_ij *= omega_small_m;
         }
-    }
+        U1 *= omega_inv_i;
 
-    const FieldT omega_inv = omega.inverse();
-    FieldT omega_inv_i = FieldT::one();
-    for (size_t i = 0; i < small_m; ++i)
-    {
-        U1[i] *= omega_inv_i;
-        omega_inv_i *= omega_inv;
-    }
+        // compute A_prefix and B2
+        const FieldT U0 = out[i];
+        out[i] = (U0 + U1) * over_two;
+        out[big_m + i] = (U0 - U1) * over_two;
 
-    // compute A_prefix
-    const FieldT over_two = FieldT(2).inverse();
-    for (size_t i = 0; i < small_m; ++i)
-    {
-        a[i] = (U0[i]+U1[i]) * over_two;
-    }
-
-    // compute B2
-    for (size_t i = 0; i < small_m; ++i)
-    {
-        a[big_m + i] = (U0[i]-U1[i]) * over_two;
+        omega_i *= omega;
+        omega_inv_i *= omega_inv;
     }
 }
 
 template<typename FieldT>
-void step_radix2_domain<FieldT>::cosetFFT(std::vector<FieldT> &a, const FieldT &g)
+void step_radix2_domain<FieldT>::cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
 {
-    _multiply_by_coset(a, g);
-    FFT(a);
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::cosetFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    if (in != out) std::copy(in, in + n, out);
+    _multiply_by_coset(out, n, g);
+    FFT(out, out, n);
 }
 
 template<typename FieldT>
-void step_radix2_domain<FieldT>::icosetFFT(std::vector<FieldT> &a, const FieldT &g)
+void step_radix2_domain<FieldT>::icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
 {
-    iFFT(a);
-    _multiply_by_coset(a, g.inverse());
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::icosetFFT");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    iFFT(in, out, n);
+    _multiply_by_coset(out, n, g.inverse());
 }
 
 template<typename FieldT>
 std::vector<FieldT> step_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t)
 {
-    std::vector<FieldT> inner_big = _basic_radix2_evaluate_all_lagrange_polynomials(big_m, t);
-    std::vector<FieldT> inner_small = _basic_radix2_evaluate_all_lagrange_polynomials(small_m, t * omega.inverse());
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::evaluate_all_lagrange_polynomials");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    std::vector<FieldT> u(this->m);
+    LIBFQFFT_COUNT_ALLOCATION(this->m * sizeof(FieldT));
+    evaluate_lagrange_rows(&t, 1, u.data());
+    return u;
+}
 
-    std::vector<FieldT> result(this->m, FieldT::zero());
+template<typename FieldT>
+void step_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::evaluate_all_lagrange_polynomials");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    evaluate_lagrange_rows(&t, 1, out);
+}
 
-    const FieldT L0 = (t^small_m)-(omega^small_m);
-    const FieldT omega_to_small_m = omega^small_m;
-    const FieldT big_omega_to_small_m = big_omega ^ small_m;
-    FieldT elt = FieldT::one();
-    for (size_t i = 0; i < big_m; ++i)
-    {
-        result[i] = inner_big[i] * L0 * (elt - omega_to_small_m).inverse();
-        elt *= big_omega_to_small_m;
-    }
+template<typename FieldT>
+void step_radix2_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out)
+{
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::evaluate_all_lagrange_polynomials_batch");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
+    evaluate_lagrange_rows(ts.data(), ts.size(), out);
+}
+
+/*
+ The domain is (big_omega^i)_{i < big_m} followed by (omega * small_omega^i)_{i < small_m}, the
+ roots of z^{big_m} - 1 and of z^{small_m} - omega^{small_m}, so that the weights v_i = 1 / Z'(x_i) are
+ x_i / (big_m * (x_i^{small_m} - omega^{small_m})) for the former, and
+ x_i / (small_m * omega^{small_m} * (omega^{big_m} - 1)) for the latter.
+ */
+template<typename FieldT>
+void step_radix2_domain<FieldT>::precompute_lagrange()
+{
+    std::call_once(lagrange_flag, [this]() {
+            std::vector<FieldT> points(this->m), weights(this->m);
+            const FieldT omega_to_small_m = omega^small_m;
+            const FieldT big_omega_to_small_m = big_omega^small_m;
+
+            FieldT x = FieldT::one(), x_to_small_m = FieldT::one();
+            for (size_t i = 0; i < big_m; ++i)
+            {
+                points[i] = x;
+                weights[i] = FieldT(big_m) * (x_to_small_m - omega_to_small_m);
+                x *= big_omega;
+                x_to_small_m *= big_omega_to_small_m;
+            }
+            batch_inversion(weights.data(), big_m);
+            for (size_t i = 0; i < big_m; ++i)
+            {
+                weights[i] *= points[i];
+            }
+
+            const FieldT small_scale = (FieldT(small_m) * omega_to_small_m * ((omega^big_m) - FieldT::one())).inverse();
+            x = omega;
+            for (size_t i = 0; i < small_m; ++i)
+            {
+                points[big_m + i] = x;
+                weights[big_m + i] = small_scale * x;
+                x *= small_omega;
+            }
+
+            lagrange_points.swap(points);
+            lagrange_weights.swap(weights);
+        });
+}
 
-    const FieldT L1 = ((t^big_m)-FieldT::one()) * ((omega^big_m) - FieldT::one()).inverse();
+template<typename FieldT>
+void step_radix2_domain<FieldT>::evaluate_lagrange_rows(const FieldT *ts, const size_t k, FieldT *out)
+{
+    precompute_lagrange();
 
-    for (size_t i = 0; i < small_m; ++i)
+    std::vector<FieldT> Z(k);
+    for (size_t j = 0; j < k; ++j)
     {
-        result[big_m + i] = L1 * inner_small[i];
+        Z[j] = compute_vanishing_polynomial(ts[j]);
     }
-
-    return result;
+    _barycentric_lagrange_evaluation<FieldT>(this->m, lagrange_points.data(), FieldT::one(),
+                                             lagrange_weights.data(), FieldT::one(), ts, k, Z.data(), out);
 }
 
 template<typename FieldT>
@@ -243,6 +308,8 @@ FieldT step_radix2_domain<FieldT>::compute_vanishing_polynomial(const FieldT &t)
 template<typename FieldT>
 void step_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<FieldT> &H)
 {
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::add_poly_Z");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
     libff::enter_block("step_radix2_domain::add_poly_Z");
     if (H.size() != this->m+1) throw DomainSizeException("step_radix2: expected H.size() == this->m+1");
 
@@ -259,6 +326,8 @@ void step_radix2_domain<FieldT>::add_poly_Z(const FieldT &coeff, std::vector<Fie
 template<typename FieldT>
 void step_radix2_domain<FieldT>::divide_by_Z_on_coset(std::vector<FieldT> &P)
 {
+    LIBFQFFT_INSTRUMENT_SCOPE("step_radix2_domain::divide_by_Z_on_coset");
+    const execution_scope policy_scope(this->execution, this->execution_max_threads);
     // (c^{2^k}-1) * (c^{2^r} * w^{2^{r+1}*i) - w^{2^r})
     const FieldT coset = FieldT::multiplicative_generator;
 
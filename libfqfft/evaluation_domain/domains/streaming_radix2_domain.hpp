@@ -0,0 +1,144 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for the "streaming radix-2" evaluation domain.
+
+ This is the domain of basic_radix2_domain (the m-th roots of unity, for m = 2^k),
+ for vectors too large to be held in memory: the transforms go through an
+ fft_storage (e.g. a file) in a few passes, each of which holds at most a given
+ number of bytes of the vector in memory at a time.
+
+ The transforms use the four-step decomposition of an FFT of size m = R * C [Bailey 90,
+ FFTs in External or Hierarchical Memory]: viewing the vector as R rows of C elements,
+ 1. the C columns go through FFTs of size R, and are multiplied by twiddle factors;
+ 2. the R rows go through FFTs of size C;
+ 3. the matrix is transposed, which yields the output in natural order.
+ Steps 1 and 3 go through panels of consecutive columns (reading or writing one run of
+ consecutive elements per row), and step 2 through blocks of consecutive rows, so every
+ access to the storage is a run of consecutive elements. The sub-FFTs run in memory
+ through the kernels of basic_radix2_domain_aux.hpp.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef STREAMING_RADIX2_DOMAIN_HPP_
+#define STREAMING_RADIX2_DOMAIN_HPP_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace libfqfft {
+
+/**
+ * A vector of field elements that the streaming transforms read and write in runs
+ * of consecutive elements.
+ */
+template<typename FieldT>
+class fft_storage {
+public:
+
+    virtual ~fft_storage() {}
+
+    virtual size_t size() const = 0;
+
+    /**
+     * Copy the n elements starting at index offset to out, or from in.
+     */
+    virtual void read(const size_t offset, FieldT *out, const size_t n) = 0;
+    virtual void write(const size_t offset, const FieldT *in, const size_t n) = 0;
+};
+
+/**
+ * The n elements starting at a, which the storage does not own (e.g. a memory-mapped
+ * file, which then gets paged in and out as the passes go).
+ */
+template<typename FieldT>
+class memory_fft_storage : public fft_storage<FieldT> {
+public:
+
+    memory_fft_storage(FieldT *a, const size_t n);
+    memory_fft_storage(std::vector<FieldT> &a);
+
+    size_t size() const;
+    void read(const size_t offset, FieldT *out, const size_t n);
+    void write(const size_t offset, const FieldT *in, const size_t n);
+
+private:
+
+    FieldT *elements;
+    size_t length;
+};
+
+/**
+ * The n elements held as raw bytes in a file, starting at the given byte offset (e.g.
+ * offset = sizeof(binary_vector_header) for a record written by write_binary without
+ * checksum, see binary_serialization.hpp). The file is created if it does not exist.
+ * A file that cannot be opened, read or written throws a SerializationException.
+ */
+template<typename FieldT>
+class file_fft_storage : public fft_storage<FieldT> {
+public:
+
+    file_fft_storage(const std::string &path, const size_t n, const size_t offset = 0);
+
+    size_t size() const;
+    void read(const size_t offset, FieldT *out, const size_t n);
+    void write(const size_t offset, const FieldT *in, const size_t n);
+
+private:
+
+    std::fstream file;
+    size_t length;
+    size_t byte_offset;
+};
+
+template<typename FieldT>
+class streaming_radix2_domain {
+public:
+
+    const size_t m;
+    FieldT omega;
+
+    /**
+     * A domain of size m whose transforms hold at most memory_budget bytes of the vector
+     * in memory at a time (besides a twiddle table of max(R, C) elements). The budget must
+     * cover two rows and two columns, i.e. 2 * max(R, C) elements, where R = 2^ceil(k/2)
+     * and C = m / R; otherwise an InvalidSizeException is thrown.
+     */
+    streaming_radix2_domain(const size_t m, const size_t memory_budget);
+
+    /**
+     * Transform the m elements of a in place, using scratch (of m elements too) for the
+     * intermediate results.
+     */
+    void FFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch);
+    void iFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch);
+    void cosetFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const FieldT &g);
+    void icosetFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const FieldT &g);
+
+    size_t num_rows() const;
+    size_t num_columns() const;
+
+private:
+
+    size_t R;
+    size_t C;
+    size_t panel_width;
+    size_t row_block;
+    std::vector<FieldT> twiddles;
+    std::vector<FieldT> inverse_twiddles;
+
+    /* out[k] = out_scale * out_g^k * sum_i a[i] * in_g^i * w^{ik}, with w = omega or omega^{-1} */
+    void transform(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const bool inverse,
+                   const FieldT &in_g, const FieldT &out_scale, const FieldT &out_g);
+};
+
+} // libfqfft
+
+#include <libfqfft/evaluation_domain/domains/streaming_radix2_domain.tcc>
+
+#endif // STREAMING_RADIX2_DOMAIN_HPP_
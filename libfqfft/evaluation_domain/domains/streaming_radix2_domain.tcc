@@ -0,0 +1,275 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for the "streaming radix-2" evaluation domain.
+
+ See streaming_radix2_domain.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef STREAMING_RADIX2_DOMAIN_TCC_
+#define STREAMING_RADIX2_DOMAIN_TCC_
+
+#include <algorithm>
+
+#include <libff/algebra/fields/field_utils.hpp>
+#include <libff/common/double.hpp>
+#include <libff/common/utils.hpp>
+
+#include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
+namespace libfqfft {
+
+template<typename FieldT>
+memory_fft_storage<FieldT>::memory_fft_storage(FieldT *a, const size_t n) : elements(a), length(n)
+{
+}
+
+template<typename FieldT>
+memory_fft_storage<FieldT>::memory_fft_storage(std::vector<FieldT> &a) : elements(a.data()), length(a.size())
+{
+}
+
+template<typename FieldT>
+size_t memory_fft_storage<FieldT>::size() const
+{
+    return length;
+}
+
+template<typename FieldT>
+void memory_fft_storage<FieldT>::read(const size_t offset, FieldT *out, const size_t n)
+{
+    std::copy(elements + offset, elements + offset + n, out);
+}
+
+template<typename FieldT>
+void memory_fft_storage<FieldT>::write(const size_t offset, const FieldT *in, const size_t n)
+{
+    std::copy(in, in + n, elements + offset);
+}
+
+template<typename FieldT>
+file_fft_storage<FieldT>::file_fft_storage(const std::string &path, const size_t n, const size_t offset) :
+    length(n), byte_offset(offset)
+{
+    file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        /* Create the file, and reopen it for reading too */
+        std::ofstream(path.c_str(), std::ios::binary);
+        file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    }
+    if (!file.is_open()) throw SerializationException("file_fft_storage: cannot open " + path);
+}
+
+template<typename FieldT>
+size_t file_fft_storage<FieldT>::size() const
+{
+    return length;
+}
+
+template<typename FieldT>
+void file_fft_storage<FieldT>::read(const size_t offset, FieldT *out, const size_t n)
+{
+    file.seekg(byte_offset + offset * sizeof(FieldT));
+    file.read(reinterpret_cast<char*>(out), n * sizeof(FieldT));
+    if (!file) throw SerializationException("file_fft_storage: read failed");
+}
+
+template<typename FieldT>
+void file_fft_storage<FieldT>::write(const size_t offset, const FieldT *in, const size_t n)
+{
+    file.seekp(byte_offset + offset * sizeof(FieldT));
+    file.write(reinterpret_cast<const char*>(in), n * sizeof(FieldT));
+    if (!file) throw SerializationException("file_fft_storage: write failed");
+}
+
+template<typename FieldT>
+streaming_radix2_domain<FieldT>::streaming_radix2_domain(const size_t m, const size_t memory_budget) : m(m)
+{
+    if (m <= 1) throw InvalidSizeException("streaming_radix2(): expected m > 1");
+
+    const size_t logm = libff::log2(m);
+    if (m != ((size_t)1 << logm)) throw DomainSizeException("streaming_radix2(): expected m to be a power of 2");
+    if (!std::is_same<FieldT, libff::Double>::value)
+    {
+        if (logm > (FieldT::s)) throw DomainSizeException("streaming_radix2(): expected logm <= FieldT::s");
+    }
+
+    bool success;
+    omega = libff::get_root_of_unity2<FieldT>(m, &success);
+    if (!success) throw DomainSizeException("libff::get_root_of_unity2 invalid argument");
+
+    /* R >= C, so that the tables of the size-R FFTs over omega^C also serve the size-C FFTs over omega^R */
+    R = (size_t)1 << ((logm + 1) / 2);
+    C = m / R;
+
+    /* A panel of columns takes two buffers of R * panel_width elements (read and transposed),
+       a block of rows one buffer of row_block * C elements, besides the one for the
+       transposed columns (which stays allocated), within the budget too */
+    const size_t budget = memory_budget / sizeof(FieldT);
+    if (budget < 2 * R) throw InvalidSizeException("streaming_radix2(): expected memory_budget to cover 2 * max(R, C) elements");
+    panel_width = std::min(C, budget / (2 * R));
+    row_block = std::min(R, (budget - R * panel_width) / C);
+
+    const size_t logR = libff::log2(R);
+    twiddles = _basic_radix2_twiddle_table(R, omega^C, logR);
+    inverse_twiddles = _basic_radix2_twiddle_table(R, omega.inverse()^C, logR);
+}
+
+template<typename FieldT>
+size_t streaming_radix2_domain<FieldT>::num_rows() const
+{
+    return R;
+}
+
+template<typename FieldT>
+size_t streaming_radix2_domain<FieldT>::num_columns() const
+{
+    return C;
+}
+
+template<typename FieldT>
+void streaming_radix2_domain<FieldT>::FFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch)
+{
+    transform(a, scratch, false, FieldT::one(), FieldT::one(), FieldT::one());
+}
+
+template<typename FieldT>
+void streaming_radix2_domain<FieldT>::iFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch)
+{
+    transform(a, scratch, true, FieldT::one(), FieldT(m).inverse(), FieldT::one());
+}
+
+template<typename FieldT>
+void streaming_radix2_domain<FieldT>::cosetFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const FieldT &g)
+{
+    transform(a, scratch, false, g, FieldT::one(), FieldT::one());
+}
+
+template<typename FieldT>
+void streaming_radix2_domain<FieldT>::icosetFFT(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const FieldT &g)
+{
+    transform(a, scratch, true, FieldT::one(), FieldT(m).inverse(), g.inverse());
+}
+
+template<typename FieldT>
+void streaming_radix2_domain<FieldT>::transform(fft_storage<FieldT> &a, fft_storage<FieldT> &scratch, const bool inverse,
+                                                const FieldT &in_g, const FieldT &out_scale, const FieldT &out_g)
+{
+    if (a.size() != m) throw DomainSizeException("streaming_radix2: expected a.size() == this->m");
+    if (scratch.size() != m) throw DomainSizeException("streaming_radix2: expected scratch.size() == this->m");
+
+    const FieldT w = (inverse ? omega.inverse() : omega);
+    const FieldT w_R = w^C, w_C = w^R;
+    const std::vector<FieldT> &table = (inverse ? inverse_twiddles : twiddles);
+    const bool scale_in = !(in_g == FieldT::one());
+    const bool scale_out = !(out_g == FieldT::one()) || !(out_scale == FieldT::one());
+    const FieldT in_g_C = in_g^C, out_g_R = out_g^R;
+
+    std::vector<FieldT> buffer(std::max(R * panel_width, row_block * C));
+    std::vector<FieldT> columns(R * panel_width);
+
+    const size_t num_threads = execution_concurrency();
+
+    /* 1. Column FFTs of size R, times the twiddle factors w^{k1 * c}, from a to scratch */
+    for (size_t c0 = 0; c0 < C; c0 += panel_width)
+    {
+        const size_t width = std::min(panel_width, C - c0);
+        for (size_t r = 0; r < R; r++)
+        {
+            a.read(r * C + c0, &buffer[r * width], width);
+        }
+
+        parallel_for(width, [&](const size_t j) {
+                const size_t c = c0 + j;
+                FieldT *column = &columns[j * R];
+
+                FieldT p = (scale_in ? in_g^c : FieldT::one());
+                for (size_t r = 0; r < R; r++)
+                {
+                    column[r] = buffer[r * width + j];
+                    if (scale_in)
+                    {
+                        column[r] *= p;
+                        p *= in_g_C;
+                    }
+                }
+
+                _basic_radix2_FFT(column, R, w_R, table);
+
+                const FieldT t = w^c;
+                FieldT q = t;
+                for (size_t k1 = 1; k1 < R; k1++)
+                {
+                    column[k1] *= q;
+                    q *= t;
+                }
+            }, width >= num_threads);
+
+        parallel_for(R, [&](const size_t r) {
+                for (size_t j = 0; j < width; j++)
+                {
+                    buffer[r * width + j] = columns[j * R + r];
+                }
+            });
+
+        for (size_t r = 0; r < R; r++)
+        {
+            scratch.write(r * C + c0, &buffer[r * width], width);
+        }
+    }
+
+    /* 2. Row FFTs of size C, times out_scale * out_g^{k1 + R * k2}, in place in scratch */
+    for (size_t r0 = 0; r0 < R; r0 += row_block)
+    {
+        const size_t rows = std::min(row_block, R - r0);
+        scratch.read(r0 * C, buffer.data(), rows * C);
+
+        parallel_for(rows, [&](const size_t k) {
+                FieldT *row = &buffer[k * C];
+                _basic_radix2_FFT(row, C, w_C, table);
+
+                if (scale_out)
+                {
+                    FieldT p = out_scale * (out_g^(r0 + k));
+                    for (size_t k2 = 0; k2 < C; k2++)
+                    {
+                        row[k2] *= p;
+                        p *= out_g_R;
+                    }
+                }
+            }, rows >= num_threads);
+
+        scratch.write(r0 * C, buffer.data(), rows * C);
+    }
+
+    /* 3. Transpose, from scratch to a: output k1 + R * k2 is at row k1, column k2 */
+    for (size_t c0 = 0; c0 < C; c0 += panel_width)
+    {
+        const size_t width = std::min(panel_width, C - c0);
+        for (size_t r = 0; r < R; r++)
+        {
+            scratch.read(r * C + c0, &buffer[r * width], width);
+        }
+
+        parallel_for(width, [&](const size_t j) {
+                for (size_t r = 0; r < R; r++)
+                {
+                    columns[j * R + r] = buffer[r * width + j];
+                }
+            });
+
+        a.write(c0 * R, columns.data(), width * R);
+    }
+}
+
+} // libfqfft
+
+#endif // STREAMING_RADIX2_DOMAIN_TCC_
@@ -26,8 +26,12 @@
 #ifndef EVALUATION_DOMAIN_HPP_
 #define EVALUATION_DOMAIN_HPP_
 
+#include <future>
+#include <memory>
 #include <vector>
 
+#include <libfqfft/tools/execution_policy.hpp>
+
 namespace libfqfft {
 
 /**
@@ -44,7 +48,7 @@ public:
      *
      * (See the function get_evaluation_domain below.)
      */
-    evaluation_domain(const size_t m) : m(m) {};
+    evaluation_domain(const size_t m) : m(m), execution_max_threads(0) {};
 
     /**
      * Get the idx-th element in S.
@@ -71,6 +75,43 @@ public:
      */
     virtual void icosetFFT(std::vector<FieldT> &a, const FieldT &g) = 0;
 
+    /**
+     * Out-of-place versions of FFT, iFFT, cosetFFT and icosetFFT on raw arrays of
+     * n == m elements, reading from in and writing to out (which may be equal).
+     *
+     * The radix-2 domains run these in place on out, without heap allocations;
+     * the defaults below go through a temporary vector.
+     */
+    virtual void FFT(const FieldT *in, FieldT *out, const size_t n);
+    virtual void iFFT(const FieldT *in, FieldT *out, const size_t n);
+    virtual void cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
+    virtual void icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g);
+
+    /**
+     * Compute the FFT, over the domain S, of each of the vectors in as.
+     *
+     * The batch variants are equivalent to calling the corresponding transform on
+     * each vector in turn (which is what the defaults below do), but domains may
+     * override them to share their precomputed data across the batch and to run
+     * the transforms concurrently when each one is too small to parallelize well.
+     */
+    virtual void FFT_batch(const std::vector<std::vector<FieldT>*> &as);
+
+    /**
+     * Compute the inverse FFT, over the domain S, of each of the vectors in as.
+     */
+    virtual void iFFT_batch(const std::vector<std::vector<FieldT>*> &as);
+
+    /**
+     * Compute the FFT, over the domain g*S, of each of the vectors in as.
+     */
+    virtual void cosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g);
+
+    /**
+     * Compute the inverse FFT, over the domain g*S, of each of the vectors in as.
+     */
+    virtual void icosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g);
+
     /**
      * Evaluate all Lagrange polynomials.
      *
@@ -82,6 +123,20 @@ public:
      */
     virtual std::vector<FieldT> evaluate_all_lagrange_polynomials(const FieldT &t) = 0;
 
+    /**
+     * Same as above, writing (b_{0},...,b_{m-1}) to out[0..m).
+     */
+    virtual void evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out);
+
+    /**
+     * Evaluate all Lagrange polynomials at each of the elements ts[j], writing the
+     * evaluations at ts[j] to out[j*m .. (j+1)*m).
+     *
+     * The default below evaluates each point in turn; the domains override it to share
+     * one batch inversion across all the points (and their cached barycentric weights).
+     */
+    virtual void evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out);
+
     /**
      * Evaluate the vanishing polynomial of S at the field element t.
      */
@@ -96,8 +151,42 @@ public:
      * Multiply by the evaluation, on a coset of S, of the inverse of the vanishing polynomial of S.
      */
     virtual void divide_by_Z_on_coset(std::vector<FieldT> &P) = 0;
+
+    /**
+     * Run the parallel loops of the methods of this domain through policy (or, if
+     * null, the policy of the calling thread), on at most max_threads threads (or, if
+     * 0, with no cap of the domain's own). A caller may still lower the cap of a call
+     * with an execution_scope of its own (see execution_policy.hpp).
+     *
+     * Domains that share a policy share its threads, so concurrent calls do not
+     * oversubscribe the cores.
+     */
+    void set_execution_policy(const std::shared_ptr<execution_policy> &policy, const size_t max_threads = 0);
+
+    /**
+     * Start FFT, iFFT, cosetFFT, icosetFFT or divide_by_Z_on_coset on a, through the
+     * execution policy of the domain (or, without one, through default_execution_pool(),
+     * see execution_async in execution_policy.hpp), and return at once. The future
+     * becomes ready once the call is done, or holds the exception it threw; until then,
+     * the domain and a must stay alive, and a untouched.
+     *
+     * Calls started this way run concurrently (sharing the threads of the policy);
+     * evaluation_pipeline (see evaluation_pipeline.hpp) chains dependent ones.
+     */
+    std::future<void> FFT_async(std::vector<FieldT> &a);
+    std::future<void> iFFT_async(std::vector<FieldT> &a);
+    std::future<void> cosetFFT_async(std::vector<FieldT> &a, const FieldT &g);
+    std::future<void> icosetFFT_async(std::vector<FieldT> &a, const FieldT &g);
+    std::future<void> divide_by_Z_on_coset_async(std::vector<FieldT> &a);
+
+protected:
+
+    std::shared_ptr<execution_policy> execution;
+    size_t execution_max_threads;
 };
 
 } // libfqfft
 
+#include <libfqfft/evaluation_domain/evaluation_domain.tcc>
+
 #endif // EVALUATION_DOMAIN_HPP_
@@ -0,0 +1,150 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of the default batch transforms and Lagrange evaluations, and of
+ the execution policy and the asynchronous calls of evaluation domains.
+
+ See evaluation_domain.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef EVALUATION_DOMAIN_TCC_
+#define EVALUATION_DOMAIN_TCC_
+
+#include <algorithm>
+
+namespace libfqfft {
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::FFT(const FieldT *in, FieldT *out, const size_t n)
+{
+    std::vector<FieldT> a(in, in + n);
+    this->FFT(a);
+    std::copy(a.begin(), a.end(), out);
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::iFFT(const FieldT *in, FieldT *out, const size_t n)
+{
+    std::vector<FieldT> a(in, in + n);
+    this->iFFT(a);
+    std::copy(a.begin(), a.end(), out);
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::cosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
+{
+    std::vector<FieldT> a(in, in + n);
+    this->cosetFFT(a, g);
+    std::copy(a.begin(), a.end(), out);
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::icosetFFT(const FieldT *in, FieldT *out, const size_t n, const FieldT &g)
+{
+    std::vector<FieldT> a(in, in + n);
+    this->icosetFFT(a, g);
+    std::copy(a.begin(), a.end(), out);
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::FFT_batch(const std::vector<std::vector<FieldT>*> &as)
+{
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        this->FFT(*as[i]);
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::iFFT_batch(const std::vector<std::vector<FieldT>*> &as)
+{
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        this->iFFT(*as[i]);
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::cosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g)
+{
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        this->cosetFFT(*as[i], g);
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::icosetFFT_batch(const std::vector<std::vector<FieldT>*> &as, const FieldT &g)
+{
+    for (size_t i = 0; i < as.size(); ++i)
+    {
+        this->icosetFFT(*as[i], g);
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::evaluate_all_lagrange_polynomials(const FieldT &t, FieldT *out)
+{
+    const std::vector<FieldT> u = this->evaluate_all_lagrange_polynomials(t);
+    std::copy(u.begin(), u.end(), out);
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::evaluate_all_lagrange_polynomials_batch(const std::vector<FieldT> &ts, FieldT *out)
+{
+    for (size_t j = 0; j < ts.size(); ++j)
+    {
+        this->evaluate_all_lagrange_polynomials(ts[j], out + j * this->m);
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain<FieldT>::set_execution_policy(const std::shared_ptr<execution_policy> &policy, const size_t max_threads)
+{
+    this->execution = policy;
+    this->execution_max_threads = max_threads;
+}
+
+template<typename FieldT>
+std::future<void> evaluation_domain<FieldT>::FFT_async(std::vector<FieldT> &a)
+{
+    std::vector<FieldT> *v = &a;
+    return execution_async(this->execution, [this, v]() { this->FFT(*v); });
+}
+
+template<typename FieldT>
+std::future<void> evaluation_domain<FieldT>::iFFT_async(std::vector<FieldT> &a)
+{
+    std::vector<FieldT> *v = &a;
+    return execution_async(this->execution, [this, v]() { this->iFFT(*v); });
+}
+
+template<typename FieldT>
+std::future<void> evaluation_domain<FieldT>::cosetFFT_async(std::vector<FieldT> &a, const FieldT &g)
+{
+    std::vector<FieldT> *v = &a;
+    return execution_async(this->execution, [this, v, g]() { this->cosetFFT(*v, g); });
+}
+
+template<typename FieldT>
+std::future<void> evaluation_domain<FieldT>::icosetFFT_async(std::vector<FieldT> &a, const FieldT &g)
+{
+    std::vector<FieldT> *v = &a;
+    return execution_async(this->execution, [this, v, g]() { this->icosetFFT(*v, g); });
+}
+
+template<typename FieldT>
+std::future<void> evaluation_domain<FieldT>::divide_by_Z_on_coset_async(std::vector<FieldT> &a)
+{
+    std::vector<FieldT> *v = &a;
+    return execution_async(this->execution, [this, v]() { this->divide_by_Z_on_coset(*v); });
+}
+
+} // libfqfft
+
+#endif // EVALUATION_DOMAIN_TCC_
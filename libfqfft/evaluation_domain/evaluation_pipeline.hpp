@@ -0,0 +1,91 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for pipelines of evaluation domain calls.
+
+ A pipeline is a graph of stages (transforms, or any other work, such as the
+ computation of H from the evaluations of A, B and C, or a multi-scalar
+ multiplication), each of which starts as soon as the stages it comes after are
+ done: independent stages run concurrently through the execution policy of the
+ pipeline, and a stage waits only for its own inputs, not for a barrier over all
+ the stages of the previous step.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef EVALUATION_PIPELINE_HPP_
+#define EVALUATION_PIPELINE_HPP_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <libfqfft/evaluation_domain/evaluation_domain.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
+namespace libfqfft {
+
+/**
+ * A graph of stages, run once by run().
+ *
+ * The stages run through policy (or, if null, through default_execution_pool()), and
+ * the transforms within a stage run with the execution policy of their domain, if any.
+ * The policy, and the domains and vectors of the stages, must stay alive until the
+ * future of run() is ready.
+ */
+template<typename FieldT>
+class evaluation_pipeline {
+public:
+
+    typedef size_t stage;
+
+    explicit evaluation_pipeline(const std::shared_ptr<execution_policy> &policy = std::shared_ptr<execution_policy>());
+
+    /**
+     * Add a stage for work, to start once the stages in after are done (which must
+     * have been added before), and return it. Throws std::logic_error if the stages
+     * in after are not earlier ones, or after run().
+     */
+    stage add(const std::function<void()> &work, const std::vector<stage> &after = std::vector<stage>());
+
+    /**
+     * Add a stage for the corresponding call of domain on a.
+     */
+    stage FFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a, const std::vector<stage> &after = std::vector<stage>());
+    stage iFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a, const std::vector<stage> &after = std::vector<stage>());
+    stage cosetFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a, const FieldT &g,
+                   const std::vector<stage> &after = std::vector<stage>());
+    stage icosetFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a, const FieldT &g,
+                    const std::vector<stage> &after = std::vector<stage>());
+    stage divide_by_Z_on_coset(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a,
+                               const std::vector<stage> &after = std::vector<stage>());
+
+    /**
+     * Start the stages, and return at once. The future becomes ready once all the
+     * stages are done, or holds the exception of the first stage that threw (whose
+     * later stages are then skipped). No stages may be added afterwards, and run()
+     * may be called once (std::logic_error otherwise).
+     */
+    std::future<void> run();
+
+private:
+
+    struct node;
+    struct graph;
+
+    std::shared_ptr<execution_policy> policy;
+    std::shared_ptr<graph> stages;
+
+    static void start(const std::shared_ptr<graph> &g, const stage s);
+    static void run_stage(const std::shared_ptr<graph> &g, stage s);
+};
+
+} // libfqfft
+
+#include <libfqfft/evaluation_domain/evaluation_pipeline.tcc>
+
+#endif // EVALUATION_PIPELINE_HPP_
@@ -0,0 +1,223 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for pipelines of evaluation domain calls.
+
+ See evaluation_pipeline.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef EVALUATION_PIPELINE_TCC_
+#define EVALUATION_PIPELINE_TCC_
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+namespace libfqfft {
+
+template<typename FieldT>
+struct evaluation_pipeline<FieldT>::node {
+    std::function<void()> work;
+    std::vector<stage> dependents;
+    /* The number of stages that this one comes after, and that are not done yet */
+    std::atomic<size_t> pending;
+
+    node() : pending(0) {}
+};
+
+template<typename FieldT>
+struct evaluation_pipeline<FieldT>::graph {
+    /* Not a reference of its own: the last one could otherwise go in a thread of the pool */
+    execution_policy *policy;
+    std::vector<std::unique_ptr<node> > nodes;
+    bool started;
+
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::promise<void> done;
+
+    graph() : policy(nullptr), started(false), remaining(0), failed(false) {}
+};
+
+template<typename FieldT>
+evaluation_pipeline<FieldT>::evaluation_pipeline(const std::shared_ptr<execution_policy> &policy) :
+    policy(policy), stages(new graph())
+{
+    stages->policy = policy.get();
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::add(const std::function<void()> &work,
+                                                                             const std::vector<stage> &after)
+{
+    if (stages->started) throw std::logic_error("evaluation_pipeline: expected no stages added after run()");
+
+    const stage s = stages->nodes.size();
+    for (size_t i = 0; i < after.size(); ++i)
+    {
+        if (after[i] >= s) throw std::logic_error("evaluation_pipeline: expected stages to come after earlier stages");
+    }
+
+    stages->nodes.push_back(std::unique_ptr<node>(new node()));
+    node &n = *stages->nodes.back();
+    n.work = work;
+    n.pending.store(after.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < after.size(); ++i)
+    {
+        stages->nodes[after[i]]->dependents.push_back(s);
+    }
+    return s;
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::FFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a,
+                                                                             const std::vector<stage> &after)
+{
+    evaluation_domain<FieldT> *d = &domain;
+    std::vector<FieldT> *v = &a;
+    return add([d, v]() { d->FFT(*v); }, after);
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::iFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a,
+                                                                              const std::vector<stage> &after)
+{
+    evaluation_domain<FieldT> *d = &domain;
+    std::vector<FieldT> *v = &a;
+    return add([d, v]() { d->iFFT(*v); }, after);
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::cosetFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a,
+                                                                                  const FieldT &g, const std::vector<stage> &after)
+{
+    evaluation_domain<FieldT> *d = &domain;
+    std::vector<FieldT> *v = &a;
+    return add([d, v, g]() { d->cosetFFT(*v, g); }, after);
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::icosetFFT(evaluation_domain<FieldT> &domain, std::vector<FieldT> &a,
+                                                                                   const FieldT &g, const std::vector<stage> &after)
+{
+    evaluation_domain<FieldT> *d = &domain;
+    std::vector<FieldT> *v = &a;
+    return add([d, v, g]() { d->icosetFFT(*v, g); }, after);
+}
+
+template<typename FieldT>
+typename evaluation_pipeline<FieldT>::stage evaluation_pipeline<FieldT>::divide_by_Z_on_coset(evaluation_domain<FieldT> &domain,
+                                                                                              std::vector<FieldT> &a,
+                                                                                              const std::vector<stage> &after)
+{
+    evaluation_domain<FieldT> *d = &domain;
+    std::vector<FieldT> *v = &a;
+    return add([d, v]() { d->divide_by_Z_on_coset(*v); }, after);
+}
+
+template<typename FieldT>
+void evaluation_pipeline<FieldT>::start(const std::shared_ptr<graph> &g, const stage s)
+{
+    const std::shared_ptr<graph> owner = g;
+    const std::function<void()> task = [owner, s]() { run_stage(owner, s); };
+    if (g->policy) g->policy->submit(task);
+    else default_execution_pool().submit(task);
+}
+
+/*
+ Run stage s, then start the stages that were waiting only for it: all but the first
+ through the policy, and the first in this thread, so that a chain of stages runs
+ without going back to the policy.
+ */
+template<typename FieldT>
+void evaluation_pipeline<FieldT>::run_stage(const std::shared_ptr<graph> &g, stage s)
+{
+    while (true)
+    {
+        node &n = *g->nodes[s];
+        if (!g->failed.load(std::memory_order_acquire))
+        {
+            try
+            {
+                const execution_scope scope(_execution_policy_reference(g->policy));
+                n.work();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(g->error_mutex);
+                if (!g->error) g->error = std::current_exception();
+                g->failed.store(true, std::memory_order_release);
+            }
+        }
+
+        bool has_next = false;
+        stage next = 0;
+        for (size_t i = 0; i < n.dependents.size(); ++i)
+        {
+            const stage d = n.dependents[i];
+            if (g->nodes[d]->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+
+            if (!has_next)
+            {
+                has_next = true;
+                next = d;
+            }
+            else
+            {
+                start(g, d);
+            }
+        }
+
+        /* The stages started above are not done yet, so this is not the last one when has_next */
+        if (g->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            if (g->error) g->done.set_exception(g->error);
+            else g->done.set_value();
+            return;
+        }
+
+        if (!has_next) return;
+        s = next;
+    }
+}
+
+template<typename FieldT>
+std::future<void> evaluation_pipeline<FieldT>::run()
+{
+    if (stages->started) throw std::logic_error("evaluation_pipeline: expected run() to be called once");
+    stages->started = true;
+
+    std::future<void> result = stages->done.get_future();
+    const size_t num_stages = stages->nodes.size();
+    if (num_stages == 0)
+    {
+        stages->done.set_value();
+        return result;
+    }
+
+    /* Collect the first stages before starting any, since those may complete (and start others) right away */
+    std::vector<stage> first;
+    for (stage s = 0; s < num_stages; ++s)
+    {
+        if (stages->nodes[s]->pending.load(std::memory_order_relaxed) == 0) first.push_back(s);
+    }
+
+    stages->remaining.store(num_stages, std::memory_order_release);
+    for (size_t i = 0; i < first.size(); ++i)
+    {
+        start(stages, first[i]);
+    }
+    return result;
+}
+
+} // libfqfft
+
+#endif // EVALUATION_PIPELINE_TCC_
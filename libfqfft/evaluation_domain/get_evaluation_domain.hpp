@@ -5,7 +5,8 @@
 
  Returns an evaluation domain object in which the domain S has size
  |S| >= min_size.
- The function chooses from different supported domains, depending on min_size.
+ The function chooses from different supported domains, depending on min_size,
+ and memoizes its results in a registry of shared domains.
 
  *****************************************************************************
  * @author     This file is part of libfqfft, developed by SCIPR Lab
@@ -16,15 +17,139 @@
 #ifndef GET_EVALUATION_DOMAIN_HPP_
 #define GET_EVALUATION_DOMAIN_HPP_
 
+#include <future>
+#include <istream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include <libfqfft/evaluation_domain/evaluation_domain.hpp>
 
 namespace libfqfft {
 
+/**
+ * The kinds of evaluation domains. With automatic, the kind is chosen from min_size as
+ * in get_evaluation_domain; otherwise only domains of the given kind are considered.
+ */
+enum class evaluation_domain_kind {
+    automatic,
+    basic_radix2,
+    extended_radix2,
+    step_radix2,
+    geometric_sequence,
+    arithmetic_sequence
+};
+
+/**
+ * Construct a new evaluation domain of the given kind and of size >= min_size
+ * (throws DomainSizeException if there is none). Unlike get_evaluation_domain,
+ * the result is not shared with other callers.
+ */
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > create_evaluation_domain(const size_t min_size,
+                                                                     const evaluation_domain_kind kind = evaluation_domain_kind::automatic);
+
+/**
+ * As above, but instead of doing its precomputation, the domain loads the one that
+ * save_precomputation wrote to precomputation for the same kind and size of domain, so
+ * that e.g. a prover starts without recomputing it. Throws a SerializationException if
+ * the saved tables do not match the domain, or if the domain (extended or step radix-2)
+ * has none.
+ */
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > create_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind,
+                                                                     std::istream &precomputation);
+
+/**
+ * A thread-safe memoizing registry of evaluation domains, keyed by FieldT and by the kind
+ * and size of the domain that (min_size, kind) resolves to, so that e.g. min_size 1000
+ * and 1024 share one domain.
+ *
+ * The registry returns the same domain object to every caller of a given key, with its
+ * precomputation (if any) already done. A domain is built without holding the lock of the
+ * registry, so lookups of other keys do not wait for it. Domains stay in the registry until
+ * clear() is called, and pinned domains stay even then.
+ */
+template<typename FieldT>
+class evaluation_domain_registry {
+public:
+
+    /**
+     * Get the domain for (min_size, kind), creating it on first use.
+     */
+    static std::shared_ptr<evaluation_domain<FieldT> > get(const size_t min_size,
+                                                          const evaluation_domain_kind kind = evaluation_domain_kind::automatic);
+
+    /**
+     * As above, but a domain created by this call loads its precomputation from
+     * precomputation, as in create_evaluation_domain (the stream is not read if the
+     * domain is already in the registry).
+     */
+    static std::shared_ptr<evaluation_domain<FieldT> > get(const size_t min_size, const evaluation_domain_kind kind,
+                                                          std::istream &precomputation);
+
+    /**
+     * Create the domains for all of min_sizes ahead of time (e.g. at startup), and pin them if requested.
+     */
+    static void prewarm(const std::vector<size_t> &min_sizes,
+                        const evaluation_domain_kind kind = evaluation_domain_kind::automatic,
+                        const bool pin = false);
+
+    /**
+     * Create the domain for (min_size, kind) if needed, and keep it across clear().
+     */
+    static void pin(const size_t min_size, const evaluation_domain_kind kind = evaluation_domain_kind::automatic);
+
+    /**
+     * Drop all domains that are not pinned (callers still holding them are unaffected),
+     * and forget which domain each (min_size, kind) resolved to.
+     */
+    static void clear();
+
+    /**
+     * The number of domains in the registry.
+     */
+    static size_t size();
+
+private:
+
+    typedef std::shared_ptr<evaluation_domain<FieldT> > domain_ptr;
+    /* (min_size, kind) as requested */
+    typedef std::pair<size_t, evaluation_domain_kind> request_type;
+    /* The kind and size of the domain */
+    typedef std::pair<evaluation_domain_kind, size_t> key_type;
+
+    struct entry {
+        std::shared_future<domain_ptr> domain;
+        bool pinned;
+        /* The promise of the caller that builds the domain */
+        const void *builder;
+    };
+
+    static std::mutex &registry_mutex();
+    static std::map<key_type, entry> &entries();
+    static std::map<request_type, key_type> &resolutions();
+    static std::shared_future<domain_ptr> get_entry(const size_t min_size, const evaluation_domain_kind kind, const bool pin,
+                                                    std::istream *precomputation);
+};
+
+/**
+ * Get the (shared) evaluation domain of size >= min_size from evaluation_domain_registry.
+ * Since the domain is shared, callers should not reconfigure it; use create_evaluation_domain
+ * for a private one.
+ */
 template<typename FieldT>
 std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size);
 
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind);
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind,
+                                                                  std::istream &precomputation);
+
 } // libfqfft
 
 #include <libfqfft/evaluation_domain/get_evaluation_domain.tcc>
@@ -19,7 +19,10 @@
 #ifndef GET_EVALUATION_DOMAIN_TCC_
 #define GET_EVALUATION_DOMAIN_TCC_
 
+#include <exception>
+
 #include <libff/common/profiling.hpp>
+#include <libff/common/utils.hpp>
 #include <libfqfft/evaluation_domain/domains/arithmetic_sequence_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/extended_radix2_domain.hpp>
@@ -30,24 +33,113 @@
 
 namespace libfqfft {
 
+/* Whether create_ptr of the domains of the given kind accepts m (see their supports) */
 template<typename FieldT>
-std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size)
+bool _evaluation_domain_supports(const evaluation_domain_kind kind, const size_t m)
 {
-    libff::enter_block("Call to get_evaluation_domain");
-    std::shared_ptr<evaluation_domain<FieldT> > result;
+    switch (kind)
+    {
+    case evaluation_domain_kind::basic_radix2:
+        return basic_radix2_domain<FieldT>::supports(m);
+    case evaluation_domain_kind::extended_radix2:
+        return extended_radix2_domain<FieldT>::supports(m);
+    case evaluation_domain_kind::step_radix2:
+        return step_radix2_domain<FieldT>::supports(m);
+    case evaluation_domain_kind::geometric_sequence:
+        return geometric_sequence_domain<FieldT>::supports(m);
+    case evaluation_domain_kind::arithmetic_sequence:
+        return arithmetic_sequence_domain<FieldT>::supports(m);
+    default:
+        return false;
+    }
+}
 
+/*
+ The kind and size of the domain chosen for (min_size, kind): the first radix-2 kind that
+ supports min_size, or else big + rounded_small, and otherwise a sequence domain of size
+ min_size.
+ */
+template<typename FieldT>
+std::pair<evaluation_domain_kind, size_t> _resolve_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind)
+{
     const size_t big = ((size_t)1) <<(libff::log2(min_size)-1);
     const size_t small = min_size - big;
     const size_t rounded_small = (((size_t)1) <<libff::log2(small));
 
-    result = basic_radix2_domain<FieldT>::create_ptr(min_size);
-    if (!result) result = extended_radix2_domain<FieldT>::create_ptr(min_size);
-    if (!result) result = step_radix2_domain<FieldT>::create_ptr(min_size);
-    if (!result) result = basic_radix2_domain<FieldT>::create_ptr(big + rounded_small);
-    if (!result) result = extended_radix2_domain<FieldT>::create_ptr(big + rounded_small);
-    if (!result) result = step_radix2_domain<FieldT>::create_ptr(big + rounded_small);
-    if (!result) result = geometric_sequence_domain<FieldT>::create_ptr(min_size);
-    if (!result) result = arithmetic_sequence_domain<FieldT>::create_ptr(min_size);
+    const bool any = (kind == evaluation_domain_kind::automatic);
+    const evaluation_domain_kind radix2_kinds[] = { evaluation_domain_kind::basic_radix2,
+                                                    evaluation_domain_kind::extended_radix2,
+                                                    evaluation_domain_kind::step_radix2 };
+    const size_t radix2_sizes[] = { min_size, big + rounded_small };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        for (size_t k = 0; k < 3; ++k)
+        {
+            if ((any || kind == radix2_kinds[k]) && _evaluation_domain_supports<FieldT>(radix2_kinds[k], radix2_sizes[s]))
+                return std::make_pair(radix2_kinds[k], radix2_sizes[s]);
+        }
+    }
+
+    const evaluation_domain_kind sequence_kinds[] = { evaluation_domain_kind::geometric_sequence,
+                                                      evaluation_domain_kind::arithmetic_sequence };
+    for (size_t k = 0; k < 2; ++k)
+    {
+        if ((any || kind == sequence_kinds[k]) && _evaluation_domain_supports<FieldT>(sequence_kinds[k], min_size))
+            return std::make_pair(sequence_kinds[k], min_size);
+    }
+
+    std::cerr << "oops: get_evaluation_domain: no matching domain " << min_size << "\n";
+    throw DomainSizeException("get_evaluation_domain: no matching domain");
+}
+
+/*
+ Construct the domain of the given (resolved) kind and size, with its lazy precomputation
+ done now, so that it can be shared, or else loaded from precomputation (if not null).
+ */
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > _build_evaluation_domain(const evaluation_domain_kind kind, const size_t m,
+                                                                     std::istream *precomputation)
+{
+    switch (kind)
+    {
+    case evaluation_domain_kind::basic_radix2:
+    {
+        std::shared_ptr<basic_radix2_domain<FieldT> > domain = basic_radix2_domain<FieldT>::create_ptr(m);
+        if (domain && precomputation) domain->load_precomputation(*precomputation);
+        return domain;
+    }
+    case evaluation_domain_kind::extended_radix2:
+    case evaluation_domain_kind::step_radix2:
+        if (precomputation) throw SerializationException("get_evaluation_domain: the extended and step radix-2 domains have no saved precomputation");
+        if (kind == evaluation_domain_kind::extended_radix2) return extended_radix2_domain<FieldT>::create_ptr(m);
+        return step_radix2_domain<FieldT>::create_ptr(m);
+    case evaluation_domain_kind::geometric_sequence:
+    {
+        std::shared_ptr<geometric_sequence_domain<FieldT> > domain = geometric_sequence_domain<FieldT>::create_ptr(m);
+        if (domain && precomputation) domain->load_precomputation(*precomputation);
+        else if (domain) domain->precompute();
+        return domain;
+    }
+    case evaluation_domain_kind::arithmetic_sequence:
+    {
+        std::shared_ptr<arithmetic_sequence_domain<FieldT> > domain = arithmetic_sequence_domain<FieldT>::create_ptr(m);
+        if (domain && precomputation) domain->load_precomputation(*precomputation);
+        else if (domain) domain->precompute();
+        return domain;
+    }
+    default:
+        return std::shared_ptr<evaluation_domain<FieldT> >();
+    }
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > _create_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind,
+                                                                      std::istream *precomputation)
+{
+    libff::enter_block("Call to create_evaluation_domain");
+
+    const std::pair<evaluation_domain_kind, size_t> resolved = _resolve_evaluation_domain<FieldT>(min_size, kind);
+    std::shared_ptr<evaluation_domain<FieldT> > result = _build_evaluation_domain<FieldT>(resolved.first, resolved.second, precomputation);
 
     if (!result) {
       std::cerr << "oops: get_evaluation_domain: no matching domain " << min_size << "\n";
@@ -58,7 +150,7 @@ std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t m
       std::cout << "get_evaluation_domain(" << min_size << ")"
                 << " " << result->m << "\n";
     }
-    libff::leave_block("Call to get_evaluation_domain");
+    libff::leave_block("Call to create_evaluation_domain");
 
     return result;
 
@@ -76,6 +168,184 @@ std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t m
 #endif
 }
 
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > create_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind)
+{
+    return _create_evaluation_domain<FieldT>(min_size, kind, nullptr);
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > create_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind,
+                                                                     std::istream &precomputation)
+{
+    return _create_evaluation_domain<FieldT>(min_size, kind, &precomputation);
+}
+
+/*
+ The state of the registry is never destroyed, so that the tasks that the default pool
+ still runs at exit (which may be created before the registry) can use it.
+ */
+template<typename FieldT>
+std::mutex &evaluation_domain_registry<FieldT>::registry_mutex()
+{
+    static std::mutex *mutex = new std::mutex();
+    return *mutex;
+}
+
+template<typename FieldT>
+std::map<typename evaluation_domain_registry<FieldT>::key_type, typename evaluation_domain_registry<FieldT>::entry> &
+evaluation_domain_registry<FieldT>::entries()
+{
+    static std::map<key_type, entry> *entries = new std::map<key_type, entry>();
+    return *entries;
+}
+
+template<typename FieldT>
+std::map<typename evaluation_domain_registry<FieldT>::request_type, typename evaluation_domain_registry<FieldT>::key_type> &
+evaluation_domain_registry<FieldT>::resolutions()
+{
+    static std::map<request_type, key_type> *resolutions = new std::map<request_type, key_type>();
+    return *resolutions;
+}
+
+/*
+ Find or add the entry for (min_size, kind), and pin it if requested. The lock is only
+ held to look up and update the maps: the first caller of a key builds the domain after
+ releasing it, and the others wait on the future of the entry, so that hits never wait
+ for the precomputation of other domains, and concurrent first uses of a key build it once.
+ */
+template<typename FieldT>
+std::shared_future<typename evaluation_domain_registry<FieldT>::domain_ptr>
+evaluation_domain_registry<FieldT>::get_entry(const size_t min_size, const evaluation_domain_kind kind, const bool pin,
+                                              std::istream *precomputation)
+{
+    const request_type request(min_size, kind);
+    key_type key;
+    bool resolved = false;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        typename std::map<request_type, key_type>::const_iterator r = resolutions().find(request);
+        if (r != resolutions().end())
+        {
+            key = r->second;
+            resolved = true;
+        }
+    }
+    if (!resolved) key = _resolve_evaluation_domain<FieldT>(min_size, kind);
+
+    std::shared_ptr<std::promise<domain_ptr> > builder;
+    std::shared_future<domain_ptr> result;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        resolutions()[request] = key;
+
+        typename std::map<key_type, entry>::iterator it = entries().find(key);
+        if (it == entries().end())
+        {
+            builder.reset(new std::promise<domain_ptr>());
+            entry e;
+            e.domain = builder->get_future().share();
+            e.pinned = false;
+            e.builder = builder.get();
+            it = entries().insert(std::make_pair(key, e)).first;
+        }
+        it->second.pinned = it->second.pinned || pin;
+        result = it->second.domain;
+    }
+
+    if (builder)
+    {
+        try
+        {
+            domain_ptr domain = _create_evaluation_domain<FieldT>(key.second, key.first, precomputation);
+            builder->set_value(domain);
+        }
+        catch (...)
+        {
+            /* Let a later call try again */
+            {
+                std::lock_guard<std::mutex> lock(registry_mutex());
+                typename std::map<key_type, entry>::iterator it = entries().find(key);
+                if (it != entries().end() && it->second.builder == builder.get()) entries().erase(it);
+            }
+            builder->set_exception(std::current_exception());
+        }
+    }
+
+    return result;
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > evaluation_domain_registry<FieldT>::get(const size_t min_size, const evaluation_domain_kind kind)
+{
+    return get_entry(min_size, kind, false, nullptr).get();
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > evaluation_domain_registry<FieldT>::get(const size_t min_size, const evaluation_domain_kind kind,
+                                                                                  std::istream &precomputation)
+{
+    return get_entry(min_size, kind, false, &precomputation).get();
+}
+
+template<typename FieldT>
+void evaluation_domain_registry<FieldT>::prewarm(const std::vector<size_t> &min_sizes, const evaluation_domain_kind kind, const bool pin)
+{
+    for (size_t i = 0; i < min_sizes.size(); ++i)
+    {
+        get_entry(min_sizes[i], kind, pin, nullptr).get();
+    }
+}
+
+template<typename FieldT>
+void evaluation_domain_registry<FieldT>::pin(const size_t min_size, const evaluation_domain_kind kind)
+{
+    get_entry(min_size, kind, true, nullptr).get();
+}
+
+template<typename FieldT>
+void evaluation_domain_registry<FieldT>::clear()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    typename std::map<key_type, entry>::iterator it = entries().begin();
+    while (it != entries().end())
+    {
+        if (it->second.pinned)
+            ++it;
+        else
+            entries().erase(it++);
+    }
+
+    /* The resolved requests too (those of the pinned domains resolve to them again) */
+    resolutions().clear();
+}
+
+template<typename FieldT>
+size_t evaluation_domain_registry<FieldT>::size()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    return entries().size();
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size)
+{
+    return evaluation_domain_registry<FieldT>::get(min_size);
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind)
+{
+    return evaluation_domain_registry<FieldT>::get(min_size, kind);
+}
+
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_evaluation_domain(const size_t min_size, const evaluation_domain_kind kind,
+                                                                  std::istream &precomputation)
+{
+    return evaluation_domain_registry<FieldT>::get(min_size, kind, precomputation);
+}
+
 } // libfqfft
 
 #endif // GET_EVALUATION_DOMAIN_TCC_
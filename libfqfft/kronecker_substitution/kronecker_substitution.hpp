@@ -14,6 +14,8 @@
 
 #include <vector>
 
+#include <libfqfft/tools/field_traits.hpp>
+
 namespace libfqfft {
 
 /**
@@ -22,6 +24,15 @@ namespace libfqfft {
  * The implementation makes use of
  * [Harvey 07, Multipoint Kronecker Substitution, Section 2.1] and
  * [Gathen and Gerhard, Modern Computer Algebra 3rd Ed., Section 8.4].
+ *
+ * For prime fields (see is_prime_field), each coefficient is packed by its canonical
+ * representative into a slot of whole limbs, wide enough for the coefficients of the
+ * product over the integers, and each slot of the product is reduced modulo the field
+ * characteristic. Under MULTICORE, the packing and the reductions are split across threads.
+ * The product is a single GMP multiplication (a squaring when V1 and V2 are the same vector).
+ *
+ * For other types (libff::Double), the coefficients are packed through as_ulong(), which is
+ * only correct for small non-negative integer coefficients.
  */
 template<typename FieldT>
 void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &v1, const std::vector<FieldT> &v2);
@@ -20,13 +20,16 @@
 #include <gmp.h>
 #include <libff/common/utils.hpp>
 
+#include <libfqfft/tools/elementwise_operations.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
 namespace libfqfft {
 
 template<typename FieldT>
-void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &v1, const std::vector<FieldT> &v2)
+void _kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &v1, const std::vector<FieldT> &v2, std::false_type)
 {
     /* Initialize */
-    bool square = (v1 == v2) ? 1 : 0;
+    const bool square = (&v1 == &v2);
 
     /* Polynomial length */
     size_t n1 = v1.size();
@@ -46,12 +49,11 @@ void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &
     v3.resize(n3, FieldT::zero());
 
     /*
-     * Allocate all MP_LIMB_T space once and store the reference pointer M1
-     * to free memory afterwards. P1, P2, and P3 will remain fixed pointers
+     * Allocate all MP_LIMB_T space once. P1, P2, and P3 will remain fixed pointers
      * to the start of their respective polynomials as reference.
      */
-    mp_limb_t* m1 = (mp_limb_t*) malloc (sizeof (mp_limb_t) * 2 * (k1 + k2));
-    mp_limb_t* p1 = m1;
+    std::vector<mp_limb_t> m1(2 * (k1 + k2));
+    mp_limb_t* p1 = m1.data();
     mp_limb_t* p2 = p1 + k1;
     mp_limb_t* p3 = p2 + k2;
 
@@ -117,7 +119,8 @@ void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &
     }
 
     /* Multiply P1 and P2 limbs and store result in P3 limb. */
-    mpn_mul (p3, p1, k1, p2, k2);
+    if (square) mpn_sqr (p3, p1, k1);
+    else mpn_mul (p3, p1, k1, p2, k2);
 
     /* Perfect alignment case: bits B is equivalent to GMP_LIMB_BITS */
     if (b == GMP_LIMB_BITS) for (size_t i = 0; i < n3; i++) v3[i] = FieldT(*p3++);
@@ -163,12 +166,90 @@ void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &
         }
     }
 
-    /* Free memory */
-    free (m1);
+    _condense(v3);
+}
+
+/*
+ Write the canonical representative of each coefficient of V to its own slot of S limbs
+ (the slots must be zero beforehand).
+ */
+template<typename FieldT>
+void _kronecker_pack(mp_limb_t *p, const std::vector<FieldT> &v, const size_t s)
+{
+    typedef decltype(FieldT::field_char()) bigint_t;
+    const size_t limbs = std::min((size_t)bigint_t::N, s);
+
+    parallel_for(v.size(), [&](const size_t i) {
+            const bigint_t x = v[i].as_bigint();
+            std::copy(x.data, x.data + limbs, p + i * s);
+        }, _elementwise_parallel(v.size()));
+}
+
+template<typename FieldT>
+void _kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &v1, const std::vector<FieldT> &v2, std::true_type)
+{
+    typedef decltype(FieldT::field_char()) bigint_t;
+
+    const size_t n1 = v1.size();
+    const size_t n2 = v2.size();
+    if (n1 == 0 || n2 == 0)
+    {
+        v3.clear();
+        return;
+    }
+    const size_t n3 = n1 + n2 - 1;
+    const bool square = (&v1 == &v2);
+
+    const bigint_t modulus = FieldT::field_char();
+    mp_size_t modulus_limbs = bigint_t::N;
+    while (modulus_limbs > 1 && modulus.data[modulus_limbs - 1] == 0) --modulus_limbs;
+
+    /*
+     * Each coefficient of the product over the integers is a sum of at most min(n1, n2)
+     * products of representatives below p, and so has fewer than b bits; slots of s limbs
+     * keep them apart, and let the threads pack and unpack slots independently.
+     */
+    const size_t b = 2 * modulus.num_bits() + libff::log2(std::min(n1, n2));
+    const size_t s = libff::div_ceil(b, GMP_NUMB_BITS);
+
+    /* Pack both inputs before V3 is touched, since V3 may be V1 or V2 */
+    std::vector<mp_limb_t> p1(n1 * s, 0);
+    std::vector<mp_limb_t> p2(square ? 0 : n2 * s, 0);
+    std::vector<mp_limb_t> p3((n1 + n2) * s);
+    _kronecker_pack(p1.data(), v1, s);
+    if (!square) _kronecker_pack(p2.data(), v2, s);
+
+    if (square) mpn_sqr(p3.data(), p1.data(), n1 * s);
+    else if (n1 >= n2) mpn_mul(p3.data(), p1.data(), n1 * s, p2.data(), n2 * s);
+    else mpn_mul(p3.data(), p2.data(), n2 * s, p1.data(), n1 * s);
+
+    /* Reduce each slot modulo p */
+    v3.resize(n3);
+    const size_t num_chunks = (_elementwise_parallel(n3) ? std::min(execution_concurrency(), n3) : 1);
+    parallel_for(num_chunks, [&](const size_t c) {
+            std::vector<mp_limb_t> quotient(s + 1);
+            for (size_t i = c * n3 / num_chunks; i < (c + 1) * n3 / num_chunks; i++)
+            {
+                const mp_limb_t *slot = p3.data() + i * s;
+                mp_size_t slot_limbs = s;
+                while (slot_limbs > 0 && slot[slot_limbs - 1] == 0) --slot_limbs;
+
+                bigint_t r;
+                if (slot_limbs < modulus_limbs) std::copy(slot, slot + slot_limbs, r.data);
+                else mpn_tdiv_qr(quotient.data(), r.data, 0, slot, slot_limbs, modulus.data, modulus_limbs);
+                v3[i] = FieldT(r);
+            }
+        });
 
     _condense(v3);
 }
 
+template<typename FieldT>
+void kronecker_substitution(std::vector<FieldT> &v3, const std::vector<FieldT> &v1, const std::vector<FieldT> &v2)
+{
+    _kronecker_substitution(v3, v1, v2, std::integral_constant<bool, is_prime_field<FieldT>::value>());
+}
+
 } // libfqfft
 
 #endif // KRONECKER_SUBSTITUTION_TCC_
@@ -15,6 +15,8 @@
 
 #include <vector>
 
+#include <libfqfft/polynomial_arithmetic/pretransformed_operand.hpp>
+
 namespace libfqfft {
 
 /**
@@ -51,18 +53,90 @@ void _polynomial_addition(std::vector<FieldT> &c, const std::vector<FieldT> &a,
 template<typename FieldT>
 void _polynomial_subtraction(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
 
+/**
+ * Computes polynomial A + polynomial B, and stores the result in polynomial A.
+ */
+template<typename FieldT>
+void _polynomial_addition_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Computes polynomial A - polynomial B, and stores the result in polynomial A.
+ */
+template<typename FieldT>
+void _polynomial_subtraction_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Computes polynomial A * polynomial B, and stores the result in polynomial A (whose storage is
+ * reused for the transform of A).
+ */
+template<typename FieldT>
+void _polynomial_multiplication_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Multiplies each coefficient of polynomial A by S.
+ */
+template<typename FieldT>
+void _polynomial_scale_in_place(std::vector<FieldT> &a, const FieldT &s);
+
 /**
  * Perform the multiplication of two polynomials, polynomial A * polynomial B, and stores result in polynomial C.
+ * This picks, by the sizes of A and B, schoolbook multiplication, Kronecker substitution (over
+ * prime fields, see is_prime_field), Karatsuba/Toom-3 or FFT; the crossovers
+ * are the LIBFQFFT_*_THRESHOLD macros of basic_operations.tcc .
  */
 template<typename FieldT>
 void _polynomial_multiplication(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
 
+/**
+ * Perform the multiplication of two polynomials, polynomial A * polynomial B, by schoolbook multiplication,
+ * in O(a.size() * b.size()) operations, and stores result in polynomial C.
+ */
+template<typename FieldT>
+void _polynomial_multiplication_on_schoolbook(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Perform the multiplication of two polynomials, polynomial A * polynomial B, by Karatsuba multiplication,
+ * and stores result in polynomial C. The longer operand is split in blocks of the size of the shorter one;
+ * the products within recurse as _polynomial_multiplication does (schoolbook, Karatsuba or Toom-3).
+ */
+template<typename FieldT>
+void _polynomial_multiplication_on_karatsuba(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Same as above, with a Toom-3 step at the top (which needs 2 and 3 to be invertible).
+ */
+template<typename FieldT>
+void _polynomial_multiplication_on_toom3(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
 /**
  * Perform the multiplication of two polynomials, polynomial A * polynomial B, using FFT, and stores result in polynomial C.
  */
 template<typename FieldT>
 void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
 
+/**
+ * Same as above, using the caller-supplied scratch buffer (whose contents are overwritten)
+ * as the only temporary, so that repeated multiplications of similar sizes reuse its storage
+ * and that of C instead of allocating.
+ */
+template<typename FieldT>
+void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &scratch);
+
+/**
+ * Same as above, with polynomial A held in evaluation form: one forward transform (of B) and one
+ * inverse transform per product. Requires a.size() + b.size() - 1 <= a.transform_size().
+ */
+template<typename FieldT>
+void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const pretransformed_operand<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Compute the square of polynomial A, and store the result in polynomial C (which may be A),
+ * with one forward and one inverse FFT. _polynomial_multiplication and
+ * _polynomial_multiplication_on_fft take this path when A and B are the same vector.
+ */
+template<typename FieldT>
+void _polynomial_squaring(std::vector<FieldT> &c, const std::vector<FieldT> &a);
+
 /**
  * Perform the multiplication of two polynomials, polynomial A * polynomial B, using Kronecker Substitution, and stores result in polynomial C.
  */
@@ -78,13 +152,48 @@ template<typename FieldT>
 std::vector<FieldT> _polynomial_multiplication_transpose(const size_t &n, const std::vector<FieldT> &a, const std::vector<FieldT> &c);
 
 /**
- * Perform the standard Euclidean Division algorithm.
+ * Same as above, storing the n + 1 coefficients of the result in vector R (which may be A or C).
+ *
+ * The result is the middle slice, [m - 1, m + n - 1], of rev(A) * C (for m = a.size()), which is
+ * computed by a cyclic convolution of size next_pow2(max(c.size(), m + n)): the coefficients
+ * that wrap around land outside of the slice. The full product would need a transform of
+ * size next_pow2(m + c.size() - 1).
+ */
+template<typename FieldT>
+void _polynomial_multiplication_transpose(std::vector<FieldT> &r, const size_t &n, const std::vector<FieldT> &a, const std::vector<FieldT> &c);
+
+/**
+ * Compute the power series inverse of polynomial F modulo x^n, by Newton iteration, and store it in polynomial G.
+ * Requires F(0) != 0.
+ */
+template<typename FieldT>
+void _polynomial_inverse_power_series(std::vector<FieldT> &g, const std::vector<FieldT> &f, const size_t n);
+
+/**
+ * Perform the division of polynomial A by polynomial B.
  * Input: Polynomial A, Polynomial B, where A / B
  * Output: Polynomial Q, Polynomial R, such that A = (Q * B) + R.
+ * Dispatches to _polynomial_division_newton when both the divisor and the quotient
+ * have at least LIBFQFFT_NEWTON_DIVISION_THRESHOLD coefficients, and to
+ * _polynomial_division_euclidean otherwise.
  */
 template<typename FieldT>
 void _polynomial_division(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
 
+/**
+ * Perform the standard Euclidean Division algorithm, in O(deg(Q) * deg(B)) operations.
+ */
+template<typename FieldT>
+void _polynomial_division_euclidean(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
+/**
+ * Perform the division through the power series inverse of the reversal of B, in O(M(deg(A)))
+ * operations (where M(n) is the cost of multiplying polynomials of degree n):
+ * rev(Q) = rev(A) * rev(B)^{-1} mod x^{deg(A) - deg(B) + 1}, and R = A - Q * B.
+ */
+template<typename FieldT>
+void _polynomial_division_newton(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b);
+
 } // libfqfft
 
 #include <libfqfft/polynomial_arithmetic/basic_operations.tcc>
@@ -15,13 +15,43 @@
 #define BASIC_OPERATIONS_TCC_
 
 #include <algorithm>
-#include <functional>
+#include <type_traits>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
 #include <libfqfft/kronecker_substitution/kronecker_substitution.hpp>
+#include <libfqfft/tools/elementwise_operations.hpp>
 #include <libfqfft/tools/exceptions.hpp>
 
-#ifdef MULTICORE
-#include <omp.h>
+/*
+ Dividing by a polynomial with fewer coefficients than this, or with a quotient
+ with fewer coefficients than this, uses the Euclidean division.
+ */
+#ifndef LIBFQFFT_NEWTON_DIVISION_THRESHOLD
+#define LIBFQFFT_NEWTON_DIVISION_THRESHOLD ((size_t)512)
+#endif
+
+/*
+ _polynomial_multiplication uses schoolbook multiplication when the shorter operand has fewer
+ than LIBFQFFT_KARATSUBA_THRESHOLD coefficients; otherwise, Kronecker substitution (over prime
+ fields) for products of at most LIBFQFFT_KRONECKER_THRESHOLD coefficients, then Karatsuba and
+ Toom-3 for products of at most LIBFQFFT_FFT_MULTIPLICATION_THRESHOLD coefficients, and FFT
+ beyond. Within Karatsuba and Toom-3, the balanced products of fewer than
+ LIBFQFFT_KARATSUBA_THRESHOLD coefficients use schoolbook multiplication, and those of at
+ least LIBFQFFT_TOOM3_THRESHOLD coefficients a Toom-3 step rather than a Karatsuba step.
+ */
+#ifndef LIBFQFFT_KARATSUBA_THRESHOLD
+#define LIBFQFFT_KARATSUBA_THRESHOLD ((size_t)32)
+#endif
+
+#ifndef LIBFQFFT_TOOM3_THRESHOLD
+#define LIBFQFFT_TOOM3_THRESHOLD ((size_t)128)
+#endif
+
+#ifndef LIBFQFFT_FFT_MULTIPLICATION_THRESHOLD
+#define LIBFQFFT_FFT_MULTIPLICATION_THRESHOLD ((size_t)512)
+#endif
+
+#ifndef LIBFQFFT_KRONECKER_THRESHOLD
+#define LIBFQFFT_KRONECKER_THRESHOLD ((size_t)512)
 #endif
 
 namespace libfqfft {
@@ -29,7 +59,8 @@ namespace libfqfft {
 template<typename FieldT>
 bool _is_zero(const std::vector<FieldT> &a)
 {
-    return std::all_of(a.begin(), a.end(), [](FieldT i) { return i == FieldT::zero(); });
+    const FieldT zero = FieldT::zero();
+    return std::all_of(a.begin(), a.end(), [&zero](const FieldT &i) { return i == zero; });
 }
 
 template<typename FieldT>
@@ -49,106 +80,393 @@ void _reverse(std::vector<FieldT> &a, const size_t n)
 template<typename FieldT>
 void _polynomial_addition(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
 {
-    if (_is_zero(a))
-    {
-        c = b;
-    }
-    else if (_is_zero(b))
+    const std::vector<FieldT> &longer = (a.size() >= b.size() ? a : b);
+    const std::vector<FieldT> &shorter = (a.size() >= b.size() ? b : a);
+    const size_t short_size = shorter.size();
+
+    /* Either of A and B may be C, so the inputs are only read after C is resized */
+    c.resize(longer.size());
+    elementwise_addition(c.data(), shorter.data(), longer.data(), short_size);
+    if (&c != &longer) std::copy(longer.begin() + short_size, longer.end(), c.begin() + short_size);
+
+    _condense(c);
+}
+
+template<typename FieldT>
+void _polynomial_subtraction(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    const size_t a_size = a.size();
+    const size_t b_size = b.size();
+
+    /* Either of A and B may be C, so the inputs are only read after C is resized */
+    c.resize(std::max(a_size, b_size));
+    if (a_size > b_size)
     {
-        c = a;
+        elementwise_subtraction(c.data(), a.data(), b.data(), b_size);
+        if (&c != &a) std::copy(a.begin() + b_size, a.end(), c.begin() + b_size);
     }
     else
     {
-        size_t a_size = a.size();
-        size_t b_size = b.size();
+        elementwise_subtraction(c.data(), a.data(), b.data(), a_size);
+        elementwise_negation(c.data() + a_size, b.data() + a_size, b_size - a_size);
+    }
+
+    _condense(c);
+}
 
-        if (a_size > b_size)
+template<typename FieldT>
+void _polynomial_addition_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    _polynomial_addition(a, a, b);
+}
+
+template<typename FieldT>
+void _polynomial_subtraction_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    _polynomial_subtraction(a, a, b);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_in_place(std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    _polynomial_multiplication(a, a, b);
+}
+
+template<typename FieldT>
+void _polynomial_scale_in_place(std::vector<FieldT> &a, const FieldT &s)
+{
+    elementwise_scale(a.data(), a.data(), s, a.size());
+    _condense(a);
+}
+
+/* out[0, na + nb - 1) = a * b; out must not overlap the inputs */
+template<typename FieldT>
+void _schoolbook_multiplication(FieldT *out, const FieldT *a, const size_t na, const FieldT *b, const size_t nb)
+{
+    std::fill(out, out + na + nb - 1, FieldT::zero());
+    for (size_t i = 0; i < na; i++)
+    {
+        for (size_t j = 0; j < nb; j++)
         {
-            c.resize(a_size);
-            std::transform(b.begin(), b.end(), a.begin(), c.begin(), std::plus<FieldT>());
-            std::copy(a.begin() + b_size, a.end(), c.begin() + b_size);
+            out[i + j] += a[i] * b[j];
         }
-        else
+    }
+}
+
+template<typename FieldT>
+void _balanced_multiplication(FieldT *out, const FieldT *a, const FieldT *b, const size_t n, const FieldT &half, const FieldT &third);
+
+/*
+ out[0, 2n - 1) = a * b, for a and b of n coefficients, by one Karatsuba step:
+ with a = a0 + x^h a1 and b = b0 + x^h b1, a * b = z0 + x^h ((a0 + a1)(b0 + b1) - z0 - z2) + x^{2h} z2,
+ where z0 = a0 * b0 and z2 = a1 * b1.
+ */
+template<typename FieldT>
+void _karatsuba_multiplication(FieldT *out, const FieldT *a, const FieldT *b, const size_t n, const FieldT &half, const FieldT &third)
+{
+    const size_t h = n / 2, H = n - h;
+
+    std::vector<FieldT> sa(H), sb(H), z1(2 * H - 1);
+    elementwise_addition(sa.data(), a, a + h, h);
+    elementwise_addition(sb.data(), b, b + h, h);
+    if (H > h)
+    {
+        sa[h] = a[2 * h];
+        sb[h] = b[2 * h];
+    }
+
+    /* z0 and z2 go straight to their place in out, with the one coefficient between them cleared */
+    _balanced_multiplication(out, a, b, h, half, third);
+    out[2 * h - 1] = FieldT::zero();
+    _balanced_multiplication(out + 2 * h, a + h, b + h, H, half, third);
+    _balanced_multiplication(z1.data(), sa.data(), sb.data(), H, half, third);
+
+    elementwise_subtraction(z1.data(), z1.data(), out, 2 * h - 1);
+    elementwise_subtraction(z1.data(), z1.data(), out + 2 * h, 2 * H - 1);
+    elementwise_addition(out + h, out + h, z1.data(), 2 * H - 1);
+}
+
+/*
+ out[0, 2n - 1) = a * b, for a and b of n >= 5 coefficients, by one Toom-3 step: each operand is
+ split in three parts of k, k and l = n - 2k coefficients, evaluated at 0, 1, -1, -2 and infinity,
+ and the five products are interpolated with the sequence of
+ [Bodrato and Zanoni 2007. Integer and Polynomial Multiplication: Towards Optimal Toom-Cook Matrices].
+ HALF and THIRD are the inverses of 2 and 3.
+ */
+template<typename FieldT>
+void _toom3_multiplication(FieldT *out, const FieldT *a, const FieldT *b, const size_t n, const FieldT &half, const FieldT &third)
+{
+    const size_t k = (n + 2) / 3, l = n - 2 * k;
+    const size_t r = 2 * k - 1;
+
+    /* The evaluations at 1, -1 and -2 of a, then of b */
+    std::vector<FieldT> e(6 * k);
+    FieldT *p[2] = { e.data(), e.data() + 3 * k };
+    const FieldT *x[2] = { a, b };
+    for (size_t s = 0; s < 2; s++)
+    {
+        for (size_t i = 0; i < k; i++)
         {
-            c.resize(b_size);
-            std::transform(a.begin(), a.end(), b.begin(), c.begin(), std::plus<FieldT>());
-            std::copy(b.begin() + a_size, b.end(), c.begin() + a_size);
+            const FieldT &x0 = x[s][i], &x1 = x[s][k + i];
+            const FieldT x2 = (i < l ? x[s][2 * k + i] : FieldT::zero());
+            const FieldT t = x0 + x2;
+            p[s][i] = t + x1;
+            p[s][k + i] = t - x1;
+            const FieldT u = p[s][k + i] + x2;
+            p[s][2 * k + i] = u + u - x0;
         }
     }
-        
-    _condense(c);
+
+    /* r(0), r(1), r(-1), r(-2) and r(infinity) (the latter with l coefficients per operand) */
+    std::vector<FieldT> v(5 * r, FieldT::zero());
+    FieldT *r0 = v.data(), *r1 = r0 + r, *rm1 = r1 + r, *rm2 = rm1 + r, *rinf = rm2 + r;
+    _balanced_multiplication(r0, a, b, k, half, third);
+    _balanced_multiplication(r1, p[0], p[1], k, half, third);
+    _balanced_multiplication(rm1, p[0] + k, p[1] + k, k, half, third);
+    _balanced_multiplication(rm2, p[0] + 2 * k, p[1] + 2 * k, k, half, third);
+    _balanced_multiplication(rinf, a + 2 * k, b + 2 * k, l, half, third);
+
+    /* Interpolation: afterwards, a * b = r0 + x^k r1 + x^{2k} rm1 + x^{3k} rm2 + x^{4k} rinf */
+    for (size_t i = 0; i < r; i++)
+    {
+        FieldT t3 = (rm2[i] - r1[i]) * third;
+        const FieldT t1 = (r1[i] - rm1[i]) * half;
+        FieldT t2 = rm1[i] - r0[i];
+        t3 = (t2 - t3) * half + rinf[i] + rinf[i];
+        t2 = t2 + t1 - rinf[i];
+        r1[i] = t1 - t3;
+        rm1[i] = t2;
+        rm2[i] = t3;
+    }
+
+    /* The terms overlap; those of x^{3k} rm2 past the degree of the product are zero */
+    const size_t size = 2 * n - 1;
+    std::fill(out, out + size, FieldT::zero());
+    std::copy(r0, r0 + r, out);
+    for (size_t i = 0; i < r; i++) out[k + i] += r1[i];
+    for (size_t i = 0; i < r && 2 * k + i < size; i++) out[2 * k + i] += rm1[i];
+    for (size_t i = 0; i < r && 3 * k + i < size; i++) out[3 * k + i] += rm2[i];
+    for (size_t i = 0; i + 1 < 2 * l; i++) out[4 * k + i] += rinf[i];
 }
 
 template<typename FieldT>
-void _polynomial_subtraction(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+void _balanced_multiplication(FieldT *out, const FieldT *a, const FieldT *b, const size_t n, const FieldT &half, const FieldT &third)
 {
-    if (_is_zero(b))
+    /* (Karatsuba needs 2 coefficients, and Toom-3 5) */
+    if (n < std::max(LIBFQFFT_KARATSUBA_THRESHOLD, (size_t)2))
     {
-        c = a;
+        _schoolbook_multiplication(out, a, n, b, n);
     }
-    else if (_is_zero(a))
+    else if (n < std::max(LIBFQFFT_TOOM3_THRESHOLD, (size_t)5))
     {
-        c.resize(b.size());
-        std::transform(b.begin(), b.end(), c.begin(), std::negate<FieldT>());
+        _karatsuba_multiplication(out, a, b, n, half, third);
     }
     else
     {
-        size_t a_size = a.size();
-        size_t b_size = b.size();
-        
-        if (a_size > b_size)
-        {
-            c.resize(a_size);
-            std::transform(a.begin(), a.begin() + b_size, b.begin(), c.begin(), std::minus<FieldT>());
-            std::copy(a.begin() + b_size, a.end(), c.begin() + b_size);
-        }
-        else
-        {
-            c.resize(b_size);
-            std::transform(a.begin(), a.end(), b.begin(), c.begin(), std::minus<FieldT>());
-            std::transform(b.begin() + a_size, b.end(), c.begin() + a_size, std::negate<FieldT>());
-        }
+        _toom3_multiplication(out, a, b, n, half, third);
     }
+}
 
-    _condense(c);
+/*
+ c = a * b, by splitting the longer operand in blocks of the length of the shorter one,
+ with STEP (one of the above) for each balanced product.
+ */
+template<typename FieldT, typename Step>
+void _blocked_multiplication(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b, Step step, const bool toom3_step)
+{
+    if (a.empty() || b.empty())
+    {
+        c.clear();
+        return;
+    }
+
+    const std::vector<FieldT> &x = (a.size() >= b.size() ? a : b);
+    const std::vector<FieldT> &y = (a.size() >= b.size() ? b : a);
+    const size_t n = y.size();
+    const size_t num_blocks = libff::div_ceil(x.size(), n);
+
+    /* The inverses are only needed (and only computed) for Toom-3 steps */
+    FieldT half = FieldT::one(), third = FieldT::one();
+    if (n >= 5 && (toom3_step || n >= LIBFQFFT_TOOM3_THRESHOLD))
+    {
+        half = (FieldT::one() + FieldT::one()).inverse();
+        third = (FieldT::one() + FieldT::one() + FieldT::one()).inverse();
+    }
+
+    /* The last block of X is padded with zeros */
+    std::vector<FieldT> result((num_blocks + 1) * n, FieldT::zero());
+    std::vector<FieldT> block(n), product(2 * n - 1);
+    for (size_t i = 0; i < num_blocks; i++)
+    {
+        const size_t len = std::min(n, x.size() - i * n);
+        std::copy(x.begin() + i * n, x.begin() + i * n + len, block.begin());
+        std::fill(block.begin() + len, block.end(), FieldT::zero());
+
+        step(product.data(), block.data(), y.data(), n, half, third);
+        elementwise_addition(result.data() + i * n, result.data() + i * n, product.data(), 2 * n - 1);
+    }
+
+    result.resize(a.size() + b.size() - 1);
+    _condense(result);
+    c.swap(result);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_on_schoolbook(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    if (a.empty() || b.empty())
+    {
+        c.clear();
+        return;
+    }
+
+    std::vector<FieldT> result(a.size() + b.size() - 1);
+    _schoolbook_multiplication(result.data(), a.data(), a.size(), b.data(), b.size());
+    _condense(result);
+    c.swap(result);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_on_karatsuba(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    _blocked_multiplication(c, a, b, [](FieldT *out, const FieldT *x, const FieldT *y, const size_t n, const FieldT &half, const FieldT &third)
+    {
+        if (n < 2) _schoolbook_multiplication(out, x, n, y, n);
+        else _karatsuba_multiplication(out, x, y, n, half, third);
+    }, false);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_on_toom3(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    _blocked_multiplication(c, a, b, [](FieldT *out, const FieldT *x, const FieldT *y, const size_t n, const FieldT &half, const FieldT &third)
+    {
+        if (n < 5) _schoolbook_multiplication(out, x, n, y, n);
+        else _toom3_multiplication(out, x, y, n, half, third);
+    }, true);
+}
+
+/* Kronecker substitution, for the fields that it can pack (see is_prime_field) */
+template<typename FieldT>
+bool _polynomial_multiplication_try_kronecker(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::true_type)
+{
+    if (a.size() + b.size() - 1 > LIBFQFFT_KRONECKER_THRESHOLD) return false;
+
+    _polynomial_multiplication_on_kronecker(c, a, b);
+    return true;
+}
+
+template<typename FieldT>
+bool _polynomial_multiplication_try_kronecker(std::vector<FieldT> &, const std::vector<FieldT> &, const std::vector<FieldT> &, std::false_type)
+{
+    return false;
 }
 
 template<typename FieldT>
 void _polynomial_multiplication(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
 {
-    _polynomial_multiplication_on_fft(c, a, b);
+    if (a.empty() || b.empty())
+    {
+        c.clear();
+        return;
+    }
+
+    const size_t n = std::min(a.size(), b.size());
+    const size_t size = a.size() + b.size() - 1;
+
+    if (n < LIBFQFFT_KARATSUBA_THRESHOLD)
+    {
+        _polynomial_multiplication_on_schoolbook(c, a, b);
+    }
+    else if (!_polynomial_multiplication_try_kronecker(c, a, b, std::integral_constant<bool, is_prime_field<FieldT>::value>()))
+    {
+        if (size <= LIBFQFFT_FFT_MULTIPLICATION_THRESHOLD) _blocked_multiplication(c, a, b, _balanced_multiplication<FieldT>, false);
+        else _polynomial_multiplication_on_fft(c, a, b);
+    }
 }
 
 template<typename FieldT>
 void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
 {
+    std::vector<FieldT> scratch;
+    _polynomial_multiplication_on_fft(c, a, b, scratch);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &scratch)
+{
+    if (&a == &b)
+    {
+        _polynomial_squaring(c, a);
+        return;
+    }
+
     const size_t n = libff::get_power_of_two(a.size() + b.size() - 1);
     FieldT omega = libff::get_root_of_unity<FieldT>(n);
 
-    std::vector<FieldT> u(a);
-    std::vector<FieldT> v(b);
-    u.resize(n, FieldT::zero());
-    v.resize(n, FieldT::zero());
+    /* Transform B in the scratch buffer and A in C (either of A and B may be C) */
+    scratch.assign(b.begin(), b.end());
+    scratch.resize(n, FieldT::zero());
+    if (&c != &a) c.assign(a.begin(), a.end());
     c.resize(n, FieldT::zero());
 
-#ifdef MULTICORE
-    _basic_parallel_radix2_FFT(u, omega);
-    _basic_parallel_radix2_FFT(v, omega);
-#else
-    _basic_serial_radix2_FFT(u, omega);
-    _basic_serial_radix2_FFT(v, omega);
-#endif
+    /* The pointwise product does not care about the order of the evaluations */
+    _basic_radix2_FFT_bitreversed_output(c, omega);
+    _basic_radix2_FFT_bitreversed_output(scratch, omega);
 
-    std::transform(u.begin(), u.end(), v.begin(), c.begin(), std::multiplies<FieldT>());
+    elementwise_multiplication(c.data(), c.data(), scratch.data(), n);
 
-#ifdef MULTICORE
-    _basic_parallel_radix2_FFT(c, omega.inverse());
-#else
-    _basic_serial_radix2_FFT(c, omega.inverse());
-#endif
+    _basic_radix2_FFT_bitreversed_input(c, omega.inverse());
+
+    const FieldT sconst = FieldT(n).inverse();
+    elementwise_scale(c.data(), c.data(), sconst, n);
+    _condense(c);
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_on_fft(std::vector<FieldT> &c, const pretransformed_operand<FieldT> &a, const std::vector<FieldT> &b)
+{
+    if (a.size() == 0 || b.empty())
+    {
+        c.clear();
+        return;
+    }
+
+    const size_t n = a.transform_size();
+    if (a.size() + b.size() - 1 > n) throw InvalidSizeException("expected a.size() + b.size() - 1 <= a.transform_size()");
+
+    /* The transform of B goes in C (B may be C) */
+    if (&c != &b) c.assign(b.begin(), b.end());
+    c.resize(n, FieldT::zero());
+
+    _basic_radix2_FFT_bitreversed_output(c, a.omega());
+    elementwise_multiplication(c.data(), c.data(), a.values().data(), n);
+    _basic_radix2_FFT_bitreversed_input(c, a.omega_inverse());
+
+    _condense(c);
+}
+
+template<typename FieldT>
+void _polynomial_squaring(std::vector<FieldT> &c, const std::vector<FieldT> &a)
+{
+    if (a.empty())
+    {
+        c.clear();
+        return;
+    }
+
+    const size_t n = libff::get_power_of_two(2 * a.size() - 1);
+    FieldT omega = libff::get_root_of_unity<FieldT>(n);
+
+    if (&c != &a) c.assign(a.begin(), a.end());
+    c.resize(n, FieldT::zero());
+
+    _basic_radix2_FFT_bitreversed_output(c, omega);
+    elementwise_multiplication(c.data(), c.data(), c.data(), n);
+    _basic_radix2_FFT_bitreversed_input(c, omega.inverse());
 
     const FieldT sconst = FieldT(n).inverse();
-    std::transform(c.begin(), c.end(), c.begin(), std::bind(std::multiplies<FieldT>(), sconst, std::placeholders::_1));
+    elementwise_scale(c.data(), c.data(), sconst, n);
     _condense(c);
 }
 
@@ -160,25 +478,88 @@ void _polynomial_multiplication_on_kronecker(std::vector<FieldT> &c, const std::
 
 template<typename FieldT>
 std::vector<FieldT> _polynomial_multiplication_transpose(const size_t &n, const std::vector<FieldT> &a, const std::vector<FieldT> &c)
+{
+    std::vector<FieldT> result;
+    _polynomial_multiplication_transpose(result, n, a, c);
+    return result;
+}
+
+template<typename FieldT>
+void _polynomial_multiplication_transpose(std::vector<FieldT> &r, const size_t &n, const std::vector<FieldT> &a, const std::vector<FieldT> &c)
 {
     const size_t m = a.size();
     if (c.size() - 1 > m + n) throw InvalidSizeException("expected c.size() - 1 <= m + n");
 
-    std::vector<FieldT> r(a);
-    _reverse(r, m);
-    _polynomial_multiplication(r, r, c);
+    /* Coefficient k of the cyclic product is the sum of coefficients k + jL of rev(A) * C, whose
+       degree is at most m + c.size() - 2: for L >= c.size() and L >= m + n, those of the
+       middle slice [m - 1, m + n - 1] are alone in their class */
+    const size_t L = libff::get_power_of_two(std::max(c.size(), m + n));
+    const FieldT omega = libff::get_root_of_unity<FieldT>(L);
+
+    /* rev(A) is copied first, since R may be A */
+    std::vector<FieldT> rev_a(L, FieldT::zero());
+    std::reverse_copy(a.begin(), a.end(), rev_a.begin());
+    if (&r != &c) r.assign(c.begin(), c.end());
+    r.resize(L, FieldT::zero());
+
+    _basic_radix2_FFT_bitreversed_output(rev_a, omega);
+    _basic_radix2_FFT_bitreversed_output(r, omega);
+    elementwise_multiplication(r.data(), r.data(), rev_a.data(), L);
+    _basic_radix2_FFT_bitreversed_input(r, omega.inverse());
 
     /* Determine Middle Product */
-    std::vector<FieldT> result;
-    for (size_t i = m - 1; i < n + m; i++)
+    std::copy(r.begin() + (m - 1), r.begin() + (m + n), r.begin());
+    r.resize(n + 1);
+    elementwise_scale(r.data(), r.data(), FieldT(L).inverse(), n + 1);
+}
+
+template<typename FieldT>
+void _polynomial_inverse_power_series(std::vector<FieldT> &g, const std::vector<FieldT> &f, const size_t n)
+{
+    if (f.empty() || f[0] == FieldT::zero()) throw InvalidSizeException("expected f[0] != 0");
+
+    const FieldT two = FieldT::one() + FieldT::one();
+
+    std::vector<FieldT> result(1, f[0].inverse());
+    std::vector<FieldT> f_k, t, scratch;
+
+    /* Each step doubles the precision k: result <- result * (2 - f * result) mod x^k */
+    for (size_t k = 1; k < n; )
     {
-        result.emplace_back(r[i]);
+        k = std::min(2 * k, n);
+
+        f_k.assign(f.begin(), f.begin() + std::min(f.size(), k));
+        _polynomial_multiplication_on_fft(t, f_k, result, scratch);
+        t.resize(k, FieldT::zero());
+        elementwise_negation(t.data(), t.data(), k);
+        t[0] += two;
+
+        _polynomial_multiplication_on_fft(t, t, result, scratch);
+        t.resize(k, FieldT::zero());
+        result.swap(t);
     }
-    return result;
+
+    result.resize(n, FieldT::zero());
+    g.swap(result);
 }
 
 template<typename FieldT>
 void _polynomial_division(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    if (a.size() >= b.size() &&
+        b.size() >= LIBFQFFT_NEWTON_DIVISION_THRESHOLD &&
+        a.size() - b.size() + 1 >= LIBFQFFT_NEWTON_DIVISION_THRESHOLD)
+    {
+        _polynomial_division_newton(q, r, a, b);
+    }
+    else
+    {
+        _polynomial_division_euclidean(q, r, a, b);
+    }
+}
+
+template<typename FieldT>
+void _polynomial_division_euclidean(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
 {
     size_t d = b.size() - 1; /* Degree of B */
     FieldT c = b.back().inverse(); /* Inverse of Leading Coefficient of B */
@@ -199,7 +580,7 @@ void _polynomial_division(std::vector<FieldT> &q, std::vector<FieldT> &r, const
         q[shift] += lead_coeff;
 
         if (b.size() + shift + 1 > r.size()) r.resize(b.size() + shift + 1);
-        auto glambda = [=](FieldT x, FieldT y) { return y - (x * lead_coeff); };
+        auto glambda = [&lead_coeff](const FieldT &x, const FieldT &y) { return y - (x * lead_coeff); };
         std::transform(b.begin(), b.end(), r.begin() + shift, r.begin() + shift, glambda);
         _condense(r);
 
@@ -208,6 +589,50 @@ void _polynomial_division(std::vector<FieldT> &q, std::vector<FieldT> &r, const
     _condense(q);
 }
 
+template<typename FieldT>
+void _polynomial_division_newton(std::vector<FieldT> &q, std::vector<FieldT> &r, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    /* Copies, since Q or R may be the same vector as A or B */
+    std::vector<FieldT> A(a);
+    std::vector<FieldT> B(b);
+    _condense(A);
+    _condense(B);
+    if (B.empty()) throw InvalidSizeException("expected b != 0");
+
+    if (A.size() < B.size())
+    {
+        q.clear();
+        r.swap(A);
+        return;
+    }
+
+    /* Q has m coefficients, and only depends on the top m coefficients of A and B */
+    const size_t m = A.size() - B.size() + 1;
+
+    std::vector<FieldT> rev_b(B);
+    _reverse(rev_b, std::min(B.size(), m));
+    std::vector<FieldT> rev_b_inverse;
+    _polynomial_inverse_power_series(rev_b_inverse, rev_b, m);
+
+    std::vector<FieldT> Q(A);
+    _reverse(Q, m);
+    std::vector<FieldT> scratch;
+    _polynomial_multiplication_on_fft(Q, Q, rev_b_inverse, scratch);
+    Q.resize(m, FieldT::zero());
+    _reverse(Q, m);
+
+    /* R = A - Q * B has degree < deg(B), so only the low coefficients of Q * B are needed */
+    std::vector<FieldT> R;
+    _polynomial_multiplication_on_fft(R, B, Q, scratch);
+    R.resize(B.size() - 1, FieldT::zero());
+    elementwise_subtraction(R.data(), A.data(), R.data(), R.size());
+
+    _condense(Q);
+    _condense(R);
+    q.swap(Q);
+    r.swap(R);
+}
+
 } // libfqfft
 
 #endif // BASIC_OPERATIONS_TCC_
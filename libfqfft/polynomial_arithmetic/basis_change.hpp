@@ -14,15 +14,9 @@
 
 #include <vector>
 
-namespace libfqfft {
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.hpp>
 
-/**
- * Compute the Subproduct Tree of degree 2^M and store it in Tree T.
- * Below we make use of the Subproduct Tree description from
- * [Bostan and Schost 2005. Polynomial Evaluation and Interpolation on Special Sets of Points], on page 7.
- */
-template<typename FieldT>
-void compute_subproduct_tree(const size_t &m, std::vector<std::vector<std::vector<FieldT> > > &T);
+namespace libfqfft {
 
 /**
  * Perform the general change of basis from Monomial to Newton Basis with Subproduct Tree T.
@@ -30,15 +24,20 @@ void compute_subproduct_tree(const size_t &m, std::vector<std::vector<std::vecto
  * [Bostan and Schost 2005. Polynomial Evaluation and Interpolation on Special Sets of Points], on page 12 and 14.
  */
 template<typename FieldT>
-void monomial_to_newton_basis(std::vector<FieldT> &a, const std::vector<std::vector<std::vector<FieldT> > > &T, const size_t &n);
+void monomial_to_newton_basis(std::vector<FieldT> &a, const flat_subproduct_tree<FieldT> &T, const size_t &n);
 
 /**
  * Perform the general change of basis from Newton to Monomial Basis with Subproduct Tree T.
  * Below we make use of the NewtonToMonomial pseudocode from
  * [Bostan and Schost 2005. Polynomial Evaluation and Interpolation on Special Sets of Points], on page 11.
+ *
+ * The partial sums of each level are stored in one buffer of n coefficients, and combined into
+ * the next by schoolbook products below LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD and
+ * _polynomial_multiplication above, in parallel over the nodes of the level under MULTICORE.
+ * A gets exactly n coefficients.
  */
 template<typename FieldT>
-void newton_to_monomial_basis(std::vector<FieldT> &a, const std::vector<std::vector<std::vector<FieldT> > > &T, const size_t &n);
+void newton_to_monomial_basis(std::vector<FieldT> &a, const flat_subproduct_tree<FieldT> &T, const size_t &n);
 
 /**
  * Perform the change of basis from Monomial to Newton Basis for geometric sequence.
@@ -18,66 +18,23 @@
 
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
 #include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
-#include <libfqfft/polynomial_arithmetic/xgcd.hpp>
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
 
 namespace libfqfft {
 
 template<typename FieldT>
-void compute_subproduct_tree(const size_t &m, std::vector< std::vector < std::vector <FieldT> > > &T)
-{
-    if (T.size() != m + 1) T.resize(m + 1);
-
-    /*
-     * Subproduct tree T is represented as a 2-dimensional array T_{i, j}.
-     * T_{i, j} = product_{l = [2^i * j] to [2^i * (j+1) - 1]} (x - x_l)
-     * Note: n = 2^m.
-     */
-
-    /* Precompute the first row. */
-    T[0] = std::vector< std::vector<FieldT> >((size_t)1 << m);
-    for (size_t j = 0; j < ((size_t)1 << m); j++)
-    {
-        T[0][j] = std::vector<FieldT>(2, FieldT::one());
-        T[0][j][0] = FieldT(-((ssize_t)j));
-    }
-
-    std::vector<FieldT> a;
-    std::vector<FieldT> b;
-
-    size_t index = 0;
-    for (size_t i = 1; i <= m; i++)
-    {
-        T[i] = std::vector<std::vector<FieldT> >((size_t)1 << (m-i));
-        for (size_t j = 0; j < ((size_t)1 << (m-i)); j++)
-        {
-            a = T[i-1][index];
-            index++;
-
-            b = T[i-1][index];
-            index++;
-
-            _polynomial_multiplication(T[i][j], a, b);
-        }
-        index = 0;
-    }
-}
-
-template<typename FieldT>
-void monomial_to_newton_basis(std::vector<FieldT> &a, const std::vector<std::vector<std::vector<FieldT> > > &T, const size_t &n)
+void monomial_to_newton_basis(std::vector<FieldT> &a, const flat_subproduct_tree<FieldT> &T, const size_t &n)
 {
     size_t m = (size_t)log2(n);
     if (T.size() != m + 1u) throw DomainSizeException("expected T.size() == m + 1");
 
     /* MonomialToNewton */
-    std::vector<FieldT> I(T[m][0]);
+    std::vector<FieldT> I(T.node_vector(m, 0));
     _reverse(I, n);
 
-    std::vector<FieldT> mod(n + 1, FieldT::zero());
-    mod[n] = FieldT::one();
-
-    _polynomial_xgcd(mod, I, mod, mod, I);
-
-    I.resize(n);
+    /* I^{-1} mod x^n (T[m][0] is monic, so I(0) = 1) */
+    _polynomial_inverse_power_series(I, I, n);
 
     std::vector<FieldT> Q(_polynomial_multiplication_transpose(n - 1, I, a));
     _reverse(Q, n);
@@ -92,7 +49,7 @@ void monomial_to_newton_basis(std::vector<FieldT> &a, const std::vector<std::vec
        because unsigned integers are guaranteed to wrap around */
     for (size_t i = m - 1; i < m; i--)
     {
-        row_length = T[i].size() - 1;
+        row_length = T.num_nodes(i) - 1;
         c_vec = (size_t)1 << i;
 
         /* NB: unsigned reverse iteration */
@@ -100,8 +57,7 @@ void monomial_to_newton_basis(std::vector<FieldT> &a, const std::vector<std::vec
              j < ((size_t)1 << (m - i - 1));
              j--)
         {
-            c[2*j+1] = _polynomial_multiplication_transpose(
-                ((size_t)1 << i) - 1, T[i][row_length - 2*j], c[j]);
+            _polynomial_multiplication_transpose(c[2*j+1], ((size_t)1 << i) - 1, T.node_vector(i, row_length - 2*j), c[j]);
             c[2*j] = c[j];
             c[2*j].resize(c_vec);
         }
@@ -116,30 +72,103 @@ void monomial_to_newton_basis(std::vector<FieldT> &a, const std::vector<std::vec
     }
 }
 
+/*
+ Compute out = low + t * g, for t monic of degree h (h + 1 coefficients), and low and g of h
+ coefficients, into the 2h coefficients of out: with t = x^h + t', out = low + x^h * g + t' * g.
+ Small products are done in place by schoolbook multiplication, and the others by
+ _polynomial_multiplication into w.
+ */
+template<typename FieldT>
+void _newton_to_monomial_combine(FieldT *out, const FieldT *low, const FieldT *t, const FieldT *g, const size_t h,
+                                 std::vector<FieldT> &u, std::vector<FieldT> &v, std::vector<FieldT> &w)
+{
+    std::copy(low, low + h, out);
+    std::copy(g, g + h, out + h);
+
+    if (h < LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD)
+    {
+        for (size_t k = 0; k < h; k++)
+        {
+            for (size_t l = 0; l < h; l++)
+            {
+                out[k + l] += t[k] * g[l];
+            }
+        }
+    }
+    else
+    {
+        u.assign(t, t + h);
+        v.assign(g, g + h);
+        _polynomial_multiplication(w, u, v);
+
+        /* W is condensed, and has at most 2h - 1 coefficients */
+        for (size_t k = 0; k < w.size(); k++)
+        {
+            out[k] += w[k];
+        }
+    }
+}
+
 template<typename FieldT>
-void newton_to_monomial_basis(std::vector<FieldT> &a, const std::vector<std::vector<std::vector<FieldT> > > &T, const size_t &n)
+void newton_to_monomial_basis(std::vector<FieldT> &a, const flat_subproduct_tree<FieldT> &T, const size_t &n)
 {
     size_t m = (size_t)log2(n);
     if (T.size() != m + 1u) throw DomainSizeException("expected T.size() == m + 1");
 
-    std::vector < std::vector <FieldT> > f(n);
-    for (size_t i = 0; i < n; i++)
+    /* NewtonToMonomial: level i holds the 2^{m-i} blocks of 2^i coefficients of the partial sums,
+       and block j of level i+1 is block 2j + T[i][2j] * block 2j+1 of level i */
+    std::vector<FieldT> f(a.begin(), a.begin() + n);
+    std::vector<FieldT> next(n);
+
+    const size_t num_threads = execution_concurrency();
+
+    for (size_t i = 0; i < m; i++)
     {
-        f[i] = std::vector<FieldT>(1, a[i]);
+        const size_t h = (size_t)1 << i;
+        const size_t num_nodes = T.num_nodes(i + 1);
+
+        const size_t num_chunks = (num_nodes >= num_threads ? num_threads : 1);
+        parallel_for(num_chunks, [&](const size_t c) {
+                std::vector<FieldT> u, v, w;
+                for (size_t j = c * num_nodes / num_chunks; j < (c + 1) * num_nodes / num_chunks; j++)
+                {
+                    const FieldT *block = f.data() + 2 * h * j;
+                    _newton_to_monomial_combine(next.data() + 2 * h * j, block, T.node(i, 2*j), block + h, h, u, v, w);
+                }
+            });
+
+        f.swap(next);
     }
 
-    /* NewtonToMonomial */
-    std::vector<FieldT> temp(1, FieldT::zero());
-    for (size_t i = 0; i < m; i++)
+    a.swap(f);
+}
+
+/**
+ * Compute u[i] = prod_{k=1}^{i} geometric_sequence[k] / (1 - geometric_sequence[k])
+ * and u_inverse[i] = u[i]^{-1}, with one batch inversion for both.
+ */
+template<typename FieldT>
+void _geometric_basis_change_factors(std::vector<FieldT> &u, std::vector<FieldT> &u_inverse,
+                                     const std::vector<FieldT> &geometric_sequence, const size_t n)
+{
+    /* numerators in [0, n), denominators in [n, 2n) */
+    std::vector<FieldT> t(2 * n);
+    t[0] = FieldT::one();
+    t[n] = FieldT::one();
+    for (size_t i = 1; i < n; i++)
     {
-        for (size_t j = 0; j < ((size_t)1 << (m - i - 1)); j++)
-        {
-            _polynomial_multiplication(temp, T[i][2*j], f[2*j + 1]);
-            _polynomial_addition(f[j], f[2*j], temp);
-        }
+        t[i] = t[i-1] * geometric_sequence[i];
+        t[n+i] = t[n+i-1] * (FieldT::one() - geometric_sequence[i]);
     }
 
-    a = f[0];
+    std::vector<FieldT> t_inverse(t);
+    batch_inversion(t_inverse);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        u[i] = t[i] * t_inverse[n+i];
+        u_inverse[i] = t[n+i] * t_inverse[i];
+    }
 }
 
 template<typename FieldT>
@@ -157,11 +186,15 @@ void monomial_to_newton_basis_geometric(std::vector<FieldT> &a,
     z[0] = FieldT::one();
     f[0] = a[0];
 
+    std::vector<FieldT> u_inverse(n);
+    std::vector<FieldT> geometric_triangular_sequence_inverse(geometric_triangular_sequence.begin(), geometric_triangular_sequence.begin() + n);
+    _geometric_basis_change_factors(u, u_inverse, geometric_sequence, n);
+    batch_inversion(geometric_triangular_sequence_inverse);
+
     for (size_t i = 1; i < n; i++)
     {
-        u[i] = u[i-1] * geometric_sequence[i] * (FieldT::one() - geometric_sequence[i]).inverse();
-        w[i] = a[i] * (u[i].inverse());
-        z[i] = u[i] * geometric_triangular_sequence[i].inverse();
+        w[i] = a[i] * u_inverse[i];
+        z[i] = u[i] * geometric_triangular_sequence_inverse[i];
         f[i] = w[i] * geometric_triangular_sequence[i];
 
         if (i % 2 == 1)
@@ -171,15 +204,11 @@ void monomial_to_newton_basis_geometric(std::vector<FieldT> &a,
         }
     }
 
-    w = _polynomial_multiplication_transpose(n - 1, z, f);
+    _polynomial_multiplication_transpose(w, n - 1, z, f);
 
-#ifdef MULTICORE
-    #pragma omp parallel for
-#endif
-    for (size_t i = 0; i < n; i++)
-    {
-        a[i] = w[i] * z[i];
-    }
+    parallel_for(n, [&](const size_t i) {
+            a[i] = w[i] * z[i];
+        });
 }
 
 template<typename FieldT>
@@ -197,27 +226,27 @@ void newton_to_monomial_basis_geometric(std::vector<FieldT> &a,
     w[0] = a[0];
     z[0] = FieldT::one();
 
+    std::vector<FieldT> u_inverse(n);
+    std::vector<FieldT> geometric_triangular_sequence_inverse(geometric_triangular_sequence.begin(), geometric_triangular_sequence.begin() + n);
+    _geometric_basis_change_factors(u, u_inverse, geometric_sequence, n);
+    batch_inversion(geometric_triangular_sequence_inverse);
+
     for (size_t i = 1; i < n; i++)
     {
         v[i] = a[i] * geometric_triangular_sequence[i];
         if (i % 2 == 1) v[i] = -v[i];
 
-        u[i] = u[i-1] * geometric_sequence[i] * (FieldT::one() - geometric_sequence[i]).inverse();
-        w[i] = v[i] * u[i].inverse();
+        w[i] = v[i] * u_inverse[i];
 
-        z[i] = u[i] * geometric_triangular_sequence[i].inverse();
+        z[i] = u[i] * geometric_triangular_sequence_inverse[i];
         if (i % 2 == 1) z[i] = -z[i];
     }
 
-    w = _polynomial_multiplication_transpose(n - 1, u, w);
+    _polynomial_multiplication_transpose(w, n - 1, u, w);
 
-#ifdef MULTICORE
-    #pragma omp parallel for
-#endif
-    for (size_t i = 0; i < n; i++)
-    {
-        a[i] = w[i] * z[i];
-    }
+    parallel_for(n, [&](const size_t i) {
+            a[i] = w[i] * z[i];
+        });
 }
 
 } // libfqfft
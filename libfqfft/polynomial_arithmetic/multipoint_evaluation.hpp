@@ -0,0 +1,51 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for fast multipoint evaluation and interpolation
+ over arbitrary points.
+
+ These functions go through the subproduct tree of the points, so that evaluating or
+ interpolating a polynomial of degree n at n points takes O(M(n) log(n)) operations
+ (where M(n) is the cost of multiplying polynomials of degree n), instead of the O(n^2)
+ of evaluating at each point in turn.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef MULTIPOINT_EVALUATION_HPP_
+#define MULTIPOINT_EVALUATION_HPP_
+
+#include <vector>
+
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.hpp>
+
+namespace libfqfft {
+
+/**
+ * Evaluate polynomial P at each of the points (of any number, possibly repeated).
+ */
+template<typename FieldT>
+std::vector<FieldT> multipoint_evaluate(const std::vector<FieldT> &p, const std::vector<FieldT> &points);
+
+/**
+ * Same as above, at the 2^m points of the subproduct tree T, so that the tree can be
+ * computed once for several polynomials.
+ */
+template<typename FieldT>
+std::vector<FieldT> multipoint_evaluate(const std::vector<FieldT> &p, const flat_subproduct_tree<FieldT> &T);
+
+/**
+ * Compute the polynomial P of degree < n (returned as n coefficients) such that
+ * P(points[i]) = values[i], for n distinct points.
+ */
+template<typename FieldT>
+std::vector<FieldT> multipoint_interpolate(const std::vector<FieldT> &points, const std::vector<FieldT> &values);
+
+} // libfqfft
+
+#include <libfqfft/polynomial_arithmetic/multipoint_evaluation.tcc>
+
+#endif // MULTIPOINT_EVALUATION_HPP_
@@ -0,0 +1,187 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for fast multipoint evaluation and interpolation
+ over arbitrary points.
+
+ See multipoint_evaluation.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef MULTIPOINT_EVALUATION_TCC_
+#define MULTIPOINT_EVALUATION_TCC_
+
+#include <algorithm>
+
+#include <libff/common/utils.hpp>
+
+#include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
+namespace libfqfft {
+
+/* c = a * b + d * e, where any of the factors may be the (empty) zero polynomial */
+template<typename FieldT>
+void _multipoint_multiply_add(std::vector<FieldT> &c,
+                              const std::vector<FieldT> &a, const std::vector<FieldT> &b,
+                              const std::vector<FieldT> &d, const std::vector<FieldT> &e)
+{
+    std::vector<FieldT> t0, t1;
+    if (!a.empty() && !b.empty()) _polynomial_multiplication(t0, a, b);
+    if (!d.empty() && !e.empty()) _polynomial_multiplication(t1, d, e);
+    _polynomial_addition(c, t0, t1);
+}
+
+template<typename FieldT>
+std::vector<FieldT> multipoint_evaluate(const std::vector<FieldT> &p, const flat_subproduct_tree<FieldT> &T)
+{
+    if (T.size() == 0) throw DomainSizeException("expected a non-empty subproduct tree");
+    const size_t m = T.size() - 1;
+
+    /* Remainder tree: the remainders of P by the nodes of a level, from the root down to the leaves,
+       where the remainder by x - x_j is P(x_j) */
+    std::vector<std::vector<FieldT> > r(1, p), next;
+    _condense(r[0]);
+    if (r[0].size() >= T.node_size(m))
+    {
+        std::vector<FieldT> q;
+        _polynomial_division(q, r[0], std::vector<FieldT>(r[0]), T.node_vector(m, 0));
+    }
+
+    const size_t num_threads = execution_concurrency();
+
+    for (size_t i = m; i-- > 0; )
+    {
+        const size_t num_nodes = T.num_nodes(i);
+        next.resize(num_nodes);
+
+        parallel_for(num_nodes, [&](const size_t j) {
+                const std::vector<FieldT> &parent = r[j / 2];
+                if (parent.size() < T.node_size(i))
+                {
+                    next[j] = parent;
+                }
+                else
+                {
+                    std::vector<FieldT> q;
+                    _polynomial_division(q, next[j], parent, T.node_vector(i, j));
+                }
+            }, num_nodes >= num_threads);
+
+        r.swap(next);
+    }
+
+    std::vector<FieldT> values(r.size(), FieldT::zero());
+    for (size_t j = 0; j < r.size(); j++)
+    {
+        if (!r[j].empty()) values[j] = r[j][0];
+    }
+    return values;
+}
+
+template<typename FieldT>
+std::vector<FieldT> multipoint_evaluate(const std::vector<FieldT> &p, const std::vector<FieldT> &points)
+{
+    if (points.empty()) return std::vector<FieldT>();
+
+    /* The tree needs 2^m points: repeat the last one */
+    std::vector<FieldT> padded(points);
+    padded.resize(libff::get_power_of_two(points.size()), points.back());
+
+    flat_subproduct_tree<FieldT> T;
+    compute_subproduct_tree(padded, T);
+
+    std::vector<FieldT> values = multipoint_evaluate(p, T);
+    values.resize(points.size());
+    return values;
+}
+
+template<typename FieldT>
+std::vector<FieldT> multipoint_interpolate(const std::vector<FieldT> &points, const std::vector<FieldT> &values)
+{
+    if (points.size() != values.size()) throw DomainSizeException("expected points.size() == values.size()");
+
+    const size_t n = points.size();
+    if (n <= 1) return values;
+
+    const size_t N = libff::get_power_of_two(n);
+    const size_t m = libff::log2(N);
+
+    /* Pad the points up to N with copies of a point d that is not among them, so that
+       the root of the tree is M(x) = D(x) * prod_i (x - x_i), with D(x) = (x - d)^{N-n} */
+    FieldT d = FieldT((long)n);
+    if (N > n)
+    {
+        while (std::find(points.begin(), points.end(), d) != points.end()) d += FieldT::one();
+    }
+
+    std::vector<FieldT> padded(points);
+    padded.resize(N, d);
+
+    flat_subproduct_tree<FieldT> T;
+    compute_subproduct_tree(padded, T);
+
+    /* For the real points, prod_{k != i} (x_i - x_k) = M'(x_i) / D(x_i), over the real points k only */
+    const std::vector<FieldT> root = T.node_vector(m, 0);
+    std::vector<FieldT> derivative(N);
+    for (size_t k = 0; k < N; k++)
+    {
+        derivative[k] = FieldT((long)(k + 1)) * root[k + 1];
+    }
+
+    std::vector<FieldT> w = multipoint_evaluate(derivative, T);
+    w.resize(n);
+    batch_inversion(w);
+
+    /* Linear combination up the tree: at the leaves, c_i = values[i] * D(x_i) / M'(x_i) (and 0 for the padding);
+       each node combines its children as f_L * T_R + f_R * T_L, so that the root gets D(x) * P(x) */
+    std::vector<std::vector<FieldT> > f(N), next;
+    parallel_for(n, [&](const size_t i) {
+            f[i].assign(1, values[i] * w[i] * ((points[i] - d)^(N - n)));
+            _condense(f[i]);
+        });
+
+    const size_t num_threads = execution_concurrency();
+
+    for (size_t i = 1; i <= m; i++)
+    {
+        const size_t num_nodes = T.num_nodes(i);
+        next.resize(num_nodes);
+
+        parallel_for(num_nodes, [&](const size_t j) {
+                _multipoint_multiply_add(next[j], f[2*j], T.node_vector(i-1, 2*j+1), f[2*j+1], T.node_vector(i-1, 2*j));
+            }, num_nodes >= num_threads);
+
+        f.swap(next);
+    }
+
+    std::vector<FieldT> result(f[0]);
+    if (N > n && !result.empty())
+    {
+        /* D(x) = (x - d)^{N-n}, as the product of the padding leaves */
+        std::vector<FieldT> D(1, FieldT::one());
+        std::vector<FieldT> x_minus_d(2, FieldT::one());
+        x_minus_d[0] = -d;
+        for (size_t k = N - n; k > 0; k >>= 1)
+        {
+            if (k & 1) _polynomial_multiplication(D, D, x_minus_d);
+            if (k > 1) _polynomial_multiplication(x_minus_d, x_minus_d, x_minus_d);
+        }
+
+        std::vector<FieldT> r;
+        _polynomial_division(result, r, std::vector<FieldT>(result), D);
+    }
+
+    result.resize(n, FieldT::zero());
+    return result;
+}
+
+} // libfqfft
+
+#endif // MULTIPOINT_EVALUATION_TCC_
@@ -0,0 +1,71 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for a polynomial held in evaluation form.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef PRETRANSFORMED_OPERAND_HPP_
+#define PRETRANSFORMED_OPERAND_HPP_
+
+#include <vector>
+
+namespace libfqfft {
+
+/**
+ * A polynomial A, of at most n coefficients, held as its evaluations at the n-th roots of
+ * unity (for n a power of 2, in bit-reversed order, and already scaled by 1/n).
+ *
+ * Multiplying a fixed polynomial by many others through one of these (see
+ * _polynomial_multiplication_on_fft) costs one forward and one inverse FFT per product,
+ * instead of two forward and one inverse, as long as every product has at most n coefficients.
+ */
+template<typename FieldT>
+class pretransformed_operand {
+public:
+
+    pretransformed_operand();
+    pretransformed_operand(const std::vector<FieldT> &a, const size_t n);
+
+    /**
+     * Transform polynomial A (with a.size() <= n) over the n-th roots of unity.
+     */
+    void assign(const std::vector<FieldT> &a, const size_t n);
+
+    /**
+     * Take values (from values() of an operand of num_coefficients coefficients)
+     * as the transform, without redoing it.
+     */
+    void assign_transformed(const std::vector<FieldT> &values, const size_t num_coefficients);
+
+    /**
+     * The number of coefficients of A.
+     */
+    size_t size() const;
+
+    /**
+     * The transform size n (0 if nothing has been assigned).
+     */
+    size_t transform_size() const;
+
+    const std::vector<FieldT> &values() const;
+    const FieldT &omega() const;
+    const FieldT &omega_inverse() const;
+
+private:
+
+    size_t num_coefficients;
+    std::vector<FieldT> evaluations;
+    FieldT root;
+    FieldT root_inverse;
+};
+
+} // libfqfft
+
+#include <libfqfft/polynomial_arithmetic/pretransformed_operand.tcc>
+
+#endif // PRETRANSFORMED_OPERAND_HPP_
@@ -0,0 +1,102 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for a polynomial held in evaluation form.
+
+ See pretransformed_operand.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef PRETRANSFORMED_OPERAND_TCC_
+#define PRETRANSFORMED_OPERAND_TCC_
+
+#include <libff/algebra/fields/field_utils.hpp>
+#include <libff/common/utils.hpp>
+
+#include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/elementwise_operations.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+
+namespace libfqfft {
+
+template<typename FieldT>
+pretransformed_operand<FieldT>::pretransformed_operand() :
+    num_coefficients(0), root(FieldT::one()), root_inverse(FieldT::one())
+{
+}
+
+template<typename FieldT>
+pretransformed_operand<FieldT>::pretransformed_operand(const std::vector<FieldT> &a, const size_t n) :
+    num_coefficients(0), root(FieldT::one()), root_inverse(FieldT::one())
+{
+    assign(a, n);
+}
+
+template<typename FieldT>
+void pretransformed_operand<FieldT>::assign(const std::vector<FieldT> &a, const size_t n)
+{
+    if (n == 0 || libff::get_power_of_two(n) != n) throw DomainSizeException("expected n to be a power of 2");
+    if (a.size() > n) throw DomainSizeException("expected a.size() <= n");
+
+    num_coefficients = a.size();
+    root = libff::get_root_of_unity<FieldT>(n);
+    root_inverse = root.inverse();
+
+    evaluations.assign(a.begin(), a.end());
+    evaluations.resize(n, FieldT::zero());
+    _basic_radix2_FFT_bitreversed_output(evaluations, root);
+
+    /* Fold the 1/n of the inverse transform in here, once */
+    elementwise_scale(evaluations.data(), evaluations.data(), FieldT(n).inverse(), n);
+}
+
+template<typename FieldT>
+void pretransformed_operand<FieldT>::assign_transformed(const std::vector<FieldT> &values, const size_t num_coefficients)
+{
+    const size_t n = values.size();
+    if (n == 0 || libff::get_power_of_two(n) != n) throw DomainSizeException("expected values.size() to be a power of 2");
+    if (num_coefficients > n) throw DomainSizeException("expected num_coefficients <= values.size()");
+
+    this->num_coefficients = num_coefficients;
+    root = libff::get_root_of_unity<FieldT>(n);
+    root_inverse = root.inverse();
+    evaluations = values;
+}
+
+template<typename FieldT>
+size_t pretransformed_operand<FieldT>::size() const
+{
+    return num_coefficients;
+}
+
+template<typename FieldT>
+size_t pretransformed_operand<FieldT>::transform_size() const
+{
+    return evaluations.size();
+}
+
+template<typename FieldT>
+const std::vector<FieldT> &pretransformed_operand<FieldT>::values() const
+{
+    return evaluations;
+}
+
+template<typename FieldT>
+const FieldT &pretransformed_operand<FieldT>::omega() const
+{
+    return root;
+}
+
+template<typename FieldT>
+const FieldT &pretransformed_operand<FieldT>::omega_inverse() const
+{
+    return root_inverse;
+}
+
+} // libfqfft
+
+#endif // PRETRANSFORMED_OPERAND_TCC_
@@ -0,0 +1,90 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of interfaces for the subproduct tree.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef SUBPRODUCT_TREE_HPP_
+#define SUBPRODUCT_TREE_HPP_
+
+#include <vector>
+
+namespace libfqfft {
+
+/**
+ * A subproduct tree over n = 2^m points x_0, ..., x_{n-1}, stored flat.
+ *
+ * Node j of level i is T_{i, j} = product_{l = [2^i * j] to [2^i * (j+1) - 1]} (x - x_l),
+ * a monic polynomial of degree 2^i stored as its 2^i + 1 coefficients (lowest degree first).
+ * The 2^{m-i} nodes of each level are stored one after the other, and the levels one after
+ * the other, all in a single arena.
+ */
+template<typename FieldT>
+class flat_subproduct_tree {
+public:
+
+    flat_subproduct_tree();
+    flat_subproduct_tree(const size_t m);
+
+    /**
+     * Allocate the levels of a tree over 2^m points (the coefficients are left unspecified).
+     */
+    void resize(const size_t m);
+
+    /**
+     * The number of levels, m + 1 (or 0 for an empty tree).
+     */
+    size_t size() const;
+
+    size_t num_nodes(const size_t i) const;
+    size_t node_size(const size_t i) const;
+
+    FieldT *node(const size_t i, const size_t j);
+    const FieldT *node(const size_t i, const size_t j) const;
+
+    /**
+     * A copy of node j of level i, as a polynomial.
+     */
+    std::vector<FieldT> node_vector(const size_t i, const size_t j) const;
+
+    /**
+     * The coefficients of all the nodes, level after level (data_size() of them).
+     */
+    FieldT *data();
+    const FieldT *data() const;
+    size_t data_size() const;
+
+private:
+
+    size_t num_levels;
+    std::vector<size_t> level_offsets;
+    std::vector<FieldT> arena;
+};
+
+/**
+ * Compute the Subproduct Tree of degree 2^M over the points 0, 1, ..., 2^M - 1 and store it in Tree T.
+ * Below we make use of the Subproduct Tree description from
+ * [Bostan and Schost 2005. Polynomial Evaluation and Interpolation on Special Sets of Points], on page 7.
+ */
+template<typename FieldT>
+void compute_subproduct_tree(const size_t &m, flat_subproduct_tree<FieldT> &T);
+
+/**
+ * Same as above, over the given points (whose number must be a power of 2).
+ *
+ * The nodes of a level are computed in parallel under MULTICORE (or, on the last levels, which
+ * have too few nodes, each product is), directly into the arena from the two children.
+ */
+template<typename FieldT>
+void compute_subproduct_tree(const std::vector<FieldT> &points, flat_subproduct_tree<FieldT> &T);
+
+} // libfqfft
+
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.tcc>
+
+#endif // SUBPRODUCT_TREE_HPP_
@@ -0,0 +1,223 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of interfaces for the subproduct tree.
+
+ See subproduct_tree.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef SUBPRODUCT_TREE_TCC_
+#define SUBPRODUCT_TREE_TCC_
+
+#include <algorithm>
+
+#include <libff/algebra/fields/field_utils.hpp>
+
+#include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+
+/*
+ Products of nodes of degree below this are computed by schoolbook multiplication.
+ */
+#ifndef LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD
+#define LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD ((size_t)32)
+#endif
+
+namespace libfqfft {
+
+template<typename FieldT>
+flat_subproduct_tree<FieldT>::flat_subproduct_tree() : num_levels(0)
+{
+}
+
+template<typename FieldT>
+flat_subproduct_tree<FieldT>::flat_subproduct_tree(const size_t m) : num_levels(0)
+{
+    resize(m);
+}
+
+template<typename FieldT>
+void flat_subproduct_tree<FieldT>::resize(const size_t m)
+{
+    /* Level i takes 2^{m-i} * (2^i + 1) = 2^m + 2^{m-i} coefficients */
+    num_levels = m + 1;
+    level_offsets.resize(num_levels + 1);
+    level_offsets[0] = 0;
+    for (size_t i = 0; i < num_levels; i++)
+    {
+        level_offsets[i+1] = level_offsets[i] + ((size_t)1 << m) + ((size_t)1 << (m - i));
+    }
+    arena.resize(level_offsets[num_levels]);
+}
+
+template<typename FieldT>
+size_t flat_subproduct_tree<FieldT>::size() const
+{
+    return num_levels;
+}
+
+template<typename FieldT>
+size_t flat_subproduct_tree<FieldT>::num_nodes(const size_t i) const
+{
+    return (size_t)1 << (num_levels - 1 - i);
+}
+
+template<typename FieldT>
+size_t flat_subproduct_tree<FieldT>::node_size(const size_t i) const
+{
+    return ((size_t)1 << i) + 1;
+}
+
+template<typename FieldT>
+FieldT *flat_subproduct_tree<FieldT>::node(const size_t i, const size_t j)
+{
+    return &arena[level_offsets[i] + j * node_size(i)];
+}
+
+template<typename FieldT>
+const FieldT *flat_subproduct_tree<FieldT>::node(const size_t i, const size_t j) const
+{
+    return &arena[level_offsets[i] + j * node_size(i)];
+}
+
+template<typename FieldT>
+std::vector<FieldT> flat_subproduct_tree<FieldT>::node_vector(const size_t i, const size_t j) const
+{
+    const FieldT *p = node(i, j);
+    return std::vector<FieldT>(p, p + node_size(i));
+}
+
+template<typename FieldT>
+FieldT *flat_subproduct_tree<FieldT>::data()
+{
+    return arena.data();
+}
+
+template<typename FieldT>
+const FieldT *flat_subproduct_tree<FieldT>::data() const
+{
+    return arena.data();
+}
+
+template<typename FieldT>
+size_t flat_subproduct_tree<FieldT>::data_size() const
+{
+    return arena.size();
+}
+
+/*
+ Compute out = c0 * c1, for c0 and c1 monic of degree h (h + 1 coefficients) and out of 2h + 1 coefficients.
+ With c0 = x^h + p0 and c1 = x^h + p1, out = x^{2h} + x^h * (p0 + p1) + p0 * p1, where p0 * p1 has
+ degree < 2h - 1, so that a cyclic convolution of size 2h (over omega, of order 2h) is enough.
+ */
+template<typename FieldT>
+void _subproduct_tree_monic_multiplication(FieldT *out, const FieldT *c0, const FieldT *c1, const size_t h,
+                                           const FieldT &omega, const FieldT &omega_inverse, const FieldT &scale,
+                                           std::vector<FieldT> &u, std::vector<FieldT> &v)
+{
+    if (h < LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD)
+    {
+        std::fill(out, out + 2 * h, FieldT::zero());
+        for (size_t k = 0; k < h; k++)
+        {
+            for (size_t l = 0; l < h; l++)
+            {
+                out[k + l] += c0[k] * c1[l];
+            }
+        }
+    }
+    else
+    {
+        u.assign(c0, c0 + h);
+        u.resize(2 * h, FieldT::zero());
+        v.assign(c1, c1 + h);
+        v.resize(2 * h, FieldT::zero());
+
+        /* The pointwise product does not care about the order of the evaluations */
+        _basic_radix2_FFT_bitreversed_output(u, omega);
+        _basic_radix2_FFT_bitreversed_output(v, omega);
+        for (size_t k = 0; k < 2 * h; k++)
+        {
+            u[k] *= v[k];
+        }
+        _basic_radix2_FFT_bitreversed_input(u, omega_inverse);
+
+        for (size_t k = 0; k < 2 * h; k++)
+        {
+            out[k] = u[k] * scale;
+        }
+    }
+
+    for (size_t k = 0; k < h; k++)
+    {
+        out[h + k] += c0[k] + c1[k];
+    }
+    out[2 * h] = FieldT::one();
+}
+
+template<typename FieldT>
+void compute_subproduct_tree(const size_t &m, flat_subproduct_tree<FieldT> &T)
+{
+    std::vector<FieldT> points((size_t)1 << m);
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        points[j] = FieldT((long)j);
+    }
+
+    compute_subproduct_tree(points, T);
+}
+
+template<typename FieldT>
+void compute_subproduct_tree(const std::vector<FieldT> &points, flat_subproduct_tree<FieldT> &T)
+{
+    const size_t m = libff::log2(points.size());
+    if (points.size() != ((size_t)1 << m)) throw DomainSizeException("expected points.size() to be a power of 2");
+
+    T.resize(m);
+
+    /* The first row: x - x_j */
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        FieldT *leaf = T.node(0, j);
+        leaf[0] = -points[j];
+        leaf[1] = FieldT::one();
+    }
+
+    const size_t num_threads = execution_concurrency();
+
+    for (size_t i = 1; i <= m; i++)
+    {
+        const size_t num_nodes = T.num_nodes(i);
+        const size_t h = (size_t)1 << (i - 1);
+
+        FieldT omega = FieldT::one(), omega_inverse = FieldT::one(), scale = FieldT::one();
+        if (h >= LIBFQFFT_SUBPRODUCT_TREE_FFT_THRESHOLD)
+        {
+            omega = libff::get_root_of_unity<FieldT>(2 * h);
+            omega_inverse = omega.inverse();
+            scale = FieldT(2 * h).inverse();
+        }
+
+        /* The products of a row are independent; the last rows have too few of them
+           to keep every thread busy, so they leave the threads to each multiplication instead */
+        const size_t num_chunks = (num_nodes >= num_threads ? num_threads : 1);
+        parallel_for(num_chunks, [&](const size_t c) {
+                std::vector<FieldT> u, v;
+                for (size_t j = c * num_nodes / num_chunks; j < (c + 1) * num_nodes / num_chunks; j++)
+                {
+                    _subproduct_tree_monic_multiplication(T.node(i, j), T.node(i-1, 2*j), T.node(i-1, 2*j+1), h,
+                                                          omega, omega_inverse, scale, u, v);
+                }
+            });
+    }
+}
+
+} // libfqfft
+
+#endif // SUBPRODUCT_TREE_TCC_
@@ -17,13 +17,24 @@
 namespace libfqfft {
 
 /**
- * Perform the standard Extended Euclidean Division algorithm.
+ * Perform the Extended Euclidean Division algorithm.
  * Input: Polynomial A, Polynomial B.
  * Output: Polynomial G, Polynomial U, Polynomial V, such that G = (A * U) + (B * V).
+ * Unless B is zero, G is monic.
+ *
+ * The remainder sequence is walked with the half-GCD algorithm (Knuth-Schoenhage),
+ * in O(M(n) log(n)) operations (where M(n) is the cost of multiplying polynomials of
+ * degree n). The outputs may be the same vectors as the inputs.
  */
 template<typename FieldT>
 void _polynomial_xgcd(const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &g, std::vector<FieldT> &u, std::vector<FieldT> &v);
 
+/**
+ * Same as above, with the standard Euclidean loop, in O(n^2) operations.
+ */
+template<typename FieldT>
+void _polynomial_xgcd_euclidean(const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &g, std::vector<FieldT> &u, std::vector<FieldT> &v);
+
 } // libfqfft
 
 #include <libfqfft/polynomial_arithmetic/xgcd.tcc>
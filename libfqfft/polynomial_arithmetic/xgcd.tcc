@@ -15,12 +15,161 @@
 #define XGCD_TCC_
 
 #include <algorithm>
-#include <functional>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain_aux.hpp>
 #include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
+#include <libfqfft/tools/elementwise_operations.hpp>
+
+/*
+ Below this many coefficients, the half-GCD takes its Euclidean steps one at a time.
+ */
+#ifndef LIBFQFFT_HALF_GCD_THRESHOLD
+#define LIBFQFFT_HALF_GCD_THRESHOLD ((size_t)256)
+#endif
 
 namespace libfqfft {
 
+/*
+ A 2x2 matrix of polynomials, acting on pairs (a, b) of polynomials.
+ All entries are kept condensed, so the zero polynomial is empty.
+ */
+template<typename FieldT>
+struct _polynomial_matrix {
+    std::vector<FieldT> m00, m01, m10, m11;
+};
+
+template<typename FieldT>
+void _polynomial_matrix_identity(_polynomial_matrix<FieldT> &M)
+{
+    M.m00.assign(1, FieldT::one());
+    M.m01.clear();
+    M.m10.clear();
+    M.m11.assign(1, FieldT::one());
+}
+
+/* c = a * b, where a or b may be empty */
+template<typename FieldT>
+void _xgcd_multiplication(std::vector<FieldT> &c, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    if (a.empty() || b.empty())
+    {
+        c.clear();
+        return;
+    }
+    _polynomial_multiplication(c, a, b);
+}
+
+/* c = a0 * b0 + a1 * b1 */
+template<typename FieldT>
+void _xgcd_multiply_add(std::vector<FieldT> &c,
+                        const std::vector<FieldT> &a0, const std::vector<FieldT> &b0,
+                        const std::vector<FieldT> &a1, const std::vector<FieldT> &b1)
+{
+    std::vector<FieldT> t0, t1;
+    _xgcd_multiplication(t0, a0, b0);
+    _xgcd_multiplication(t1, a1, b1);
+    _polynomial_addition(c, t0, t1);
+    _condense(c);
+}
+
+/* C = A * B (C must be distinct from A and B) */
+template<typename FieldT>
+void _polynomial_matrix_multiplication(_polynomial_matrix<FieldT> &C, const _polynomial_matrix<FieldT> &A, const _polynomial_matrix<FieldT> &B)
+{
+    _xgcd_multiply_add(C.m00, A.m00, B.m00, A.m01, B.m10);
+    _xgcd_multiply_add(C.m01, A.m00, B.m01, A.m01, B.m11);
+    _xgcd_multiply_add(C.m10, A.m10, B.m00, A.m11, B.m10);
+    _xgcd_multiply_add(C.m11, A.m10, B.m01, A.m11, B.m11);
+}
+
+/* (a, b) <- M * (a, b) */
+template<typename FieldT>
+void _polynomial_matrix_apply(const _polynomial_matrix<FieldT> &M, std::vector<FieldT> &a, std::vector<FieldT> &b)
+{
+    std::vector<FieldT> c, d;
+    _xgcd_multiply_add(c, M.m00, a, M.m01, b);
+    _xgcd_multiply_add(d, M.m10, a, M.m11, b);
+    a.swap(c);
+    b.swap(d);
+}
+
+/* The quotient of a by x^k */
+template<typename FieldT>
+std::vector<FieldT> _xgcd_shift(const std::vector<FieldT> &a, const size_t k)
+{
+    return std::vector<FieldT>(a.begin() + std::min(k, a.size()), a.end());
+}
+
+/*
+ One Euclidean step: with a = q * b + r, (a, b) <- (b, r) and M <- [[0, 1], [1, -q]] * M.
+ Requires b != 0.
+ */
+template<typename FieldT>
+void _xgcd_euclidean_step(std::vector<FieldT> &a, std::vector<FieldT> &b, _polynomial_matrix<FieldT> &M)
+{
+    std::vector<FieldT> q, r, t;
+    _polynomial_division(q, r, a, b);
+    _condense(r);
+    a.swap(b);
+    b.swap(r);
+
+    _xgcd_multiplication(t, q, M.m10);
+    _polynomial_subtraction(M.m00, M.m00, t);
+    _condense(M.m00);
+    M.m00.swap(M.m10);
+
+    _xgcd_multiplication(t, q, M.m11);
+    _polynomial_subtraction(M.m01, M.m01, t);
+    _condense(M.m01);
+    M.m01.swap(M.m11);
+}
+
+/*
+ For condensed a and b with deg(a) > deg(b), compute the matrix M of the Euclidean steps
+ that take (a, b) to the first pair (c, d) of the remainder sequence with
+ deg(c) >= ceil(deg(a) / 2) > deg(d) [Thull & Yap, 1990. A Unified Approach to HGCD Algorithms].
+ */
+template<typename FieldT>
+void _polynomial_half_gcd(_polynomial_matrix<FieldT> &M, const std::vector<FieldT> &a, const std::vector<FieldT> &b)
+{
+    /* m = ceil(deg(a) / 2), and deg(b) < m iff b.size() <= m */
+    const size_t m = a.size() / 2;
+
+    _polynomial_matrix_identity(M);
+    if (b.size() <= m) return;
+
+    if (a.size() < LIBFQFFT_HALF_GCD_THRESHOLD)
+    {
+        std::vector<FieldT> c(a), d(b);
+        while (d.size() > m)
+        {
+            _xgcd_euclidean_step(c, d, M);
+        }
+        return;
+    }
+
+    /* The first half of the quotients only depends on the top halves of a and b */
+    _polynomial_matrix<FieldT> R;
+    _polynomial_half_gcd(R, _xgcd_shift(a, m), _xgcd_shift(b, m));
+
+    std::vector<FieldT> c(a), d(b);
+    _polynomial_matrix_apply(R, c, d);
+    if (d.size() > m)
+    {
+        _xgcd_euclidean_step(c, d, R);
+    }
+    if (d.size() <= m)
+    {
+        std::swap(M, R);
+        return;
+    }
+
+    /* And the second half on the top 2 * (deg(c) - m) coefficients of c and d */
+    const size_t k = 2 * m - (c.size() - 1);
+    _polynomial_matrix<FieldT> S;
+    _polynomial_half_gcd(S, _xgcd_shift(c, k), _xgcd_shift(d, k));
+    _polynomial_matrix_multiplication(M, S, R);
+}
+
 template<typename FieldT>
 void _polynomial_xgcd(const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &g, std::vector<FieldT> &u, std::vector<FieldT> &v)
 {
@@ -32,6 +181,52 @@ void _polynomial_xgcd(const std::vector<FieldT> &a, const std::vector<FieldT> &b
         return;
     }
 
+    std::vector<FieldT> A(a);
+    std::vector<FieldT> B(b);
+    _condense(A);
+    _condense(B);
+
+    /* M * (a, b) = (A, B) throughout */
+    _polynomial_matrix<FieldT> M, R, T;
+    _polynomial_matrix_identity(M);
+
+    if (A.size() <= B.size()) _xgcd_euclidean_step(A, B, M);
+
+    while (!B.empty())
+    {
+        _polynomial_half_gcd(R, A, B);
+        _polynomial_matrix_apply(R, A, B);
+        _polynomial_matrix_multiplication(T, R, M);
+        std::swap(M, T);
+
+        if (!B.empty()) _xgcd_euclidean_step(A, B, M);
+    }
+
+    /* Now A = gcd(a, b) = M.m00 * a + M.m01 * b */
+    const FieldT lead_coeff = A.back().inverse();
+    elementwise_scale(A.data(), A.data(), lead_coeff, A.size());
+    elementwise_scale(M.m00.data(), M.m00.data(), lead_coeff, M.m00.size());
+    elementwise_scale(M.m01.data(), M.m01.data(), lead_coeff, M.m01.size());
+
+    if (M.m00.empty()) M.m00.assign(1, FieldT::zero());
+    if (M.m01.empty()) M.m01.assign(1, FieldT::zero());
+
+    g.swap(A);
+    u.swap(M.m00);
+    v.swap(M.m01);
+}
+
+template<typename FieldT>
+void _polynomial_xgcd_euclidean(const std::vector<FieldT> &a, const std::vector<FieldT> &b, std::vector<FieldT> &g, std::vector<FieldT> &u, std::vector<FieldT> &v)
+{
+    if (_is_zero(b))
+    {
+        g = a;
+        u = std::vector<FieldT>(1, FieldT::one());
+        v = std::vector<FieldT>(1, FieldT::zero());
+        return;
+    }
+
     std::vector<FieldT> U(1, FieldT::one());
     std::vector<FieldT> V1(1, FieldT::zero());
     std::vector<FieldT> G(a);
@@ -47,10 +242,11 @@ void _polynomial_xgcd(const std::vector<FieldT> &a, const std::vector<FieldT> &b
         _polynomial_multiplication(G, V1, Q);
         _polynomial_subtraction(T, U, G);
 
-        U = V1;
-        G = V3;
-        V1 = T;
-        V3 = R;
+        /* (U, G, V1, V3) <- (V1, V3, T, R), reusing the storage of the others */
+        U.swap(V1);
+        V1.swap(T);
+        G.swap(V3);
+        V3.swap(R);
     }
 
     _polynomial_multiplication(V3, a, U);
@@ -58,9 +254,9 @@ void _polynomial_xgcd(const std::vector<FieldT> &a, const std::vector<FieldT> &b
     _polynomial_division(V1, R, V3, b);
 
     FieldT lead_coeff = G.back().inverse();
-    std::transform(G.begin(), G.end(), G.begin(), std::bind(std::multiplies<FieldT>(), lead_coeff, std::placeholders::_1));
-    std::transform(U.begin(), U.end(), U.begin(), std::bind(std::multiplies<FieldT>(), lead_coeff, std::placeholders::_1));
-    std::transform(V1.begin(), V1.end(), V1.begin(), std::bind(std::multiplies<FieldT>(), lead_coeff, std::placeholders::_1));
+    elementwise_scale(G.data(), G.data(), lead_coeff, G.size());
+    elementwise_scale(U.data(), U.data(), lead_coeff, U.size());
+    elementwise_scale(V1.data(), V1.data(), lead_coeff, V1.size());
 
     g = G;
     u = U;
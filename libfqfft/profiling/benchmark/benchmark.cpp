@@ -0,0 +1,450 @@
+/** @file
+ *****************************************************************************
+
+ Non-interactive benchmark of the evaluation domains and of polynomial multiplication.
+
+ Each case constructs its domain once (timed separately, as "setup"), runs a few
+ warm-up iterations, and then times each of the requested repetitions of the
+ operation on its own. The results are written as JSON, for scripts that track
+ performance across releases.
+
+ Run with --help for the options.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
+#ifdef CURVE_BN128
+#include <libff/algebra/curves/bn128/bn128_pp.hpp>
+#endif
+#include <libff/algebra/curves/edwards/edwards_pp.hpp>
+#include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
+#include <libff/algebra/curves/mnt/mnt6/mnt6_pp.hpp>
+#include <libff/common/double.hpp>
+#include <libff/common/profiling.hpp>
+
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
+#include <libfqfft/evaluation_domain/get_evaluation_domain.hpp>
+#include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
+
+using namespace libfqfft;
+
+/* https://stackoverflow.com/questions/26237419/faster-than-rand */
+static unsigned int seed = 5149;
+inline int fastrand()
+{
+  seed = (214013 * seed + 2531011);
+  return (seed >> 16) & 0x7FFF;
+}
+
+struct benchmark_options {
+  std::vector<size_t> sizes;
+  std::vector<int> threads;
+  std::vector<std::string> curves;
+  std::vector<std::string> domains;
+  std::vector<std::string> ops;
+  size_t repetitions;
+  size_t warmup;
+  std::string out;
+};
+
+struct benchmark_result {
+  std::string curve;
+  std::string domain;
+  std::string op;
+  size_t size;
+  size_t domain_size;
+  int threads;
+  double setup_ns;
+  std::vector<double> samples_ns;
+};
+
+static const char *all_curves[] = { "alt_bn128", "bn128", "mnt4", "mnt6", "edwards", "double" };
+static const char *all_domains[] = { "basic_radix2", "extended_radix2", "step_radix2", "geometric_sequence", "arithmetic_sequence" };
+static const char *all_ops[] = { "fft", "ifft", "coset_fft", "icoset_fft", "lagrange", "poly_mul" };
+
+template<size_t N>
+std::vector<std::string> to_list(const char *(&names)[N])
+{
+  return std::vector<std::string>(names, names + N);
+}
+
+std::vector<std::string> split(const std::string &s)
+{
+  std::vector<std::string> result;
+  std::stringstream stream(s);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (!item.empty()) result.push_back(item);
+  }
+  return result;
+}
+
+bool contains(const std::vector<std::string> &list, const std::string &s)
+{
+  return std::find(list.begin(), list.end(), s) != list.end();
+}
+
+evaluation_domain_kind domain_kind(const std::string &name)
+{
+  if (name == "basic_radix2") return evaluation_domain_kind::basic_radix2;
+  if (name == "extended_radix2") return evaluation_domain_kind::extended_radix2;
+  if (name == "step_radix2") return evaluation_domain_kind::step_radix2;
+  if (name == "geometric_sequence") return evaluation_domain_kind::geometric_sequence;
+  if (name == "arithmetic_sequence") return evaluation_domain_kind::arithmetic_sequence;
+  return evaluation_domain_kind::automatic;
+}
+
+double elapsed_ns(const std::chrono::steady_clock::time_point &start)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename FieldT>
+std::vector<FieldT> random_vector(const size_t n)
+{
+  std::vector<FieldT> v(n);
+  for (size_t i = 0; i < n; i++) v[i] = FieldT(fastrand());
+  return v;
+}
+
+/*
+ * Run op once on a copy of input (the copy is not timed) and return the time taken.
+ */
+template<typename FieldT>
+double run_op(const std::string &op,
+              evaluation_domain<FieldT> *domain,
+              const std::vector<FieldT> &input,
+              const std::vector<FieldT> &other,
+              const FieldT &g)
+{
+  std::vector<FieldT> a(input);
+  std::vector<FieldT> c;
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if (op == "fft") domain->FFT(a);
+  else if (op == "ifft") domain->iFFT(a);
+  else if (op == "coset_fft") domain->cosetFFT(a, g);
+  else if (op == "icoset_fft") domain->icosetFFT(a, g);
+  else if (op == "lagrange") c = domain->evaluate_all_lagrange_polynomials(g);
+  else if (op == "poly_mul") _polynomial_multiplication(c, a, other);
+  return elapsed_ns(start);
+}
+
+template<typename FieldT>
+void benchmark_curve(const std::string &curve,
+                     const benchmark_options &options,
+                     std::vector<benchmark_result> &results)
+{
+  for (size_t t = 0; t < options.threads.size(); t++)
+  {
+#ifdef MULTICORE
+    /* Fix number of threads, no dynamic adjustment */
+    omp_set_dynamic(0);
+    omp_set_num_threads(options.threads[t]);
+#else
+    if (options.threads[t] != 1)
+    {
+      fprintf(stderr, "skipping threads=%d: built without MULTICORE\n", options.threads[t]);
+      continue;
+    }
+#endif
+
+    for (size_t s = 0; s < options.sizes.size(); s++)
+    {
+      const size_t n = options.sizes[s];
+      const std::vector<FieldT> input = random_vector<FieldT>(n);
+      const std::vector<FieldT> other = random_vector<FieldT>(n);
+      const FieldT g = FieldT::multiplicative_generator;
+
+      for (size_t d = 0; d < options.domains.size(); d++)
+      {
+        /* poly_mul does not depend on the domain, so it is benchmarked once per size, below */
+        std::vector<std::string> ops;
+        for (size_t o = 0; o < options.ops.size(); o++)
+        {
+          if (options.ops[o] != "poly_mul") ops.push_back(options.ops[o]);
+        }
+        if (ops.empty()) break;
+
+        std::shared_ptr<evaluation_domain<FieldT> > domain;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        try
+        {
+          domain = create_evaluation_domain<FieldT>(n, domain_kind(options.domains[d]));
+        }
+        catch (...)
+        {
+          fprintf(stderr, "skipping %s/%s/%zu: no domain of this size\n",
+                  curve.c_str(), options.domains[d].c_str(), n);
+          continue;
+        }
+        const double setup_ns = elapsed_ns(start);
+
+        std::vector<FieldT> a(input);
+        a.resize(domain->m, FieldT::zero());
+
+        for (size_t o = 0; o < ops.size(); o++)
+        {
+          benchmark_result r;
+          r.curve = curve;
+          r.domain = options.domains[d];
+          r.op = ops[o];
+          r.size = n;
+          r.domain_size = domain->m;
+          r.threads = options.threads[t];
+          r.setup_ns = setup_ns;
+
+          for (size_t i = 0; i < options.warmup; i++) run_op(ops[o], domain.get(), a, other, g);
+          for (size_t i = 0; i < options.repetitions; i++)
+          {
+            r.samples_ns.push_back(run_op(ops[o], domain.get(), a, other, g));
+          }
+          results.push_back(r);
+        }
+      }
+
+      if (contains(options.ops, "poly_mul"))
+      {
+        benchmark_result r;
+        r.curve = curve;
+        r.domain = "automatic";
+        r.op = "poly_mul";
+        r.size = n;
+        r.domain_size = libff::get_power_of_two(2 * n - 1);
+        r.threads = options.threads[t];
+
+        /* The multiplication has no domain to set up: report its first (cold) call instead */
+        r.setup_ns = run_op("poly_mul", (evaluation_domain<FieldT>*)nullptr, input, other, g);
+
+        for (size_t i = 0; i < options.warmup; i++) run_op("poly_mul", (evaluation_domain<FieldT>*)nullptr, input, other, g);
+        for (size_t i = 0; i < options.repetitions; i++)
+        {
+          r.samples_ns.push_back(run_op("poly_mul", (evaluation_domain<FieldT>*)nullptr, input, other, g));
+        }
+        results.push_back(r);
+      }
+    }
+  }
+}
+
+/*
+ * The nearest-rank q-quantile of the sorted samples.
+ */
+double quantile(const std::vector<double> &sorted, const double q)
+{
+  if (sorted.empty()) return 0;
+  size_t rank = (size_t)std::ceil(q * sorted.size());
+  if (rank > 0) rank--;
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void write_json(std::ostream &out, const benchmark_options &options, const std::vector<benchmark_result> &results)
+{
+  char date[64];
+  const time_t now = time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+  out << "{\n";
+  out << "  \"context\": {\n";
+  out << "    \"date\": \"" << date << "\",\n";
+#ifdef MULTICORE
+  out << "    \"multicore\": true,\n";
+  out << "    \"max_threads\": " << omp_get_max_threads() << ",\n";
+#else
+  out << "    \"multicore\": false,\n";
+  out << "    \"max_threads\": 1,\n";
+#endif
+  out << "    \"repetitions\": " << options.repetitions << ",\n";
+  out << "    \"warmup\": " << options.warmup << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [";
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const benchmark_result &r = results[i];
+    std::vector<double> sorted(r.samples_ns);
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0;
+    for (size_t j = 0; j < sorted.size(); j++) mean += sorted[j];
+    if (!sorted.empty()) mean /= sorted.size();
+
+    const double median = quantile(sorted, 0.5);
+
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {";
+    out << "\"name\": \"" << r.curve << "/" << r.domain << "/" << r.op << "/" << r.size << "/threads:" << r.threads << "\", ";
+    out << "\"curve\": \"" << r.curve << "\", ";
+    out << "\"domain\": \"" << r.domain << "\", ";
+    out << "\"op\": \"" << r.op << "\", ";
+    out << "\"size\": " << r.size << ", ";
+    out << "\"domain_size\": " << r.domain_size << ", ";
+    out << "\"threads\": " << r.threads << ", ";
+    out << "\"setup_ns\": " << (size_t)r.setup_ns << ", ";
+    out << "\"repetitions\": " << sorted.size() << ", ";
+    out << "\"min_ns\": " << (size_t)(sorted.empty() ? 0 : sorted.front()) << ", ";
+    out << "\"median_ns\": " << (size_t)median << ", ";
+    out << "\"mean_ns\": " << (size_t)mean << ", ";
+    out << "\"p99_ns\": " << (size_t)quantile(sorted, 0.99);
+
+    /* Nominal radix-2 butterfly count (m/2) log2(m) of the transforms, also for the other domains */
+    if (r.op != "lagrange" && r.op != "poly_mul" && r.domain_size > 1)
+    {
+      const double butterflies = 0.5 * r.domain_size * std::ceil(std::log2((double)r.domain_size));
+      out << ", \"ns_per_butterfly\": " << median / butterflies;
+    }
+    out << "}";
+  }
+
+  out << "\n  ]\n";
+  out << "}\n";
+}
+
+void usage()
+{
+  printf("./benchmark [options]\n");
+  printf("  --sizes=N,...        domain sizes (default: 1024,4096,16384,65536)\n");
+  printf("  --threads=T,...      thread counts (default: 1 and the maximum)\n");
+  printf("  --curves=C,...       alt_bn128, bn128, mnt4, mnt6, edwards, double (default: all built)\n");
+  printf("  --domains=D,...      basic_radix2, extended_radix2, step_radix2, geometric_sequence,\n");
+  printf("                       arithmetic_sequence (default: basic_radix2)\n");
+  printf("  --ops=O,...          fft, ifft, coset_fft, icoset_fft, lagrange, poly_mul (default: all)\n");
+  printf("  --repetitions=R      timed repetitions per case (default: 10)\n");
+  printf("  --warmup=W           untimed repetitions per case (default: 1)\n");
+  printf("  --out=FILE           write the JSON report to FILE (default: standard output)\n");
+}
+
+int main(int argc, char* argv[])
+{
+  benchmark_options options;
+  options.sizes = { 1024, 4096, 16384, 65536 };
+  options.threads.push_back(1);
+#ifdef MULTICORE
+  if (omp_get_max_threads() > 1) options.threads.push_back(omp_get_max_threads());
+#endif
+  options.curves = to_list(all_curves);
+  options.domains = std::vector<std::string>(1, "basic_radix2");
+  options.ops = to_list(all_ops);
+  options.repetitions = 10;
+  options.warmup = 1;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg(argv[i]);
+    const size_t eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string value = (eq == std::string::npos ? "" : arg.substr(eq + 1));
+
+    if (key == "--sizes")
+    {
+      options.sizes.clear();
+      const std::vector<std::string> list = split(value);
+      for (size_t j = 0; j < list.size(); j++) options.sizes.push_back(strtoull(list[j].c_str(), nullptr, 10));
+    }
+    else if (key == "--threads")
+    {
+      options.threads.clear();
+      const std::vector<std::string> list = split(value);
+      for (size_t j = 0; j < list.size(); j++) options.threads.push_back(atoi(list[j].c_str()));
+    }
+    else if (key == "--curves") options.curves = split(value);
+    else if (key == "--domains") options.domains = split(value);
+    else if (key == "--ops") options.ops = split(value);
+    else if (key == "--repetitions") options.repetitions = strtoull(value.c_str(), nullptr, 10);
+    else if (key == "--warmup") options.warmup = strtoull(value.c_str(), nullptr, 10);
+    else if (key == "--out") options.out = value;
+    else
+    {
+      usage();
+      return (key == "--help" ? 0 : 1);
+    }
+  }
+
+  for (size_t i = 0; i < options.curves.size(); i++)
+  {
+    if (!contains(to_list(all_curves), options.curves[i])) { fprintf(stderr, "unknown curve: %s\n", options.curves[i].c_str()); return 1; }
+  }
+  for (size_t i = 0; i < options.domains.size(); i++)
+  {
+    if (!contains(to_list(all_domains), options.domains[i])) { fprintf(stderr, "unknown domain: %s\n", options.domains[i].c_str()); return 1; }
+  }
+  for (size_t i = 0; i < options.ops.size(); i++)
+  {
+    if (!contains(to_list(all_ops), options.ops[i])) { fprintf(stderr, "unknown op: %s\n", options.ops[i].c_str()); return 1; }
+  }
+
+  /* Keep the profiling output of the library out of the report */
+  libff::inhibit_profiling_info = true;
+
+  std::vector<benchmark_result> results;
+  for (size_t i = 0; i < options.curves.size(); i++)
+  {
+    const std::string &curve = options.curves[i];
+    if (curve == "alt_bn128")
+    {
+      libff::alt_bn128_pp::init_public_params();
+      benchmark_curve<libff::Fr<libff::alt_bn128_pp> >(curve, options, results);
+    }
+    else if (curve == "bn128")
+    {
+#ifdef CURVE_BN128
+      libff::bn128_pp::init_public_params();
+      benchmark_curve<libff::Fr<libff::bn128_pp> >(curve, options, results);
+#else
+      fprintf(stderr, "skipping bn128: libff was not built with CURVE=BN128\n");
+#endif
+    }
+    else if (curve == "mnt4")
+    {
+      libff::mnt4_pp::init_public_params();
+      benchmark_curve<libff::Fr<libff::mnt4_pp> >(curve, options, results);
+    }
+    else if (curve == "mnt6")
+    {
+      libff::mnt6_pp::init_public_params();
+      benchmark_curve<libff::Fr<libff::mnt6_pp> >(curve, options, results);
+    }
+    else if (curve == "edwards")
+    {
+      libff::edwards_pp::init_public_params();
+      benchmark_curve<libff::Fr<libff::edwards_pp> >(curve, options, results);
+    }
+    else if (curve == "double")
+    {
+      benchmark_curve<libff::Double>(curve, options, results);
+    }
+  }
+
+  if (options.out.empty())
+  {
+    write_json(std::cout, options, results);
+  }
+  else
+  {
+    std::ofstream out_file(options.out.c_str());
+    write_json(out_file, options, results);
+  }
+
+  return 0;
+}
@@ -5,7 +5,22 @@
  * @copyright  MIT license (see LICENSE file)
  *****************************************************************************/
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -14,11 +29,19 @@
 
 #include <libfqfft/evaluation_domain/domains/arithmetic_sequence_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/basic_radix2_domain.hpp>
+#include <libfqfft/evaluation_domain/domains/distributed_radix2_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/extended_radix2_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/geometric_sequence_domain.hpp>
 #include <libfqfft/evaluation_domain/domains/step_radix2_domain.hpp>
+#include <libfqfft/evaluation_domain/domains/streaming_radix2_domain.hpp>
+#include <libfqfft/evaluation_domain/evaluation_pipeline.hpp>
+#include <libfqfft/evaluation_domain/get_evaluation_domain.hpp>
 #include <libfqfft/polynomial_arithmetic/naive_evaluate.hpp>
+#include <libfqfft/tools/batch_inversion.hpp>
+#include <libfqfft/tools/binary_serialization.hpp>
 #include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
 
 namespace libfqfft {
 
@@ -235,4 +258,1216 @@ namespace libfqfft {
     }
   }
 
+  TYPED_TEST(EvaluationDomainTest, TwiddleBudget) {
+
+    const size_t m = 16;
+    std::vector<TypeParam> f = { 2, 5, 3, 8, 1, 7, 4, 4, 9, 0, 6, 2, 3, 1, 8, 5 };
+
+    /* All stages, the first two stages, and no stage tabulated */
+    const size_t budgets[] = { std::numeric_limits<size_t>::max(), 6 * sizeof(TypeParam), 0 };
+
+    basic_radix2_domain<TypeParam> domain(m);
+    for (size_t budget : budgets)
+    {
+      domain.set_twiddle_budget(budget);
+
+      std::vector<TypeParam> a(f);
+      domain.FFT(a);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        TypeParam e = evaluate_polynomial(m, f, domain.get_domain_element(i));
+        EXPECT_TRUE(e == a[i]);
+      }
+
+      domain.iFFT(a);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        EXPECT_TRUE(f[i] == a[i]);
+      }
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, BitreversedFFT) {
+
+    const size_t m = 16;
+    std::vector<TypeParam> f = { 2, 5, 3, 8, 1, 7, 4, 4, 9, 0, 6, 2, 3, 1, 8, 5 };
+    const TypeParam omega = libff::get_root_of_unity<TypeParam>(m);
+
+    std::vector<TypeParam> a(f);
+    _basic_serial_radix2_FFT(a, omega);
+
+    std::vector<TypeParam> b(f);
+    _basic_serial_radix2_FFT_bitreversed_output(b, omega);
+
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(a[i] == b[libff::bitreverse(i, libff::log2(m))]);
+    }
+
+    _basic_serial_radix2_FFT_bitreversed_input(b, omega.inverse());
+
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(f[i] * TypeParam(m) == b[i]);
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, CodeletFFT) {
+
+    /* Sizes below, at and above the codelet size, with and without twiddle tables */
+    for (size_t m = 2; m <= 128; m *= 2)
+    {
+      std::vector<TypeParam> f(m);
+      for (size_t i = 0; i < m; i++)
+      {
+        f[i] = TypeParam((i * 3) % 7);
+      }
+
+      basic_radix2_domain<TypeParam> domain(m);
+      for (size_t budget = 0; budget <= 1; budget++)
+      {
+        domain.set_twiddle_budget(budget == 0 ? 0 : std::numeric_limits<size_t>::max());
+
+        std::vector<TypeParam> a(f);
+        domain.FFT(a);
+        for (size_t i = 0; i < m; i++)
+        {
+          EXPECT_TRUE(evaluate_polynomial(m, f, domain.get_domain_element(i)) == a[i]);
+        }
+
+        std::vector<TypeParam> b(f);
+        _basic_serial_radix2_FFT_bitreversed_output(b, domain.omega, domain.twiddles);
+        for (size_t i = 0; i < m; i++)
+        {
+          EXPECT_TRUE(a[i] == b[libff::bitreverse(i, libff::log2(m))]);
+        }
+      }
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, Radix4FFT) {
+
+    /* Odd and even numbers of stages, with a full, partial or empty twiddle table */
+    for (size_t m = 2; m <= 1024; m *= 2)
+    {
+      std::vector<TypeParam> f(m);
+      for (size_t i = 0; i < m; i++)
+      {
+        f[i] = TypeParam((i * 5) % 11);
+      }
+
+      basic_radix2_domain<TypeParam> domain(m);
+      const std::vector<TypeParam> full(domain.twiddles);
+      const std::vector<TypeParam> partial(full.begin(), full.begin() + (std::min(m, (size_t)16) - 1));
+      const std::vector<TypeParam> tables[] = { full, partial, std::vector<TypeParam>() };
+
+      std::vector<TypeParam> expected(f);
+      _basic_serial_radix2_FFT(expected, domain.omega, full);
+      for (size_t i = 0; i < m; i += 37)
+      {
+        EXPECT_TRUE(evaluate_polynomial(m, f, domain.get_domain_element(i)) == expected[i]);
+      }
+
+      for (size_t t = 0; t < 3; t++)
+      {
+        std::vector<TypeParam> a(f);
+        _basic_serial_radix4_FFT(a.data(), m, domain.omega, tables[t]);
+        for (size_t i = 0; i < m; i++)
+        {
+          EXPECT_TRUE(expected[i] == a[i]);
+        }
+      }
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, Radix4Domains) {
+
+    /* The domains run their leaves on the radix-4 kernel, and agree with the radix-2 one */
+    const size_t saved_radix = fft_leaf_radix();
+    const size_t sizes[] = { 32, 48, 64, (size_t)1 << 15 };
+    for (size_t m : sizes)
+    {
+      std::vector<TypeParam> f(m);
+      for (size_t i = 0; i < m; i++)
+      {
+        f[i] = TypeParam((i * 3) % 7);
+      }
+
+      /* The large size (split by the recursive kernel) on the basic domain only, whose values stay small enough for Double */
+      std::shared_ptr<evaluation_domain<TypeParam> > domain;
+      for (int key = 0; key < (m <= 64 ? 3 : 1); key++)
+      {
+        try
+        {
+          if (key == 0) domain.reset(new basic_radix2_domain<TypeParam>(m));
+          else if (key == 1) domain.reset(new extended_radix2_domain<TypeParam>(m));
+          else domain.reset(new step_radix2_domain<TypeParam>(m));
+
+          std::vector<TypeParam> expected(f), expected_inverse(f);
+          set_fft_leaf_radix(2);
+          domain->FFT(expected);
+          domain->iFFT(expected_inverse);
+
+          std::vector<TypeParam> a(f), b(f);
+          set_fft_leaf_radix(4);
+          domain->FFT(a);
+          domain->iFFT(b);
+          for (size_t i = 0; i < m; i++)
+          {
+            EXPECT_TRUE(expected[i] == a[i]);
+            EXPECT_TRUE(expected_inverse[i] == b[i]);
+          }
+        }
+        catch(DomainSizeException &e)
+        {
+          printf("%s - skipping\n", e.what());
+        }
+        catch(InvalidSizeException &e)
+        {
+          printf("%s - skipping\n", e.what());
+        }
+      }
+    }
+
+    /* The streaming and distributed domains, against the basic one */
+    const size_t m = 64;
+    std::vector<TypeParam> f(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      f[i] = TypeParam((i * 5) % 13);
+    }
+
+    basic_radix2_domain<TypeParam> domain(m);
+    std::vector<TypeParam> expected(f);
+    set_fft_leaf_radix(2);
+    domain.FFT(expected);
+
+    set_fft_leaf_radix(4);
+    streaming_radix2_domain<TypeParam> streaming(m, 4 * streaming_radix2_domain<TypeParam>(m, m * sizeof(TypeParam)).num_rows() * sizeof(TypeParam));
+    std::vector<TypeParam> a(f), scratch(m);
+    memory_fft_storage<TypeParam> sa(a), s(scratch);
+    streaming.FFT(sa, s);
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(expected[i] == a[i]);
+    }
+
+    distributed_radix2_domain<TypeParam> node(m, 1, 0,
+      [](const TypeParam *send, TypeParam *recv, const size_t block_size) {
+        std::copy(send, send + block_size, recv);
+      });
+    std::vector<TypeParam> part(m);
+    for (size_t j = 0; j < m; j++)
+    {
+      part[j] = f[node.input_index(j)];
+    }
+    node.FFT(part);
+    for (size_t j = 0; j < m; j++)
+    {
+      EXPECT_TRUE(part[j] == expected[node.output_index(j)]);
+    }
+
+    bool caught = false;
+    try { set_fft_leaf_radix(8); } catch (const InvalidSizeException &e) { caught = true; }
+    EXPECT_TRUE(caught);
+    EXPECT_EQ(fft_leaf_radix(), (size_t)4);
+
+    set_fft_leaf_radix(saved_radix);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, BlockedFFT) {
+
+    /* Large enough for the recursive kernel to split the transform */
+    const size_t m = (size_t)1 << 15;
+    std::vector<TypeParam> f(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      f[i] = TypeParam(i % 10);
+    }
+
+    basic_radix2_domain<TypeParam> domain(m);
+    std::vector<TypeParam> a(f);
+    domain.FFT(a);
+
+    /* Evaluations at 1 and -1 */
+    TypeParam sum = TypeParam::zero();
+    TypeParam alternating_sum = TypeParam::zero();
+    for (size_t i = 0; i < m; i++)
+    {
+      sum += f[i];
+      alternating_sum += (i % 2 == 0 ? f[i] : -f[i]);
+    }
+    EXPECT_TRUE(sum == a[0]);
+    EXPECT_TRUE(alternating_sum == a[m/2]);
+
+    domain.iFFT(a);
+
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(f[i] == a[i]);
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, FusedCosetFFT) {
+
+    const size_t m = 16;
+    std::vector<TypeParam> f = { 2, 5, 3, 8, 1, 7, 4, 4, 9, 0, 6, 2, 3, 1, 8, 5 };
+
+    TypeParam coset = TypeParam::multiplicative_generator;
+
+    /* Tabulated and on-the-fly twiddle factors */
+    const size_t budgets[] = { std::numeric_limits<size_t>::max(), 0 };
+
+    basic_radix2_domain<TypeParam> domain(m);
+    for (size_t budget : budgets)
+    {
+      domain.set_twiddle_budget(budget);
+
+      std::vector<TypeParam> a(f);
+      domain.cosetFFT(a, coset);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        TypeParam e = evaluate_polynomial(m, f, coset * domain.get_domain_element(i));
+        EXPECT_TRUE(e == a[i]);
+      }
+
+      domain.icosetFFT(a, coset);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        EXPECT_TRUE(f[i] == a[i]);
+      }
+    }
+
+    /* Large enough for the output scaling to follow a split transform (g^i overflows a Double at that size) */
+    if (std::is_same<TypeParam, libff::Double>::value) return;
+
+    const size_t big_m = (size_t)1 << 15;
+    std::vector<TypeParam> g(big_m);
+    for (size_t i = 0; i < big_m; i++)
+    {
+      g[i] = TypeParam(i % 10);
+    }
+
+    basic_radix2_domain<TypeParam> big_domain(big_m);
+    std::vector<TypeParam> b(g);
+    big_domain.cosetFFT(b, coset);
+    big_domain.icosetFFT(b, coset);
+
+    for (size_t i = 0; i < big_m; i++)
+    {
+      EXPECT_TRUE(g[i] == b[i]);
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, OutOfPlaceFFT) {
+
+    for (int key = 0; key < 3; key++)
+    {
+      /*
+       extended_radix2 only takes m = 2^{s+1} (too large to check here) except over Double,
+       where its second half is shifted by 25 and the values soon outgrow the precision.
+       step_radix2 at a size that exercises its folding (big_m = 8, small_m = 4).
+       */
+      if (key == 1 && !std::is_same<TypeParam, libff::Double>::value) continue;
+      const size_t m = (key == 0 ? 16 : key == 1 ? 4 : 12);
+      std::vector<TypeParam> f(m);
+      for (size_t i = 0; i < m; i++)
+      {
+        f[i] = TypeParam((i * 7 + 2) % 10);
+      }
+
+      std::shared_ptr<evaluation_domain<TypeParam> > domain;
+      if (key == 0) domain.reset(new basic_radix2_domain<TypeParam>(m));
+      else if (key == 1) domain.reset(new extended_radix2_domain<TypeParam>(m));
+      else domain.reset(new step_radix2_domain<TypeParam>(m));
+
+      /* From one vector to another */
+      std::vector<TypeParam> a(m);
+      domain->FFT(f.data(), a.data(), m);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        TypeParam e = evaluate_polynomial(m, f, domain->get_domain_element(i));
+        EXPECT_TRUE(e == a[i]);
+      }
+
+      std::vector<TypeParam> b(m);
+      domain->iFFT(a.data(), b.data(), m);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        EXPECT_TRUE(f[i] == b[i]);
+      }
+
+      /* In place, with the same pointer as input and output */
+      std::vector<TypeParam> c(f);
+      domain->FFT(c.data(), c.data(), m);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        EXPECT_TRUE(a[i] == c[i]);
+      }
+
+      domain->iFFT(c.data(), c.data(), m);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        EXPECT_TRUE(f[i] == c[i]);
+      }
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, BatchFFT) {
+
+    const size_t m = 4;
+    std::vector<std::vector<TypeParam> > fs = { { 2, 5, 3, 8 }, { 1, 0, 7, 4 }, { 9, 6, 2, 3 } };
+
+    TypeParam coset = TypeParam::multiplicative_generator;
+
+    std::shared_ptr<evaluation_domain<TypeParam> > domain;
+    for (int key = 0; key < 5; key++)
+    {
+      try
+      {
+        if (key == 0) domain.reset(new basic_radix2_domain<TypeParam>(m));
+        else if (key == 1) domain.reset(new extended_radix2_domain<TypeParam>(m));
+        else if (key == 2) domain.reset(new step_radix2_domain<TypeParam>(m));
+        else if (key == 3) domain.reset(new geometric_sequence_domain<TypeParam>(m));
+        else if (key == 4) domain.reset(new arithmetic_sequence_domain<TypeParam>(m));
+
+        std::vector<std::vector<TypeParam> > as(fs);
+        std::vector<std::vector<TypeParam>*> ptrs;
+        for (size_t j = 0; j < as.size(); j++)
+        {
+          ptrs.push_back(&as[j]);
+        }
+
+        domain->FFT_batch(ptrs);
+        for (size_t j = 0; j < fs.size(); j++)
+        {
+          std::vector<TypeParam> a(fs[j]);
+          domain->FFT(a);
+          for (size_t i = 0; i < m; i++)
+          {
+            EXPECT_TRUE(a[i] == as[j][i]);
+          }
+        }
+
+        domain->iFFT_batch(ptrs);
+        for (size_t j = 0; j < fs.size(); j++)
+        {
+          for (size_t i = 0; i < m; i++)
+          {
+            EXPECT_TRUE(fs[j][i] == as[j][i]);
+          }
+        }
+
+        /* As in InverseCosetFFTofCosetFFT, only the radix-2 domains support cosets */
+        if (key > 2) continue;
+
+        domain->cosetFFT_batch(ptrs, coset);
+        for (size_t j = 0; j < fs.size(); j++)
+        {
+          std::vector<TypeParam> a(fs[j]);
+          domain->cosetFFT(a, coset);
+          for (size_t i = 0; i < m; i++)
+          {
+            EXPECT_TRUE(a[i] == as[j][i]);
+          }
+        }
+
+        domain->icosetFFT_batch(ptrs, coset);
+        for (size_t j = 0; j < fs.size(); j++)
+        {
+          for (size_t i = 0; i < m; i++)
+          {
+            EXPECT_TRUE(fs[j][i] == as[j][i]);
+          }
+        }
+      }
+      catch(const DomainSizeException &e)
+      {
+        printf("%s - skipping\n", e.what());
+      }
+      catch(const InvalidSizeException &e)
+      {
+        printf("%s - skipping\n", e.what());
+      }
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, DomainRegistry) {
+
+    typedef evaluation_domain_registry<TypeParam> registry;
+    registry::clear();
+
+    std::shared_ptr<evaluation_domain<TypeParam> > a = get_evaluation_domain<TypeParam>(8);
+    std::shared_ptr<evaluation_domain<TypeParam> > b = get_evaluation_domain<TypeParam>(8);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a->m >= 8);
+
+    /* A different kind is a different key */
+    std::shared_ptr<evaluation_domain<TypeParam> > c = get_evaluation_domain<TypeParam>(8, evaluation_domain_kind::geometric_sequence);
+    EXPECT_TRUE(a != c);
+    EXPECT_EQ(c->m, 8u);
+
+    registry::prewarm({ 16, 32 }, evaluation_domain_kind::automatic, true);
+    EXPECT_EQ(registry::size(), 4u);
+    std::shared_ptr<evaluation_domain<TypeParam> > d = get_evaluation_domain<TypeParam>(16);
+
+    /* Only pinned domains survive clear() */
+    registry::clear();
+    EXPECT_EQ(registry::size(), 2u);
+    EXPECT_TRUE(get_evaluation_domain<TypeParam>(16) == d);
+    EXPECT_TRUE(get_evaluation_domain<TypeParam>(8) != a);
+
+    /* Requests that resolve to the same domain share it */
+    const size_t entries = registry::size();
+    EXPECT_TRUE(get_evaluation_domain<TypeParam>(8, evaluation_domain_kind::basic_radix2) == get_evaluation_domain<TypeParam>(8));
+    EXPECT_EQ(registry::size(), entries);
+
+    /* The shared domains are ready to use */
+    std::vector<TypeParam> f = { 2, 5, 3, 8, 1, 7, 4, 4 };
+    std::vector<TypeParam> e(f);
+    c->FFT(e);
+    c->iFFT(e);
+    for (size_t i = 0; i < 8; i++)
+    {
+      EXPECT_TRUE(f[i] == e[i]);
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, SequencePrecomputation) {
+
+    const size_t m = 4;
+    std::vector<TypeParam> f = { 2, 5, 3, 8 };
+
+    geometric_sequence_domain<TypeParam> geometric(m);
+    geometric.precompute();
+    geometric.precompute();
+
+    const TypeParam g = TypeParam::geometric_generator();
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(geometric.geometric_sequence[i] == (g^i));
+      EXPECT_TRUE(geometric.geometric_triangular_sequence[i] == (g^(i*(i-1)/2)) || i == 0);
+    }
+
+    arithmetic_sequence_domain<TypeParam> arithmetic(m);
+    arithmetic.precompute();
+    EXPECT_EQ(arithmetic.subproduct_tree.size(), libff::log2(m) + 1);
+
+    std::vector<TypeParam> a(f);
+    std::vector<TypeParam> b(f);
+    geometric.FFT(a);
+    arithmetic.FFT(b);
+
+    for (size_t i = 0; i < m; i++)
+    {
+      EXPECT_TRUE(evaluate_polynomial(m, f, geometric.get_domain_element(i)) == a[i]);
+      EXPECT_TRUE(evaluate_polynomial(m, f, arithmetic.get_domain_element(i)) == b[i]);
+    }
+  }
+
+  TYPED_TEST(EvaluationDomainTest, BatchInversion) {
+
+    const size_t n = 1000;
+    std::vector<TypeParam> a(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      a[i] = TypeParam(i + 1);
+    }
+
+    std::vector<TypeParam> a_inverse(a);
+    batch_inversion(a_inverse);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      EXPECT_TRUE(a[i] * a_inverse[i] == TypeParam::one());
+    }
+
+    std::vector<TypeParam> empty;
+    batch_inversion(empty);
+    EXPECT_TRUE(empty.empty());
+  }
+
+  TYPED_TEST(EvaluationDomainTest, BinarySerialization) {
+
+    const size_t n = 37;
+    std::vector<TypeParam> v(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      v[i] = TypeParam(3 * i + 1);
+    }
+
+    std::stringstream ss;
+    write_binary(ss, v);
+    write_binary(ss, v, false);
+
+    std::vector<TypeParam> w, u;
+    read_binary(ss, w);
+    read_binary(ss, u);
+    EXPECT_TRUE(w == v);
+    EXPECT_TRUE(u == v);
+
+    /* A corrupted element fails the checksum */
+    std::string bytes;
+    {
+      std::stringstream corrupted;
+      write_binary(corrupted, v);
+      bytes = corrupted.str();
+    }
+    bytes[sizeof(binary_vector_header) + 3] ^= 1;
+    std::stringstream corrupted(bytes);
+    bool caught = false;
+    try { read_binary(corrupted, w); } catch (...) { caught = true; }
+    EXPECT_TRUE(caught);
+
+    /* Memory-mapped records, one after the other */
+    const std::string path = ::testing::TempDir() + "libfqfft_binary_serialization_test.bin";
+    {
+      std::ofstream out(path.c_str(), std::ios::binary);
+      write_binary(out, v);
+      write_binary(out, v.data(), 5);
+    }
+    {
+      mapped_binary_vector<TypeParam> first(path, 0, true);
+      mapped_binary_vector<TypeParam> second(path, first.next_offset());
+      EXPECT_EQ(first.size(), n);
+      EXPECT_EQ(second.size(), 5u);
+      EXPECT_TRUE(std::vector<TypeParam>(first.begin(), first.end()) == v);
+      EXPECT_TRUE(std::vector<TypeParam>(second.begin(), second.end()) == std::vector<TypeParam>(v.begin(), v.begin() + 5));
+    }
+    std::remove(path.c_str());
+
+    /* Forged lengths: beyond the end of the stream or file, or wrapping the end of the record */
+    const uint64_t forged_lengths[] = { (uint64_t)1 << 40, std::numeric_limits<uint64_t>::max() / sizeof(TypeParam) + 1 };
+    for (const uint64_t length : forged_lengths)
+    {
+      std::string forged;
+      {
+        std::stringstream out;
+        write_binary(out, v);
+        forged = out.str();
+      }
+      binary_vector_header header;
+      std::memcpy(&header, forged.data(), sizeof(header));
+      header.length = length;
+      std::memcpy(&forged[0], &header, sizeof(header));
+
+      std::stringstream in(forged);
+      caught = false;
+      try { read_binary(in, w); } catch (const SerializationException &e) { caught = true; }
+      EXPECT_TRUE(caught);
+
+      {
+        std::ofstream out(path.c_str(), std::ios::binary);
+        out.write(forged.data(), forged.size());
+      }
+      caught = false;
+      try { mapped_binary_vector<TypeParam> mapped(path); } catch (const SerializationException &e) { caught = true; }
+      EXPECT_TRUE(caught);
+      std::remove(path.c_str());
+    }
+
+    /* Precomputed domains give the same transforms once loaded into a new domain */
+    const size_t m = 8;
+    std::vector<TypeParam> f(v.begin(), v.begin() + m);
+    std::stringstream saved;
+
+    basic_radix2_domain<TypeParam> radix2(m);
+    geometric_sequence_domain<TypeParam> geometric(m);
+    arithmetic_sequence_domain<TypeParam> arithmetic(m);
+    radix2.save_precomputation(saved);
+    geometric.save_precomputation(saved);
+    arithmetic.save_precomputation(saved);
+
+    basic_radix2_domain<TypeParam> loaded_radix2(m);
+    geometric_sequence_domain<TypeParam> loaded_geometric(m);
+    arithmetic_sequence_domain<TypeParam> loaded_arithmetic(m);
+    loaded_radix2.load_precomputation(saved);
+    loaded_geometric.load_precomputation(saved);
+    loaded_arithmetic.load_precomputation(saved);
+    EXPECT_TRUE(loaded_geometric.precomputation_sentinel);
+    EXPECT_TRUE(loaded_arithmetic.precomputation_sentinel);
+
+    std::vector<evaluation_domain<TypeParam>*> domains = { &radix2, &geometric, &arithmetic };
+    std::vector<evaluation_domain<TypeParam>*> loaded_domains = { &loaded_radix2, &loaded_geometric, &loaded_arithmetic };
+    for (size_t k = 0; k < domains.size(); k++)
+    {
+      std::vector<TypeParam> a(f), b(f);
+      domains[k]->FFT(a);
+      loaded_domains[k]->FFT(b);
+      EXPECT_TRUE(a == b);
+
+      domains[k]->iFFT(a);
+      loaded_domains[k]->iFFT(b);
+      EXPECT_TRUE(a == b);
+    }
+
+    /* A domain of another size rejects the saved tables */
+    geometric_sequence_domain<TypeParam> other(2 * m);
+    std::stringstream saved_geometric;
+    geometric.save_precomputation(saved_geometric);
+    caught = false;
+    try { other.load_precomputation(saved_geometric); } catch (...) { caught = true; }
+    EXPECT_TRUE(caught);
+
+    /* The factories load the saved tables in place of the precomputation */
+    const std::string tables = saved_geometric.str();
+    std::stringstream in_create(tables), in_registry(tables), in_other(tables);
+    std::shared_ptr<evaluation_domain<TypeParam> > created =
+      create_evaluation_domain<TypeParam>(m, evaluation_domain_kind::geometric_sequence, in_create);
+    evaluation_domain_registry<TypeParam>::clear();
+    std::shared_ptr<evaluation_domain<TypeParam> > shared =
+      get_evaluation_domain<TypeParam>(m, evaluation_domain_kind::geometric_sequence, in_registry);
+    for (size_t k = 0; k < 2; k++)
+    {
+      std::vector<TypeParam> a(f), b(f);
+      geometric.FFT(a);
+      (k == 0 ? created : shared)->FFT(b);
+      EXPECT_TRUE(a == b);
+    }
+
+    caught = false;
+    try { create_evaluation_domain<TypeParam>(2 * m, evaluation_domain_kind::geometric_sequence, in_other); }
+    catch (const SerializationException &e) { caught = true; }
+    EXPECT_TRUE(caught);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, StreamingFFT) {
+
+    for (size_t m = 64; m <= 128; m *= 2)
+    {
+      std::vector<TypeParam> f(m);
+      for (size_t i = 0; i < m; i++)
+      {
+        f[i] = TypeParam((i * 7) % 11);
+      }
+
+      basic_radix2_domain<TypeParam> domain(m);
+
+      /* Panels of 2 columns and blocks of a few rows */
+      streaming_radix2_domain<TypeParam> streaming(m, 4 * streaming_radix2_domain<TypeParam>(m, m * sizeof(TypeParam)).num_rows() * sizeof(TypeParam));
+      EXPECT_EQ(streaming.num_rows() * streaming.num_columns(), m);
+
+      /* A coset shift of unit size, so that Double keeps its precision */
+      const TypeParam g = libff::get_root_of_unity<TypeParam>(2 * m);
+      std::vector<TypeParam> scratch(m);
+      memory_fft_storage<TypeParam> s(scratch);
+
+      for (int key = 0; key < 4; key++)
+      {
+        std::vector<TypeParam> a(f), b(f);
+        memory_fft_storage<TypeParam> sa(a);
+        if (key == 0) { domain.FFT(b); streaming.FFT(sa, s); }
+        else if (key == 1) { domain.iFFT(b); streaming.iFFT(sa, s); }
+        else if (key == 2) { domain.cosetFFT(b, g); streaming.cosetFFT(sa, s, g); }
+        else { domain.icosetFFT(b, g); streaming.icosetFFT(sa, s, g); }
+
+        for (size_t i = 0; i < m; i++)
+        {
+          EXPECT_TRUE(a[i] == b[i]);
+        }
+      }
+
+      /* Through files */
+      const std::string path = ::testing::TempDir() + "libfqfft_streaming_fft_test.bin";
+      const std::string scratch_path = ::testing::TempDir() + "libfqfft_streaming_fft_scratch.bin";
+      {
+        file_fft_storage<TypeParam> fa(path, m), fs(scratch_path, m);
+        fa.write(0, f.data(), m);
+        streaming.FFT(fa, fs);
+        streaming.iFFT(fa, fs);
+
+        std::vector<TypeParam> a(m);
+        fa.read(0, a.data(), m);
+        for (size_t i = 0; i < m; i++)
+        {
+          EXPECT_TRUE(a[i] == f[i]);
+        }
+      }
+      std::remove(path.c_str());
+      std::remove(scratch_path.c_str());
+
+      /* A read past the end of the file is an I/O error */
+      {
+        file_fft_storage<TypeParam> empty(path, m);
+        std::vector<TypeParam> a(m);
+        bool io_error = false;
+        try { empty.read(0, a.data(), m); } catch (const SerializationException &e) { io_error = true; }
+        EXPECT_TRUE(io_error);
+      }
+      std::remove(path.c_str());
+    }
+
+    bool caught = false;
+    try { streaming_radix2_domain<TypeParam>(1024, sizeof(TypeParam)); } catch (...) { caught = true; }
+    EXPECT_TRUE(caught);
+  }
+
+  /**
+   * An all-to-all between the threads of one process, standing for the nodes of a distributed_radix2_domain.
+   */
+  template<typename FieldT>
+  class thread_all_to_all {
+    public:
+      thread_all_to_all(const size_t num_nodes) : num_nodes(num_nodes), sends(num_nodes), arrived(0), generation(0) {}
+
+      void exchange(const size_t rank, const FieldT *send, FieldT *recv, const size_t block_size) {
+        sends[rank] = send;
+        barrier();
+        for (size_t q = 0; q < num_nodes; q++)
+        {
+          std::copy(sends[q] + rank * block_size, sends[q] + (rank + 1) * block_size, recv + q * block_size);
+        }
+        barrier();
+      }
+
+    private:
+      void barrier() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const size_t g = generation;
+        if (++arrived == num_nodes)
+        {
+          arrived = 0;
+          ++generation;
+          cv.notify_all();
+        }
+        else
+        {
+          cv.wait(lock, [&]() { return generation != g; });
+        }
+      }
+
+      size_t num_nodes;
+      std::vector<const FieldT*> sends;
+      size_t arrived;
+      size_t generation;
+      std::mutex mutex;
+      std::condition_variable cv;
+  };
+
+  TYPED_TEST(EvaluationDomainTest, DistributedFFT) {
+
+    const size_t m = 64;
+    std::vector<TypeParam> f(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      f[i] = TypeParam((i * 5) % 13);
+    }
+
+    basic_radix2_domain<TypeParam> domain(m);
+    const TypeParam g = libff::get_root_of_unity<TypeParam>(2 * m);
+
+    for (size_t num_nodes = 1; num_nodes <= 8; num_nodes *= 2)
+    {
+      thread_all_to_all<TypeParam> transport(num_nodes);
+      std::vector<std::unique_ptr<distributed_radix2_domain<TypeParam> > > nodes;
+      for (size_t rank = 0; rank < num_nodes; rank++)
+      {
+        nodes.emplace_back(new distributed_radix2_domain<TypeParam>(m, num_nodes, rank,
+          [&transport, rank](const TypeParam *send, TypeParam *recv, const size_t block_size) {
+            transport.exchange(rank, send, recv, block_size);
+          }));
+      }
+      const size_t L = nodes[0]->local_size();
+      EXPECT_EQ(L * num_nodes, m);
+
+      for (int key = 0; key < 4; key++)
+      {
+        std::vector<TypeParam> expected(f);
+        if (key == 0) domain.FFT(expected);
+        else if (key == 1) domain.iFFT(expected);
+        else if (key == 2) domain.cosetFFT(expected, g);
+        else domain.icosetFFT(expected, g);
+
+        /* The forward transforms go from the input split to the output split, and the inverse ones back */
+        const bool forward = (key == 0 || key == 2);
+        std::vector<std::vector<TypeParam> > parts(num_nodes, std::vector<TypeParam>(L));
+        for (size_t rank = 0; rank < num_nodes; rank++)
+        {
+          for (size_t j = 0; j < L; j++)
+          {
+            parts[rank][j] = f[forward ? nodes[rank]->input_index(j) : nodes[rank]->output_index(j)];
+          }
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t rank = 0; rank < num_nodes; rank++)
+        {
+          threads.emplace_back([&, rank]() {
+            if (key == 0) nodes[rank]->FFT(parts[rank]);
+            else if (key == 1) nodes[rank]->iFFT(parts[rank]);
+            else if (key == 2) nodes[rank]->cosetFFT(parts[rank], g);
+            else nodes[rank]->icosetFFT(parts[rank], g);
+          });
+        }
+        for (size_t rank = 0; rank < num_nodes; rank++)
+        {
+          threads[rank].join();
+        }
+
+        for (size_t rank = 0; rank < num_nodes; rank++)
+        {
+          for (size_t j = 0; j < L; j++)
+          {
+            EXPECT_TRUE(parts[rank][j] == expected[forward ? nodes[rank]->output_index(j) : nodes[rank]->input_index(j)]);
+          }
+        }
+      }
+    }
+
+    bool caught = false;
+    try { distributed_radix2_domain<TypeParam>(m, 16, 0, nullptr); } catch (...) { caught = true; }
+    EXPECT_TRUE(caught);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, Instrumentation) {
+
+    const size_t m = 64;
+    std::vector<TypeParam> f(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      f[i] = TypeParam(i % 5 + 1);
+    }
+
+    basic_radix2_domain<TypeParam> domain(m);
+
+    size_t num_callbacks = 0;
+    reset_instrumentation();
+    set_instrumentation_callback([&num_callbacks](const std::string &method, const instrumentation_method_statistics &call) {
+        if (method == "basic_radix2_domain::FFT" && call.calls == 1) num_callbacks++;
+      });
+
+    std::vector<TypeParam> a(f);
+    domain.FFT(a);
+    batch_inversion(a);
+    domain.evaluate_all_lagrange_polynomials(TypeParam(7));
+    set_instrumentation_callback(instrumentation_callback());
+
+    const std::map<std::string, instrumentation_method_statistics> statistics = instrumentation_statistics();
+    const instrumentation_counters totals = instrumentation_total_counters();
+    if (!instrumentation_enabled())
+    {
+      EXPECT_TRUE(statistics.empty());
+      EXPECT_EQ(totals.multiplications, 0u);
+      EXPECT_EQ(num_callbacks, 0u);
+      return;
+    }
+
+    /* The n/2 * log(n) butterflies of the FFT, and the inversions and allocations of the rest on top */
+    ASSERT_EQ(statistics.count("basic_radix2_domain::FFT"), 1u);
+    const instrumentation_method_statistics &s = statistics.find("basic_radix2_domain::FFT")->second;
+    EXPECT_EQ(s.calls, 1u);
+    EXPECT_EQ(s.counters.multiplications, (uint64_t)(m / 2 * 6));
+    EXPECT_EQ(s.counters.additions, (uint64_t)(m * 6));
+    EXPECT_EQ(s.counters.inversions, 0u);
+    EXPECT_GE(s.seconds, 0);
+    EXPECT_EQ(num_callbacks, 1u);
+
+    EXPECT_GE(totals.multiplications, s.counters.multiplications);
+    EXPECT_GE(totals.inversions, 1u);
+    ASSERT_EQ(statistics.count("basic_radix2_domain::evaluate_all_lagrange_polynomials"), 1u);
+    EXPECT_GE(statistics.find("basic_radix2_domain::evaluate_all_lagrange_polynomials")->second.counters.bytes_allocated, m * sizeof(TypeParam));
+    EXPECT_GE(totals.bytes_allocated, m * sizeof(TypeParam));
+
+    EXPECT_NE(instrumentation_json().find("\"basic_radix2_domain::FFT\": {\"calls\": 1,"), std::string::npos);
+    EXPECT_NE(instrumentation_prometheus().find("libfqfft_method_calls_total{method=\"basic_radix2_domain::FFT\"} 1\n"), std::string::npos);
+
+    /* The calls of another thread are merged in, also after it has exited */
+    std::thread other([&domain, &f]() {
+        std::vector<TypeParam> b(f);
+        domain.FFT(b);
+      });
+    other.join();
+    EXPECT_EQ(instrumentation_statistics().find("basic_radix2_domain::FFT")->second.calls, 2u);
+
+    reset_instrumentation();
+    EXPECT_TRUE(instrumentation_statistics().empty());
+    EXPECT_EQ(instrumentation_thread_counters().multiplications, 0u);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, InstrumentationAtExit) {
+
+    /*
+     A process that exits while the threads of the default pool are alive: they unregister
+     from the instrumentation after the static destructors have run. (The child process
+     runs this test alone, so the pool and the registry are created there by the task.)
+     */
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT({
+        execution_async(std::shared_ptr<execution_policy>(), []() {
+            basic_radix2_domain<TypeParam> domain(64);
+            std::vector<TypeParam> a(64, TypeParam::one());
+            domain.FFT(a);
+          }).get();
+        std::exit(0);
+      }, ::testing::ExitedWithCode(0), "");
+  }
+
+  TYPED_TEST(EvaluationDomainTest, ExecutionPolicy) {
+
+    const size_t m = 1024;
+    std::vector<TypeParam> f(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      f[i] = TypeParam(i % 7 + 1);
+    }
+
+    std::vector<TypeParam> expected(f);
+    basic_radix2_domain<TypeParam>(m).FFT(expected);
+
+    /* A pool set on the domain, and a per-call cap below it */
+    std::shared_ptr<execution_policy> pool(new thread_pool_execution_policy(4));
+    EXPECT_EQ(pool->concurrency(), 4u);
+
+    basic_radix2_domain<TypeParam> domain(m);
+    domain.set_execution_policy(pool);
+    std::vector<TypeParam> a(f);
+    domain.FFT(a);
+    EXPECT_TRUE(a == expected);
+
+    {
+      const execution_scope scope(pool, 2);
+      EXPECT_EQ(execution_concurrency(), 2u);
+      {
+        const execution_scope inner(nullptr, 3);
+        EXPECT_EQ(execution_concurrency(), 2u);
+      }
+
+      std::vector<size_t> hits(100, 0);
+      parallel_for(hits.size(), [&hits](const size_t i) { hits[i]++; });
+      EXPECT_EQ(std::count(hits.begin(), hits.end(), (size_t)1), 100);
+
+      a = f;
+      domain.FFT(a);
+      EXPECT_TRUE(a == expected);
+    }
+
+    const execution_scope sequential(std::shared_ptr<execution_policy>(new sequential_execution_policy()));
+    EXPECT_EQ(execution_concurrency(), 1u);
+
+    /* Concurrent transforms sharing the pool, each also running nested loops through it */
+    std::vector<std::vector<TypeParam> > results(4, f);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++)
+    {
+      threads.push_back(std::thread([&domain, &results, t]() { domain.FFT(results[t]); }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+      threads[t].join();
+    }
+    for (size_t t = 0; t < results.size(); t++)
+    {
+      EXPECT_TRUE(results[t] == expected);
+    }
+
+    /* An exception of one of the chunks comes back to the caller, and the pool still works */
+    bool thrown = false;
+    try
+    {
+      pool->run(16, [](const size_t c) { if (c == 5) throw InvalidSizeException("chunk 5"); });
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+
+    /* A loop run under a lock does not pick up submitted work that takes the same lock */
+    std::mutex lock;
+    std::promise<void> submitted_done;
+    std::vector<size_t> hits(64, 0);
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      pool->submit([&lock, &submitted_done]() {
+          std::lock_guard<std::mutex> inner(lock);
+          submitted_done.set_value();
+        });
+      pool->run(hits.size(), [&hits](const size_t c) { hits[c]++; });
+    }
+    submitted_done.get_future().get();
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), (size_t)1), 64);
+
+    a = f;
+    domain.FFT(a);
+    EXPECT_TRUE(a == expected);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, AsyncPipeline) {
+
+    const size_t m = 64;
+    const TypeParam coset = TypeParam::multiplicative_generator;
+    std::vector<std::vector<TypeParam> > inputs(3, std::vector<TypeParam>(m));
+    for (size_t k = 0; k < 3; k++)
+    {
+      for (size_t i = 0; i < m; i++)
+      {
+        inputs[k][i] = TypeParam((i + k) % 5 + 1);
+      }
+    }
+
+    /* H = (A * B - C) / Z on the coset, from the evaluations of A, B and C over the domain */
+    basic_radix2_domain<TypeParam> reference(m);
+    std::vector<std::vector<TypeParam> > expected(inputs);
+    for (size_t k = 0; k < 3; k++)
+    {
+      reference.iFFT(expected[k]);
+      reference.cosetFFT(expected[k], coset);
+    }
+    std::vector<TypeParam> expected_H(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      expected_H[i] = expected[0][i] * expected[1][i] - expected[2][i];
+    }
+    reference.divide_by_Z_on_coset(expected_H);
+
+    std::shared_ptr<execution_policy> pool(new thread_pool_execution_policy(3));
+    basic_radix2_domain<TypeParam> domain(m);
+    domain.set_execution_policy(pool);
+
+    /* Independent transforms, as futures */
+    std::vector<std::vector<TypeParam> > v(inputs);
+    std::vector<std::future<void> > futures;
+    for (size_t k = 0; k < 3; k++)
+    {
+      futures.push_back(domain.iFFT_async(v[k]));
+    }
+    for (size_t k = 0; k < 3; k++)
+    {
+      futures[k].get();
+      futures[k] = domain.cosetFFT_async(v[k], coset);
+    }
+    for (size_t k = 0; k < 3; k++)
+    {
+      futures[k].get();
+      EXPECT_TRUE(v[k] == expected[k]);
+    }
+
+    /* The same chains as stages, with H waiting for the three of them only */
+    for (size_t p = 0; p < 2; p++)
+    {
+      evaluation_pipeline<TypeParam> pipeline(p == 0 ? pool : std::shared_ptr<execution_policy>());
+      std::vector<std::vector<TypeParam> > w(inputs);
+      std::vector<TypeParam> H(m);
+      std::vector<size_t> chains;
+      for (size_t k = 0; k < 3; k++)
+      {
+        chains.push_back(pipeline.cosetFFT(domain, w[k], coset, { pipeline.iFFT(domain, w[k]) }));
+      }
+      const size_t h = pipeline.add([&H, &w, m]() {
+          for (size_t i = 0; i < m; i++)
+          {
+            H[i] = w[0][i] * w[1][i] - w[2][i];
+          }
+        }, chains);
+      pipeline.divide_by_Z_on_coset(domain, H, { h });
+
+      pipeline.run().get();
+      EXPECT_TRUE(H == expected_H);
+    }
+
+    /* A stage that throws skips the stages after it, and its exception comes back through the future */
+    evaluation_pipeline<TypeParam> failing(pool);
+    std::vector<TypeParam> wrong_size(m + 1);
+    bool later_stage_ran = false;
+    failing.add([&later_stage_ran]() { later_stage_ran = true; }, { failing.FFT(domain, wrong_size) });
+    std::future<void> result = failing.run();
+    bool thrown = false;
+    try
+    {
+      result.get();
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    EXPECT_FALSE(later_stage_ran);
+
+    thrown = false;
+    try
+    {
+      failing.add([]() {});
+    }
+    catch (const std::logic_error &e)
+    {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+
+    /* Without a policy, the calls and the stages run on the default pool */
+    basic_radix2_domain<TypeParam> plain(m);
+    std::vector<TypeParam> a(inputs[0]);
+    plain.iFFT_async(a).get();
+    plain.cosetFFT_async(a, coset).get();
+    EXPECT_TRUE(a == expected[0]);
+  }
+
+  TYPED_TEST(EvaluationDomainTest, LagrangeBatch) {
+
+    const size_t m = 8;
+
+    std::shared_ptr<evaluation_domain<TypeParam> > domain;
+    for (int key = 0; key < 5; key++)
+    {
+      for (int pooled = 0; pooled < 2; pooled++)
+      {
+        try
+        {
+          if (key == 0) domain.reset(new basic_radix2_domain<TypeParam>(m));
+          else if (key == 1) domain.reset(new extended_radix2_domain<TypeParam>(m));
+          else if (key == 2) domain.reset(new step_radix2_domain<TypeParam>(m));
+          else if (key == 3) domain.reset(new geometric_sequence_domain<TypeParam>(m));
+          else if (key == 4) domain.reset(new arithmetic_sequence_domain<TypeParam>(m));
+
+          if (pooled) domain->set_execution_policy(std::shared_ptr<execution_policy>(new thread_pool_execution_policy(3)));
+
+          std::vector<TypeParam> d(m);
+          for (size_t i = 0; i < m; i++)
+          {
+            d[i] = domain->get_domain_element(i);
+          }
+
+          /* Points outside of the domain, and one of its elements */
+          std::vector<TypeParam> ts = { TypeParam(10), TypeParam(3), d[5], TypeParam(11) };
+          const size_t k = ts.size();
+
+          std::vector<TypeParam> batch(k * m);
+          domain->evaluate_all_lagrange_polynomials_batch(ts, batch.data());
+
+          for (size_t j = 0; j < k; j++)
+          {
+            const std::vector<TypeParam> a = domain->evaluate_all_lagrange_polynomials(ts[j]);
+            std::vector<TypeParam> b(m);
+            domain->evaluate_all_lagrange_polynomials(ts[j], b.data());
+
+            for (size_t i = 0; i < m; i++)
+            {
+              const TypeParam e = (j == 2 ? (i == 5 ? TypeParam::one() : TypeParam::zero())
+                                          : evaluate_lagrange_polynomial(m, d, ts[j], i));
+              EXPECT_TRUE(e == a[i]);
+              EXPECT_TRUE(a[i] == b[i]);
+              EXPECT_TRUE(a[i] == batch[j * m + i]);
+            }
+          }
+        }
+        catch(const DomainSizeException &e)
+        {
+          printf("%s - skipping\n", e.what());
+        }
+        catch(const InvalidSizeException &e)
+        {
+          printf("%s - skipping\n", e.what());
+        }
+      }
+    }
+  }
+
 } // libfqfft
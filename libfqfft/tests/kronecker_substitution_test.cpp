@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <gtest/gtest.h>
+#include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <stdint.h>
 
 #include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
@@ -53,4 +54,34 @@ namespace libfqfft {
     }
   }
 
+  template <typename T>
+  class KroneckerSubstitutionFieldTest : public ::testing::Test {
+    protected:
+      virtual void SetUp() {
+        libff::mnt4_pp::init_public_params();
+      }
+  };
+  typedef ::testing::Types<libff::Fr<libff::mnt4_pp> > PrimeFieldT; /* List Extend Here */
+  TYPED_TEST_CASE(KroneckerSubstitutionFieldTest, PrimeFieldT);
+
+  TYPED_TEST(KroneckerSubstitutionFieldTest, FullSizeCoefficients) {
+
+    for (size_t n : { 1, 2, 7, 100, 1000 })
+    {
+      std::vector<TypeParam> a(n), b(n + 5);
+      for (size_t i = 0; i < a.size(); i++) a[i] = TypeParam::random_element();
+      for (size_t i = 0; i < b.size(); i++) b[i] = -TypeParam::random_element();
+
+      std::vector<TypeParam> c, c_answer;
+      _polynomial_multiplication_on_kronecker(c, a, b);
+      _polynomial_multiplication_on_fft(c_answer, a, b);
+      EXPECT_TRUE(c == c_answer);
+
+      /* Squaring, in place */
+      _polynomial_multiplication_on_fft(c_answer, a, std::vector<TypeParam>(a));
+      _polynomial_multiplication_on_kronecker(a, a, a);
+      EXPECT_TRUE(a == c_answer);
+    }
+  }
+
 } // libfqfft
@@ -8,9 +8,14 @@
 #include <vector>
 
 #include <gtest/gtest.h>
+#include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <stdint.h>
 
 #include <libfqfft/polynomial_arithmetic/basic_operations.hpp>
+#include <libfqfft/polynomial_arithmetic/basis_change.hpp>
+#include <libfqfft/polynomial_arithmetic/multipoint_evaluation.hpp>
+#include <libfqfft/polynomial_arithmetic/naive_evaluate.hpp>
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.hpp>
 #include <libfqfft/polynomial_arithmetic/xgcd.hpp>
 
 namespace libfqfft {
@@ -180,6 +185,40 @@ namespace libfqfft {
     }
   }
 
+  TYPED_TEST(PolynomialArithmeticTest, PolynomialInPlace) {
+
+    std::vector<TypeParam> a = { 1, 3, 4, 25, 6 };
+    std::vector<TypeParam> b = { 9, 3, 11, 14, 7, 1, 5, 8 };
+
+    _polynomial_addition_in_place(a, b);
+    std::vector<TypeParam> sum_ans = { 10, 6, 15, 39, 13, 1, 5, 8 };
+    EXPECT_TRUE(a == sum_ans);
+
+    _polynomial_subtraction_in_place(a, b);
+    std::vector<TypeParam> difference_ans = { 1, 3, 4, 25, 6 };
+    EXPECT_TRUE(a == difference_ans);
+
+    _polynomial_scale_in_place(a, TypeParam(2));
+    std::vector<TypeParam> scale_ans = { 2, 6, 8, 50, 12 };
+    EXPECT_TRUE(a == scale_ans);
+
+    std::vector<TypeParam> c = { 1, 1 };
+    _polynomial_multiplication_in_place(c, std::vector<TypeParam>({ 1, 1 }));
+    std::vector<TypeParam> product_ans = { 1, 2, 1 };
+    EXPECT_TRUE(c == product_ans);
+
+    /* Long enough for the element-wise loops to be split across threads */
+    const size_t n = 5000;
+    std::vector<TypeParam> x(n), y(n + 3);
+    for (size_t i = 0; i < n; i++) x[i] = TypeParam((long)(i % 97));
+    for (size_t i = 0; i < n + 3; i++) y[i] = TypeParam((long)(i % 89 + 1));
+
+    std::vector<TypeParam> z(x);
+    _polynomial_addition_in_place(z, y);
+    _polynomial_subtraction_in_place(z, x);
+    EXPECT_TRUE(z == y);
+  }
+
   TYPED_TEST(PolynomialArithmeticTest, PolynomialMultiplicationBasic) {
 
     std::vector<TypeParam> a = { 5, 0, 0, 13, 0, 1 };
@@ -212,6 +251,119 @@ namespace libfqfft {
     }
   }
 
+  template<typename FieldT>
+  void check_multiplication_algorithms()
+  {
+    const size_t sizes[][2] = { { 1, 1 }, { 3, 7 }, { 40, 40 }, { 100, 37 }, { 137, 200 }, { 500, 130 } };
+    for (size_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++)
+    {
+      std::vector<FieldT> a(sizes[t][0]), b(sizes[t][1]);
+      for (size_t i = 0; i < a.size(); i++) a[i] = FieldT((long)((i * 7 + 3) % 10));
+      for (size_t i = 0; i < b.size(); i++) b[i] = FieldT((long)((i * 5 + 1) % 9));
+
+      std::vector<FieldT> c_answer;
+      _polynomial_multiplication_on_schoolbook(c_answer, a, b);
+
+      std::vector<FieldT> c;
+      _polynomial_multiplication_on_karatsuba(c, a, b);
+      EXPECT_TRUE(c == c_answer);
+      _polynomial_multiplication_on_toom3(c, a, b);
+      EXPECT_TRUE(c == c_answer);
+      _polynomial_multiplication_on_fft(c, a, b);
+      EXPECT_TRUE(c == c_answer);
+      _polynomial_multiplication(c, a, b);
+      EXPECT_TRUE(c == c_answer);
+
+      /* In place */
+      _polynomial_multiplication_on_toom3(a, a, b);
+      EXPECT_TRUE(a == c_answer);
+    }
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, MultiplicationAlgorithms) {
+
+    check_multiplication_algorithms<TypeParam>();
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, PolynomialSquaring) {
+
+    std::vector<TypeParam> a = { 5, 0, 0, 13, 0, 1 };
+    std::vector<TypeParam> c;
+
+    _polynomial_squaring(c, a);
+
+    std::vector<TypeParam> c_ans = { 25, 0, 0, 130, 0, 10, 169, 0, 26, 0, 1 };
+    EXPECT_TRUE(c == c_ans);
+
+    /* In place, and through _polynomial_multiplication with the same vector twice */
+    _polynomial_multiplication(a, a, a);
+    EXPECT_TRUE(a == c_ans);
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, PretransformedOperand) {
+
+    std::vector<TypeParam> a = { 5, 0, 0, 13, 0, 1 };
+    pretransformed_operand<TypeParam> A(a, 16);
+    EXPECT_EQ(A.size(), 6u);
+    EXPECT_EQ(A.transform_size(), 16u);
+
+    std::vector<TypeParam> b = { 13, 0, 1 };
+    std::vector<TypeParam> c;
+    _polynomial_multiplication_on_fft(c, A, b);
+    std::vector<TypeParam> c_ans = { 65, 0, 5, 169, 0, 26, 0, 1 };
+    EXPECT_TRUE(c == c_ans);
+
+    /* The same operand, against others (in place) */
+    std::vector<TypeParam> d = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    std::vector<TypeParam> d_ans;
+    _polynomial_multiplication(d_ans, a, d);
+    _polynomial_multiplication_on_fft(d, A, d);
+    EXPECT_TRUE(d == d_ans);
+
+    /* The product would not fit in the transform */
+    std::vector<TypeParam> e(12, TypeParam::one());
+    bool thrown = false;
+    try
+    {
+      _polynomial_multiplication_on_fft(c, A, e);
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, MultiplicationTranspose) {
+
+    const size_t n = 4;
+    std::vector<TypeParam> a = { 1, 3, 4, 25, 6 };
+    const size_t m = a.size();
+
+    for (size_t s = 1; s <= m + n + 1; s++)
+    {
+      std::vector<TypeParam> c(s);
+      for (size_t i = 0; i < s; i++) c[i] = TypeParam((long)(i * 3 % 7 + 1));
+
+      /* The middle slice of rev(A) * C, by schoolbook multiplication */
+      std::vector<TypeParam> r(m + s - 1, TypeParam::zero());
+      for (size_t i = 0; i < m; i++)
+      {
+        for (size_t j = 0; j < s; j++)
+        {
+          r[i + j] += a[m - 1 - i] * c[j];
+        }
+      }
+      std::vector<TypeParam> answer(n + 1, TypeParam::zero());
+      for (size_t k = 0; k <= n && m - 1 + k < r.size(); k++) answer[k] = r[m - 1 + k];
+
+      EXPECT_TRUE(_polynomial_multiplication_transpose(n, a, c) == answer);
+
+      _polynomial_multiplication_transpose(c, n, a, c);
+      EXPECT_TRUE(c == answer);
+    }
+  }
+
   TYPED_TEST(PolynomialArithmeticTest, PolynomialDivision) {
 
     std::vector<TypeParam> a = { 5, 0, 0, 13, 0, 1 };
@@ -235,6 +387,77 @@ namespace libfqfft {
     }
   }
 
+  TYPED_TEST(PolynomialArithmeticTest, InversePowerSeries) {
+
+    const size_t n = 100;
+    std::vector<TypeParam> f = { 1, 1, 1 };
+
+    std::vector<TypeParam> g;
+    _polynomial_inverse_power_series(g, f, n);
+    EXPECT_EQ(g.size(), n);
+
+    std::vector<TypeParam> c;
+    _polynomial_multiplication(c, f, g);
+    c.resize(n, TypeParam::zero());
+
+    EXPECT_TRUE(c[0] == TypeParam::one());
+    for (size_t i = 1; i < n; i++)
+    {
+      EXPECT_TRUE(c[i] == TypeParam::zero());
+    }
+  }
+
+  template<typename FieldT>
+  void check_polynomial_division_newton()
+  {
+    /* A = Q * B + R, with B and Q of degree 600 (above LIBFQFFT_NEWTON_DIVISION_THRESHOLD) */
+    std::vector<FieldT> b(601, FieldT::zero());
+    b[0] = 1;
+    b[7] = 2;
+    b[600] = 1;
+
+    std::vector<FieldT> Q_ans(601), R_ans(600);
+    for (size_t i = 0; i < Q_ans.size(); i++) Q_ans[i] = FieldT((i * 7) % 11);
+    for (size_t i = 0; i < R_ans.size(); i++) R_ans[i] = FieldT((i * 5) % 13);
+    Q_ans.back() = FieldT::one();
+    R_ans.back() = FieldT::one();
+
+    std::vector<FieldT> a;
+    _polynomial_multiplication(a, Q_ans, b);
+    _polynomial_addition(a, a, R_ans);
+
+    std::vector<FieldT> Q(1, FieldT::zero());
+    std::vector<FieldT> R(1, FieldT::zero());
+    _polynomial_division(Q, R, a, b);
+
+    std::vector<FieldT> Q_euclidean(1, FieldT::zero());
+    std::vector<FieldT> R_euclidean(1, FieldT::zero());
+    _polynomial_division_euclidean(Q_euclidean, R_euclidean, a, b);
+
+    EXPECT_EQ(Q.size(), Q_ans.size());
+    EXPECT_EQ(R.size(), R_ans.size());
+    for (size_t i = 0; i < Q.size(); i++)
+    {
+      EXPECT_TRUE(Q_ans[i] == Q[i]);
+      EXPECT_TRUE(Q_euclidean[i] == Q[i]);
+    }
+    for (size_t i = 0; i < R.size(); i++)
+    {
+      EXPECT_TRUE(R_ans[i] == R[i]);
+      EXPECT_TRUE(R_euclidean[i] == R[i]);
+    }
+
+    /* Smaller dividends than divisors leave everything in the remainder */
+    _polynomial_division_newton(Q, R, R_ans, b);
+    EXPECT_TRUE(_is_zero(Q));
+    EXPECT_EQ(R.size(), R_ans.size());
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, PolynomialDivisionNewton) {
+
+    check_polynomial_division_newton<TypeParam>();
+  }
+
   TYPED_TEST(PolynomialArithmeticTest, ExtendedGCD) {
 
     std::vector<TypeParam> a = { 0, 0, 0, 0, 1 };
@@ -254,4 +477,172 @@ namespace libfqfft {
     }
   }
 
+  template<typename FieldT>
+  void check_subproduct_tree(const size_t m)
+  {
+    std::vector<FieldT> points((size_t)1 << m);
+    for (size_t j = 0; j < points.size(); j++) points[j] = FieldT((j * 3 + 1) % 1009);
+
+    flat_subproduct_tree<FieldT> T;
+    compute_subproduct_tree(points, T);
+    EXPECT_EQ(T.size(), m + 1);
+
+    for (size_t i = 1; i <= m; i++)
+    {
+      EXPECT_EQ(T.num_nodes(i), (size_t)1 << (m - i));
+      for (size_t j = 0; j < T.num_nodes(i); j++)
+      {
+        std::vector<FieldT> c;
+        _polynomial_multiplication(c, T.node_vector(i-1, 2*j), T.node_vector(i-1, 2*j+1));
+        EXPECT_TRUE(c == T.node_vector(i, j));
+      }
+    }
+
+    const std::vector<FieldT> root = T.node_vector(m, 0);
+    for (size_t j = 0; j < points.size(); j++)
+    {
+      EXPECT_TRUE(evaluate_polynomial(root.size(), root, points[j]) == FieldT::zero());
+    }
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, SubproductTree) {
+
+    /* Small enough for the coefficients of Double to keep their precision */
+    check_subproduct_tree<TypeParam>(3);
+  }
+
+  template<typename FieldT>
+  void check_newton_basis_change(const size_t m, const long range)
+  {
+    const size_t n = (size_t)1 << m;
+    std::vector<FieldT> points(n);
+    for (size_t j = 0; j < n; j++) points[j] = FieldT((long)(j * 3 + 1) % range);
+
+    flat_subproduct_tree<FieldT> T;
+    compute_subproduct_tree(points, T);
+
+    std::vector<FieldT> newton(n);
+    for (size_t i = 0; i < n; i++) newton[i] = FieldT((long)(i % 5 + 1));
+
+    /* sum_i newton[i] * prod_{k < i} (x - points[k]) */
+    std::vector<FieldT> monomial(n, FieldT::zero()), basis(1, FieldT::one());
+    for (size_t i = 0; i < n; i++)
+    {
+      for (size_t k = 0; k < basis.size(); k++) monomial[k] += newton[i] * basis[k];
+
+      basis.push_back(FieldT::zero());
+      for (size_t k = basis.size() - 1; k > 0; k--) basis[k] = basis[k-1] - points[i] * basis[k];
+      basis[0] = -points[i] * basis[0];
+    }
+
+    std::vector<FieldT> a(newton);
+    newton_to_monomial_basis(a, T, n);
+    EXPECT_TRUE(a == monomial);
+
+    monomial_to_newton_basis(a, T, n);
+    EXPECT_TRUE(a == newton);
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, NewtonBasisChange) {
+
+    /* Small enough for the coefficients of Double to keep their precision */
+    check_newton_basis_change<TypeParam>(3, 2);
+  }
+
+  template<typename FieldT>
+  void check_multipoint_evaluation(const size_t n)
+  {
+    std::vector<FieldT> p(n), points(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      p[i] = FieldT((i * 11 + 4) % 17);
+      points[i] = FieldT((i * 7 + 3) % n);
+    }
+
+    std::vector<FieldT> values = multipoint_evaluate(p, points);
+    EXPECT_EQ(values.size(), n);
+    for (size_t i = 0; i < n; i++)
+    {
+      EXPECT_TRUE(evaluate_polynomial(n, p, points[i]) == values[i]);
+    }
+
+    std::vector<FieldT> q = multipoint_interpolate(points, values);
+    EXPECT_EQ(q.size(), n);
+    for (size_t i = 0; i < n; i++)
+    {
+      EXPECT_TRUE(p[i] == q[i]);
+    }
+  }
+
+  TYPED_TEST(PolynomialArithmeticTest, MultipointEvaluation) {
+
+    /* A number of points that is not a power of 2, small enough for Double */
+    check_multipoint_evaluation<TypeParam>(5);
+  }
+
+  template <typename T>
+  class PolynomialArithmeticFieldTest : public ::testing::Test {
+    protected:
+      virtual void SetUp() {
+        libff::mnt4_pp::init_public_params();
+      }
+  };
+  typedef ::testing::Types<libff::Fr<libff::mnt4_pp> > PrimeFieldT; /* List Extend Here */
+  TYPED_TEST_CASE(PolynomialArithmeticFieldTest, PrimeFieldT);
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, MultiplicationAlgorithms) {
+
+    check_multiplication_algorithms<TypeParam>();
+  }
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, PolynomialDivisionNewton) {
+
+    check_polynomial_division_newton<TypeParam>();
+  }
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, HalfGCD) {
+
+    /* A and B of degrees 900 and 700, with a common factor C of degree 100 */
+    std::vector<TypeParam> a(801), b(601), c(101);
+    for (size_t i = 0; i < a.size(); i++) a[i] = TypeParam((i * i + 3) % 101);
+    for (size_t i = 0; i < b.size(); i++) b[i] = TypeParam((i * 7 + 1) % 103);
+    for (size_t i = 0; i < c.size(); i++) c[i] = TypeParam((i * 5 + 2) % 107);
+    _polynomial_multiplication(a, a, c);
+    _polynomial_multiplication(b, b, c);
+
+    std::vector<TypeParam> g, u, v;
+    _polynomial_xgcd(a, b, g, u, v);
+
+    std::vector<TypeParam> g_ans, u_ans, v_ans;
+    _polynomial_xgcd_euclidean(a, b, g_ans, u_ans, v_ans);
+
+    EXPECT_EQ(g.size(), c.size());
+    EXPECT_TRUE(g == g_ans);
+    EXPECT_TRUE(u == u_ans);
+    EXPECT_TRUE(v == v_ans);
+
+    /* G = A * U + B * V */
+    std::vector<TypeParam> au, bv, s;
+    _polynomial_multiplication(au, a, u);
+    _polynomial_multiplication(bv, b, v);
+    _polynomial_addition(s, au, bv);
+    EXPECT_TRUE(s == g);
+  }
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, SubproductTree) {
+
+    /* Large enough for the FFT products */
+    check_subproduct_tree<TypeParam>(7);
+  }
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, NewtonBasisChange) {
+
+    check_newton_basis_change<TypeParam>(7, 7);
+  }
+
+  TYPED_TEST(PolynomialArithmeticFieldTest, MultipointEvaluation) {
+
+    check_multipoint_evaluation<TypeParam>(300);
+  }
+
 } // libfqfft
@@ -0,0 +1,37 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of batch inversion routines.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BATCH_INVERSION_HPP_
+#define BATCH_INVERSION_HPP_
+
+#include <vector>
+
+namespace libfqfft {
+
+/**
+ * Replace each of the n elements starting at a, which must all be nonzero, by its inverse.
+ *
+ * This uses Montgomery's trick: one inversion and 3(n-1) multiplications instead of n
+ * inversions. Under MULTICORE, the elements are split into one range per thread, each
+ * with an inversion of its own. (For libff::Double, whose inversion is cheap and whose
+ * running products would quickly lose precision, the elements are inverted one by one.)
+ */
+template<typename FieldT>
+void batch_inversion(FieldT *a, const size_t n);
+
+template<typename FieldT>
+void batch_inversion(std::vector<FieldT> &a);
+
+} // libfqfft
+
+#include <libfqfft/tools/batch_inversion.tcc>
+
+#endif // BATCH_INVERSION_HPP_
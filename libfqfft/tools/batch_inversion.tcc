@@ -0,0 +1,84 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of batch inversion routines.
+
+ See batch_inversion.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BATCH_INVERSION_TCC_
+#define BATCH_INVERSION_TCC_
+
+#include <algorithm>
+#include <type_traits>
+
+#include <libff/common/double.hpp>
+
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
+
+namespace libfqfft {
+
+/*
+ Invert a[0..n) with a single inversion, using prefix[0..n) as scratch:
+ prefix[i] = a[0] * ... * a[i-1], so that a[i]^{-1} = prefix[i] * (a[0] * ... * a[i])^{-1}.
+ */
+template<typename FieldT>
+void _batch_inversion_serial(FieldT *a, const size_t n, FieldT *prefix)
+{
+    if (n == 0) return;
+
+    FieldT acc = FieldT::one();
+    for (size_t i = 0; i < n; ++i)
+    {
+        prefix[i] = acc;
+        acc *= a[i];
+    }
+
+    FieldT acc_inverse = acc.inverse();
+    for (size_t i = n; i-- > 0; )
+    {
+        const FieldT a_i = a[i];
+        a[i] = acc_inverse * prefix[i];
+        acc_inverse *= a_i;
+    }
+}
+
+template<typename FieldT>
+void batch_inversion(FieldT *a, const size_t n)
+{
+    if (std::is_same<FieldT, libff::Double>::value)
+    {
+        LIBFQFFT_COUNT_FIELD_OPERATIONS(0, 0, n);
+        parallel_for(n, [a](const size_t i) {
+                a[i] = a[i].inverse();
+            });
+        return;
+    }
+
+    std::vector<FieldT> prefix(n);
+    LIBFQFFT_COUNT_ALLOCATION(n * sizeof(FieldT));
+
+    const size_t num_chunks = std::max(std::min(execution_concurrency(), n), (size_t)1);
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(0, 3 * n, (n > 0 ? num_chunks : 0));
+
+    parallel_for(num_chunks, [&](const size_t c) {
+            const size_t start = c * n / num_chunks, end = (c + 1) * n / num_chunks;
+            _batch_inversion_serial(a + start, end - start, prefix.data() + start);
+        });
+}
+
+template<typename FieldT>
+void batch_inversion(std::vector<FieldT> &a)
+{
+    batch_inversion(a.data(), a.size());
+}
+
+} // libfqfft
+
+#endif // BATCH_INVERSION_TCC_
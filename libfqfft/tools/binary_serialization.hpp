@@ -0,0 +1,156 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of binary serialization routines for field vectors.
+
+ Unlike the text operators of serialization.hpp, these write the elements as they
+ are held in memory (for libff prime fields, their Montgomery limbs), so that a
+ vector takes sizeof(FieldT) bytes per element and reads back with a single copy,
+ or none at all through mapped_binary_vector.
+
+ A record is a binary_vector_header followed by the raw elements, padded to a
+ multiple of 8 bytes, so that records can be chained in one stream or file (as the
+ save_precomputation methods of the evaluation domains do). Streams must be opened
+ in binary mode.
+
+ The format is *not* portable: it ties the file to the field (see binary_field_id),
+ to the limb size and to the byte order of the machine that wrote it. Reading a
+ record written for anything else throws a SerializationException.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BINARY_SERIALIZATION_HPP_
+#define BINARY_SERIALIZATION_HPP_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <libfqfft/polynomial_arithmetic/pretransformed_operand.hpp>
+#include <libfqfft/polynomial_arithmetic/subproduct_tree.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LIBFQFFT_HAVE_MMAP 1
+#endif
+
+namespace libfqfft {
+
+/**
+ * Set in binary_vector_header::flags when the checksum field holds the checksum
+ * of the elements.
+ */
+const uint32_t BINARY_VECTOR_CHECKSUM = 1;
+
+struct binary_vector_header {
+    char magic[8];         /* "FQFFTVEC" */
+    uint32_t byte_order;   /* 0x01020304, as written by the machine */
+    uint32_t flags;
+    uint64_t field_id;     /* see binary_field_id */
+    uint64_t element_size; /* sizeof(FieldT) */
+    uint64_t length;       /* the number of elements */
+    uint64_t checksum;     /* see binary_checksum, if BINARY_VECTOR_CHECKSUM is set */
+};
+
+/**
+ * An identifier of FieldT: a hash of sizeof(FieldT) and of the field characteristic
+ * (for prime fields with the libff Fp_model interface) or of the type name (otherwise).
+ */
+template<typename FieldT>
+uint64_t binary_field_id();
+
+/**
+ * The 64-bit FNV-1a hash of the n bytes starting at data.
+ */
+inline uint64_t binary_checksum(const void *data, const size_t n);
+
+/**
+ * Write the n elements starting at v as one record, along with their checksum if checksum is set.
+ */
+template<typename FieldT>
+void write_binary(std::ostream &out, const FieldT *v, const size_t n, const bool checksum = true);
+
+template<typename FieldT>
+void write_binary(std::ostream &out, const std::vector<FieldT> &v, const bool checksum = true);
+
+/**
+ * Read the record at the current position of the stream into v, checking its header
+ * (and its checksum, if it has one). The length in the header is checked against the
+ * rest of the stream when it is seekable, and otherwise v only grows as the elements
+ * arrive; a record that does not fit throws a SerializationException.
+ */
+template<typename FieldT>
+void read_binary(std::istream &in, std::vector<FieldT> &v);
+
+/**
+ * Write or read a subproduct tree, as the record of all its coefficients.
+ */
+template<typename FieldT>
+void write_binary(std::ostream &out, const flat_subproduct_tree<FieldT> &T, const bool checksum = true);
+
+template<typename FieldT>
+void read_binary(std::istream &in, flat_subproduct_tree<FieldT> &T);
+
+/**
+ * Write or read a pre-transformed operand, as a record of its transform and one of its
+ * number of coefficients (so that reading it does not redo the transform).
+ */
+template<typename FieldT>
+void write_binary(std::ostream &out, const pretransformed_operand<FieldT> &a, const bool checksum = true);
+
+template<typename FieldT>
+void read_binary(std::istream &in, pretransformed_operand<FieldT> &a);
+
+/**
+ * A read-only view of the record at the given offset of a file, memory-mapped when the
+ * platform supports it (LIBFQFFT_HAVE_MMAP), so that the elements are paged in as they
+ * are used instead of being copied. Elsewhere, the elements are read into memory.
+ *
+ * The checksum, if any, is only verified when verify_checksum is set, since that reads
+ * the whole record.
+ */
+template<typename FieldT>
+class mapped_binary_vector {
+public:
+
+    mapped_binary_vector(const std::string &path, const size_t offset = 0, const bool verify_checksum = false);
+    ~mapped_binary_vector();
+
+    mapped_binary_vector(const mapped_binary_vector&) = delete;
+    mapped_binary_vector& operator=(const mapped_binary_vector&) = delete;
+
+    size_t size() const;
+    const FieldT *data() const;
+    const FieldT *begin() const;
+    const FieldT *end() const;
+    const FieldT &operator[](const size_t i) const;
+
+    /**
+     * The offset of the record that follows this one in the file.
+     */
+    size_t next_offset() const;
+
+private:
+
+    size_t length;
+    size_t end_offset;
+    const FieldT *elements;
+#ifdef LIBFQFFT_HAVE_MMAP
+    void *mapping;
+    size_t mapping_size;
+#else
+    std::vector<FieldT> contents;
+#endif
+};
+
+} // libfqfft
+
+#include <libfqfft/tools/binary_serialization.tcc>
+
+#endif // BINARY_SERIALIZATION_HPP_
@@ -0,0 +1,373 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of binary serialization routines for field vectors.
+
+ See binary_serialization.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BINARY_SERIALIZATION_TCC_
+#define BINARY_SERIALIZATION_TCC_
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+
+#ifdef LIBFQFFT_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <libfqfft/tools/exceptions.hpp>
+#include <libfqfft/tools/field_traits.hpp>
+
+namespace libfqfft {
+
+inline uint64_t binary_checksum(const void *data, const size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; i++)
+    {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+template<typename FieldT>
+uint64_t _binary_field_characteristic_id(std::true_type)
+{
+    const auto p = FieldT::field_char();
+    return binary_checksum(&p, sizeof(p));
+}
+
+template<typename FieldT>
+uint64_t _binary_field_characteristic_id(std::false_type)
+{
+    const char *name = typeid(FieldT).name();
+    return binary_checksum(name, std::strlen(name));
+}
+
+template<typename FieldT>
+uint64_t binary_field_id()
+{
+    const uint64_t size = sizeof(FieldT);
+    const uint64_t id[2] = { size, _binary_field_characteristic_id<FieldT>(std::integral_constant<bool, is_prime_field<FieldT>::value>()) };
+    return binary_checksum(id, sizeof(id));
+}
+
+/* The number of zero bytes after the n elements of a record */
+template<typename FieldT>
+size_t _binary_padding(const size_t n)
+{
+    return (8 - (n * sizeof(FieldT)) % 8) % 8;
+}
+
+/* Check a header against FieldT, and return the number of elements of its record */
+template<typename FieldT>
+size_t _check_binary_header(const binary_vector_header &header)
+{
+    if (std::memcmp(header.magic, "FQFFTVEC", 8) != 0) throw SerializationException("binary: not a field vector record");
+    if (header.byte_order != 0x01020304) throw SerializationException("binary: record written with another byte order");
+    if (header.element_size != sizeof(FieldT) || header.field_id != binary_field_id<FieldT>())
+        throw SerializationException("binary: record written for another field");
+    return header.length;
+}
+
+template<typename FieldT>
+void write_binary(std::ostream &out, const FieldT *v, const size_t n, const bool checksum)
+{
+    binary_vector_header header;
+    std::memcpy(header.magic, "FQFFTVEC", 8);
+    header.byte_order = 0x01020304;
+    header.flags = (checksum ? BINARY_VECTOR_CHECKSUM : 0);
+    header.field_id = binary_field_id<FieldT>();
+    header.element_size = sizeof(FieldT);
+    header.length = n;
+    header.checksum = (checksum ? binary_checksum(v, n * sizeof(FieldT)) : 0);
+
+    const char padding[8] = { 0 };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(v), n * sizeof(FieldT));
+    out.write(padding, _binary_padding<FieldT>(n));
+    if (!out) throw SerializationException("binary: write failed");
+}
+
+template<typename FieldT>
+void write_binary(std::ostream &out, const std::vector<FieldT> &v, const bool checksum)
+{
+    write_binary(out, v.data(), v.size(), checksum);
+}
+
+/* Read the padding of a record and check its checksum, once its n elements have been read to v */
+template<typename FieldT>
+void _read_binary_trailer(std::istream &in, const binary_vector_header &header, const FieldT *v, const size_t n)
+{
+    char padding[8];
+    in.read(padding, _binary_padding<FieldT>(n));
+    if (!in) throw SerializationException("binary: truncated record");
+
+    if ((header.flags & BINARY_VECTOR_CHECKSUM) && binary_checksum(v, n * sizeof(FieldT)) != header.checksum)
+        throw SerializationException("binary: checksum mismatch");
+}
+
+/* Read a record into the n elements starting at v, once its header has been read */
+template<typename FieldT>
+void _read_binary_elements(std::istream &in, const binary_vector_header &header, FieldT *v, const size_t n)
+{
+    in.read(reinterpret_cast<char*>(v), n * sizeof(FieldT));
+    if (!in) throw SerializationException("binary: truncated record");
+    _read_binary_trailer(in, header, v, n);
+}
+
+/* Check, when in is seekable, that the rest of the stream can hold n elements */
+template<typename FieldT>
+void _check_binary_remaining(std::istream &in, const size_t n)
+{
+    const std::streampos position = in.tellg();
+    if (position == std::streampos(-1)) return;
+
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.seekg(position);
+    if (!in || end < position || n > (size_t)(end - position) / sizeof(FieldT))
+        throw SerializationException("binary: truncated record");
+}
+
+/*
+ Read a record of n elements into v, once its header has been read. The vector grows by
+ bounded chunks as the elements arrive, so that a corrupt length in a stream that cannot
+ be checked beforehand fails as a truncated record rather than as one huge allocation.
+ */
+template<typename FieldT>
+void _read_binary_vector(std::istream &in, const binary_vector_header &header, const size_t n, std::vector<FieldT> &v)
+{
+    _check_binary_remaining<FieldT>(in, n);
+
+    const size_t chunk = std::max(((size_t)1 << 24) / sizeof(FieldT), (size_t)1);
+    try
+    {
+        v.clear();
+        for (size_t start = 0; start < n; start += chunk)
+        {
+            const size_t count = std::min(chunk, n - start);
+            v.resize(start + count);
+            in.read(reinterpret_cast<char*>(v.data() + start), count * sizeof(FieldT));
+            if (!in) throw SerializationException("binary: truncated record");
+        }
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw SerializationException("binary: record too large");
+    }
+    catch (const std::length_error &e)
+    {
+        throw SerializationException("binary: record too large");
+    }
+    _read_binary_trailer(in, header, v.data(), n);
+}
+
+template<typename FieldT>
+size_t _read_binary_header(std::istream &in, binary_vector_header &header)
+{
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in) throw SerializationException("binary: truncated header");
+    return _check_binary_header<FieldT>(header);
+}
+
+template<typename FieldT>
+void read_binary(std::istream &in, std::vector<FieldT> &v)
+{
+    binary_vector_header header;
+    const size_t n = _read_binary_header<FieldT>(in, header);
+    _read_binary_vector(in, header, n, v);
+}
+
+template<typename FieldT>
+void write_binary(std::ostream &out, const flat_subproduct_tree<FieldT> &T, const bool checksum)
+{
+    write_binary(out, T.data(), T.data_size(), checksum);
+}
+
+template<typename FieldT>
+void read_binary(std::istream &in, flat_subproduct_tree<FieldT> &T)
+{
+    binary_vector_header header;
+    const size_t n = _read_binary_header<FieldT>(in, header);
+
+    /* A tree over 2^m points has (m + 1) * 2^m + 2^{m+1} - 1 coefficients (see flat_subproduct_tree::resize) */
+    if (n == 0)
+    {
+        T = flat_subproduct_tree<FieldT>();
+        return;
+    }
+
+    _check_binary_remaining<FieldT>(in, n);
+    size_t m = 0;
+    while (m < 8 * sizeof(size_t) - 8 && ((m + 1) << m) + ((size_t)2 << m) - 1 < n) ++m;
+    if (((m + 1) << m) + ((size_t)2 << m) - 1 != n) throw SerializationException("binary: not a subproduct tree record");
+
+    try
+    {
+        T.resize(m);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw SerializationException("binary: record too large");
+    }
+    catch (const std::length_error &e)
+    {
+        throw SerializationException("binary: record too large");
+    }
+    _read_binary_elements(in, header, T.data(), n);
+}
+
+template<typename FieldT>
+void write_binary(std::ostream &out, const pretransformed_operand<FieldT> &a, const bool checksum)
+{
+    const uint64_t num_coefficients = a.size();
+    write_binary(out, &num_coefficients, 1, checksum);
+    write_binary(out, a.values(), checksum);
+}
+
+template<typename FieldT>
+void read_binary(std::istream &in, pretransformed_operand<FieldT> &a)
+{
+    std::vector<uint64_t> num_coefficients;
+    std::vector<FieldT> values;
+    read_binary(in, num_coefficients);
+    read_binary(in, values);
+    if (num_coefficients.size() != 1) throw SerializationException("binary: not a pre-transformed operand record");
+
+    try
+    {
+        a.assign_transformed(values, num_coefficients[0]);
+    }
+    catch (...)
+    {
+        throw SerializationException("binary: not a pre-transformed operand record");
+    }
+}
+
+template<typename FieldT>
+mapped_binary_vector<FieldT>::mapped_binary_vector(const std::string &path, const size_t offset, const bool verify_checksum) :
+    length(0), end_offset(0), elements(nullptr)
+#ifdef LIBFQFFT_HAVE_MMAP
+    , mapping(nullptr), mapping_size(0)
+#endif
+{
+    binary_vector_header header;
+
+#ifdef LIBFQFFT_HAVE_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw SerializationException("binary: cannot open " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < offset || (size_t)st.st_size - offset < sizeof(header))
+    {
+        close(fd);
+        throw SerializationException("binary: truncated header");
+    }
+
+    mapping_size = st.st_size;
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        throw SerializationException("binary: cannot map " + path);
+    }
+
+    try
+    {
+        const char *base = static_cast<const char*>(mapping) + offset;
+        std::memcpy(&header, base, sizeof(header));
+        length = _check_binary_header<FieldT>(header);
+        /* Bound the (untrusted) length before computing the end, which could otherwise wrap */
+        if (length > (mapping_size - offset - sizeof(header)) / sizeof(FieldT)) throw SerializationException("binary: truncated record");
+        end_offset = offset + sizeof(header) + length * sizeof(FieldT) + _binary_padding<FieldT>(length);
+        if (end_offset > mapping_size) throw SerializationException("binary: truncated record");
+
+        /* The mapping is page-aligned and records are padded to 8 bytes, so this only fails for an odd offset */
+        const char *p = base + sizeof(header);
+        if ((uintptr_t)p % std::alignment_of<FieldT>::value != 0) throw SerializationException("binary: misaligned record");
+        elements = reinterpret_cast<const FieldT*>(p);
+
+        if (verify_checksum && (header.flags & BINARY_VECTOR_CHECKSUM) && binary_checksum(elements, length * sizeof(FieldT)) != header.checksum)
+            throw SerializationException("binary: checksum mismatch");
+    }
+    catch (...)
+    {
+        munmap(mapping, mapping_size);
+        throw;
+    }
+#else
+    std::ifstream in(path.c_str(), std::ios::binary);
+    in.seekg(offset);
+    length = _read_binary_header<FieldT>(in, header);
+    if (!verify_checksum) header.flags &= ~BINARY_VECTOR_CHECKSUM;
+    _read_binary_vector(in, header, length, contents);
+    end_offset = offset + sizeof(header) + length * sizeof(FieldT) + _binary_padding<FieldT>(length);
+    elements = contents.data();
+#endif
+}
+
+template<typename FieldT>
+mapped_binary_vector<FieldT>::~mapped_binary_vector()
+{
+#ifdef LIBFQFFT_HAVE_MMAP
+    if (mapping != nullptr) munmap(mapping, mapping_size);
+#endif
+}
+
+template<typename FieldT>
+size_t mapped_binary_vector<FieldT>::size() const
+{
+    return length;
+}
+
+template<typename FieldT>
+const FieldT *mapped_binary_vector<FieldT>::data() const
+{
+    return elements;
+}
+
+template<typename FieldT>
+const FieldT *mapped_binary_vector<FieldT>::begin() const
+{
+    return elements;
+}
+
+template<typename FieldT>
+const FieldT *mapped_binary_vector<FieldT>::end() const
+{
+    return elements + length;
+}
+
+template<typename FieldT>
+const FieldT &mapped_binary_vector<FieldT>::operator[](const size_t i) const
+{
+    return elements[i];
+}
+
+template<typename FieldT>
+size_t mapped_binary_vector<FieldT>::next_offset() const
+{
+    return end_offset;
+}
+
+} // libfqfft
+
+#endif // BINARY_SERIALIZATION_TCC_
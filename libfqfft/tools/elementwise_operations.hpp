@@ -0,0 +1,61 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of element-wise vector routines.
+
+ These are the loops over coefficients (or evaluations) shared by the polynomial
+ operations: each is a plain indexed loop over contiguous elements, which the compiler
+ can vectorize for a primitive field element (such as libff::Double), and which is split
+ across the threads of the execution policy (see execution_policy.hpp) once there are
+ at least LIBFQFFT_ELEMENTWISE_PARALLEL_THRESHOLD elements.
+
+ The output may be the same array as any of the inputs.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef ELEMENTWISE_OPERATIONS_HPP_
+#define ELEMENTWISE_OPERATIONS_HPP_
+
+#include <cstddef>
+
+namespace libfqfft {
+
+/**
+ * c[i] = a[i] + b[i], for i in [0, n).
+ */
+template<typename FieldT>
+void elementwise_addition(FieldT *c, const FieldT *a, const FieldT *b, const size_t n);
+
+/**
+ * c[i] = a[i] - b[i], for i in [0, n).
+ */
+template<typename FieldT>
+void elementwise_subtraction(FieldT *c, const FieldT *a, const FieldT *b, const size_t n);
+
+/**
+ * c[i] = a[i] * b[i], for i in [0, n).
+ */
+template<typename FieldT>
+void elementwise_multiplication(FieldT *c, const FieldT *a, const FieldT *b, const size_t n);
+
+/**
+ * c[i] = -a[i], for i in [0, n).
+ */
+template<typename FieldT>
+void elementwise_negation(FieldT *c, const FieldT *a, const size_t n);
+
+/**
+ * c[i] = s * a[i], for i in [0, n).
+ */
+template<typename FieldT>
+void elementwise_scale(FieldT *c, const FieldT *a, const FieldT &s, const size_t n);
+
+} // libfqfft
+
+#include <libfqfft/tools/elementwise_operations.tcc>
+
+#endif // ELEMENTWISE_OPERATIONS_HPP_
@@ -0,0 +1,83 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of element-wise vector routines.
+
+ See elementwise_operations.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef ELEMENTWISE_OPERATIONS_TCC_
+#define ELEMENTWISE_OPERATIONS_TCC_
+
+#include <libfqfft/tools/execution_policy.hpp>
+#include <libfqfft/tools/instrumentation.hpp>
+
+/*
+ Element-wise loops over fewer elements than this stay on one thread.
+ */
+#ifndef LIBFQFFT_ELEMENTWISE_PARALLEL_THRESHOLD
+#define LIBFQFFT_ELEMENTWISE_PARALLEL_THRESHOLD ((size_t)1024)
+#endif
+
+namespace libfqfft {
+
+inline bool _elementwise_parallel(const size_t n)
+{
+    return n >= LIBFQFFT_ELEMENTWISE_PARALLEL_THRESHOLD;
+}
+
+template<typename FieldT>
+void elementwise_addition(FieldT *c, const FieldT *a, const FieldT *b, const size_t n)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(n, 0, 0);
+    parallel_for(n, [&](const size_t i) {
+            c[i] = a[i] + b[i];
+        }, _elementwise_parallel(n));
+}
+
+template<typename FieldT>
+void elementwise_subtraction(FieldT *c, const FieldT *a, const FieldT *b, const size_t n)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(n, 0, 0);
+    parallel_for(n, [&](const size_t i) {
+            c[i] = a[i] - b[i];
+        }, _elementwise_parallel(n));
+}
+
+template<typename FieldT>
+void elementwise_multiplication(FieldT *c, const FieldT *a, const FieldT *b, const size_t n)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(0, n, 0);
+    parallel_for(n, [&](const size_t i) {
+            c[i] = a[i] * b[i];
+        }, _elementwise_parallel(n));
+}
+
+template<typename FieldT>
+void elementwise_negation(FieldT *c, const FieldT *a, const size_t n)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(n, 0, 0);
+    parallel_for(n, [&](const size_t i) {
+            c[i] = -a[i];
+        }, _elementwise_parallel(n));
+}
+
+template<typename FieldT>
+void elementwise_scale(FieldT *c, const FieldT *a, const FieldT &s, const size_t n)
+{
+    LIBFQFFT_COUNT_FIELD_OPERATIONS(0, n, 0);
+    /* A copy, since s may be one of the elements of c */
+    const FieldT scalar = s;
+    parallel_for(n, [&](const size_t i) {
+            c[i] = scalar * a[i];
+        }, _elementwise_parallel(n));
+}
+
+} // libfqfft
+
+#endif // ELEMENTWISE_OPERATIONS_TCC_
@@ -42,6 +42,18 @@ private:
     std::string _error;
 };
 
+class SerializationException
+{
+public:
+    SerializationException(std::string error): _error(error) {}
+    const char* what() const
+	{
+	    return _error.c_str();
+	}
+private:
+    std::string _error;
+};
+
 } //libfqfft
 
 #endif // EXCEPTIONS_HPP_
\ No newline at end of file
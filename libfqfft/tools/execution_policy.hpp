@@ -0,0 +1,206 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of execution policies.
+
+ The parallel loops of the library (the FFT kernels, the element-wise and batch
+ routines, the polynomial algorithms) go through parallel_for below, which runs
+ them with the execution policy of the calling thread:
+ - by default, through OpenMP when MULTICORE is defined (within an enclosing
+   parallel region, the loops run serially), and serially otherwise;
+ - within an execution_scope, through the policy of the scope, e.g. a
+   thread_pool_execution_policy, whose threads steal each other's work, so that
+   concurrent (and nested) transforms share the threads of the pool instead of each
+   starting threads of its own.
+ A scope may also cap the number of threads of the loops below it (the lowest cap
+ of the nested scopes applies). evaluation_domain::set_execution_policy
+ installs such a scope around every method of a domain.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef EXECUTION_POLICY_HPP_
+#define EXECUTION_POLICY_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libfqfft {
+
+/**
+ * A way to run the chunks of a parallel loop.
+ */
+class execution_policy {
+public:
+
+    virtual ~execution_policy() {}
+
+    /**
+     * The number of threads that the chunks of a loop may run on.
+     */
+    virtual size_t concurrency() const = 0;
+
+    /**
+     * Run body(c) for each c in [0, num_chunks), possibly concurrently, and return
+     * once all are done. An exception thrown by one of them is thrown again here.
+     */
+    virtual void run(const size_t num_chunks, const std::function<void(size_t)> &body) = 0;
+
+    /**
+     * Start task and return at once, without waiting for it to be done; task must not
+     * throw. The default queues it in default_execution_pool().
+     */
+    virtual void submit(const std::function<void()> &task);
+};
+
+/**
+ * Runs the chunks one after the other, in the calling thread.
+ */
+class sequential_execution_policy : public execution_policy {
+public:
+
+    size_t concurrency() const;
+    void run(const size_t num_chunks, const std::function<void(size_t)> &body);
+    /* Runs task before returning */
+    void submit(const std::function<void()> &task);
+};
+
+/**
+ * Runs the chunks in an OpenMP parallel region of (at most) max_threads threads, or of
+ * omp_get_max_threads() if max_threads is 0, or serially when MULTICORE is not defined.
+ */
+class openmp_execution_policy : public execution_policy {
+public:
+
+    explicit openmp_execution_policy(const size_t max_threads = 0);
+
+    size_t concurrency() const;
+    void run(const size_t num_chunks, const std::function<void(size_t)> &body);
+
+private:
+
+    size_t max_threads;
+};
+
+/**
+ * A pool of num_threads threads (the hardware concurrency if 0), counting the
+ * threads that call run: each of these works on the chunks of its own loop, and of
+ * the loops nested in them, until its loop is done, while the num_threads - 1 threads
+ * of the pool work on any queued chunks and submitted tasks. A thread that waits for
+ * its loop never runs unrelated work, which could need locks that it holds.
+ * Each thread has a queue of its own, which it takes work from first; idle threads
+ * take (steal) work from the other queues.
+ */
+class thread_pool_execution_policy : public execution_policy {
+public:
+
+    explicit thread_pool_execution_policy(const size_t num_threads = 0);
+    ~thread_pool_execution_policy();
+
+    size_t concurrency() const;
+    void run(const size_t num_chunks, const std::function<void(size_t)> &body);
+    /* Queues work for the threads of the pool (or, without any, runs it before returning) */
+    void submit(const std::function<void()> &work);
+
+private:
+
+    struct task_group;
+    struct task {
+        task_group *group;
+        size_t chunk;
+    };
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    size_t num_threads;
+    /* One queue per thread of the pool, then one for the threads outside of the pool */
+    std::vector<std::unique_ptr<task_queue> > queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> num_queued;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    static const task_group *&current_group();
+    static bool is_within(const task_group *group, const task_group *within);
+
+    size_t home_queue() const;
+    bool run_queued_task(const size_t home, const task_group *within);
+    bool has_queued_task(const task_group *within);
+    void execute(const task &t);
+    void notify();
+    void worker_loop(const size_t index);
+
+    thread_pool_execution_policy(const thread_pool_execution_policy&);
+    thread_pool_execution_policy& operator=(const thread_pool_execution_policy&);
+};
+
+/**
+ * The process-wide pool (of the hardware concurrency, and at least two threads) that
+ * runs the tasks started without a policy of their own, e.g. by execution_async or an
+ * evaluation_pipeline without one, so that these share its threads instead of each
+ * starting a thread (and an OpenMP team) of its own. It is created on first use, and
+ * runs its queued tasks to completion when the program exits.
+ */
+inline thread_pool_execution_policy &default_execution_pool();
+
+/**
+ * Run the parallel loops of the calling thread through policy (or, if null, the current
+ * policy), on at most max_threads threads (or, if 0, no cap of its own), until the
+ * scope ends.
+ */
+class execution_scope {
+public:
+
+    execution_scope(const std::shared_ptr<execution_policy> &policy, const size_t max_threads = 0);
+    ~execution_scope();
+
+private:
+
+    std::shared_ptr<execution_policy> policy;
+    execution_policy *saved_policy;
+    size_t saved_max_threads;
+
+    execution_scope(const execution_scope&);
+    execution_scope& operator=(const execution_scope&);
+};
+
+/**
+ * The number of threads that the parallel loops of the calling thread may run on
+ * (1 when they run serially).
+ */
+inline size_t execution_concurrency();
+
+/**
+ * Run body(i) for each i in [0, n), in parallel unless parallel is false (each i runs
+ * on one thread, so a loop over chunks of some work may keep per-chunk scratch space).
+ */
+template<typename F>
+void parallel_for(const size_t n, const F &body, const bool parallel = true);
+
+/**
+ * Start work through policy->submit (or, if policy is null, through
+ * default_execution_pool()), with a future that becomes ready once work is done, or
+ * holds the exception it threw. The loops of work run with the policy (and no cap), or
+ * through the default pool. The policy must not be destroyed before the future is ready.
+ */
+inline std::future<void> execution_async(const std::shared_ptr<execution_policy> &policy, const std::function<void()> &work);
+
+} // libfqfft
+
+#include <libfqfft/tools/execution_policy.tcc>
+
+#endif // EXECUTION_POLICY_HPP_
@@ -0,0 +1,491 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of execution policies.
+
+ See execution_policy.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef EXECUTION_POLICY_TCC_
+#define EXECUTION_POLICY_TCC_
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
+/*
+ The loops run through a policy other than OpenMP are split in at most this many
+ chunks per thread, so that the threads that finish first can take over the rest.
+ */
+#ifndef LIBFQFFT_EXECUTION_CHUNKS_PER_THREAD
+#define LIBFQFFT_EXECUTION_CHUNKS_PER_THREAD ((size_t)4)
+#endif
+
+namespace libfqfft {
+
+/* The policy (null for the default one) and the cap (0 for none) of the calling thread */
+struct _execution_state {
+    execution_policy *policy;
+    size_t max_threads;
+};
+
+inline _execution_state& _execution_this_thread()
+{
+    static thread_local _execution_state state = { nullptr, 0 };
+    return state;
+}
+
+inline size_t _openmp_concurrency(const size_t max_threads)
+{
+#ifdef MULTICORE
+    /* Within a parallel region (e.g. one transform per thread) the loops run serially */
+    const size_t num_threads = (omp_in_parallel() ? 1 : (size_t)omp_get_max_threads());
+    return (max_threads == 0 ? num_threads : std::min(num_threads, max_threads));
+#else
+    (void)max_threads;
+    return 1;
+#endif
+}
+
+inline void execution_policy::submit(const std::function<void()> &task)
+{
+    default_execution_pool().submit(task);
+}
+
+inline size_t sequential_execution_policy::concurrency() const
+{
+    return 1;
+}
+
+inline void sequential_execution_policy::run(const size_t num_chunks, const std::function<void(size_t)> &body)
+{
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        body(c);
+    }
+}
+
+inline void sequential_execution_policy::submit(const std::function<void()> &task)
+{
+    task();
+}
+
+inline openmp_execution_policy::openmp_execution_policy(const size_t max_threads) : max_threads(max_threads)
+{
+}
+
+inline size_t openmp_execution_policy::concurrency() const
+{
+    return _openmp_concurrency(max_threads);
+}
+
+inline void openmp_execution_policy::run(const size_t num_chunks, const std::function<void(size_t)> &body)
+{
+#ifdef MULTICORE
+    const int num_threads = (int)std::max(std::min(concurrency(), num_chunks), (size_t)1);
+    #pragma omp parallel for num_threads(num_threads) if (num_threads > 1)
+#endif
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        body(c);
+    }
+}
+
+struct thread_pool_execution_policy::task_group {
+    const std::function<void(size_t)> *body;
+    _execution_state state;
+    std::atomic<size_t> remaining;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    /* The group whose chunk was running when this one started (null for the groups of submit) */
+    const task_group *parent;
+    /* For the groups of submit, which nobody waits for: their body, and they delete themselves */
+    std::function<void(size_t)> owned_body;
+    bool detached;
+
+    task_group() : body(nullptr), parent(nullptr), detached(false) {}
+};
+
+/* The pool that the calling thread belongs to, if any, and its index in it */
+struct _thread_pool_membership {
+    const thread_pool_execution_policy *pool;
+    size_t index;
+};
+
+inline _thread_pool_membership& _thread_pool_this_thread()
+{
+    static thread_local _thread_pool_membership membership = { nullptr, 0 };
+    return membership;
+}
+
+/* The group of the chunk that the calling thread is running, if any */
+inline const thread_pool_execution_policy::task_group *&thread_pool_execution_policy::current_group()
+{
+    static thread_local const task_group *group = nullptr;
+    return group;
+}
+
+/* Whether group is within (or nested, at any depth, in a chunk of) within; anything is within null */
+inline bool thread_pool_execution_policy::is_within(const task_group *group, const task_group *within)
+{
+    if (within == nullptr) return true;
+    for (; group != nullptr; group = group->parent)
+    {
+        if (group == within) return true;
+    }
+    return false;
+}
+
+inline thread_pool_execution_policy::thread_pool_execution_policy(const size_t num_threads) :
+    num_threads(num_threads == 0 ? std::max((size_t)std::thread::hardware_concurrency(), (size_t)1) : num_threads),
+    num_queued(0), stopping(false)
+{
+    for (size_t i = 0; i < this->num_threads; ++i)
+    {
+        queues.push_back(std::unique_ptr<task_queue>(new task_queue()));
+    }
+    for (size_t i = 0; i + 1 < this->num_threads; ++i)
+    {
+        workers.push_back(std::thread(&thread_pool_execution_policy::worker_loop, this, i));
+    }
+}
+
+inline thread_pool_execution_policy::~thread_pool_execution_policy()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        workers[i].join();
+    }
+}
+
+inline size_t thread_pool_execution_policy::concurrency() const
+{
+    return num_threads;
+}
+
+/* The queue that the calling thread takes work from first (and puts its work in) */
+inline size_t thread_pool_execution_policy::home_queue() const
+{
+    const _thread_pool_membership &membership = _thread_pool_this_thread();
+    return (membership.pool == this ? membership.index : queues.size() - 1);
+}
+
+inline void thread_pool_execution_policy::notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_all();
+}
+
+inline void thread_pool_execution_policy::execute(const task &t)
+{
+    task_group &group = *t.group;
+
+    _execution_state &state = _execution_this_thread();
+    const _execution_state saved = state;
+    const task_group *&current = current_group();
+    const task_group *const saved_group = current;
+    state = group.state;
+    current = &group;
+    try
+    {
+        (*group.body)(t.chunk);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(group.error_mutex);
+        if (!group.error) group.error = std::current_exception();
+    }
+    state = saved;
+    current = saved_group;
+
+    /* The group may be gone as soon as its last chunk is done, so it is not read afterwards */
+    const bool detached = group.detached;
+    if (group.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (detached) delete &group;
+        else notify();
+    }
+}
+
+/*
+ Run one queued task within the group within (any task if null): the last such one of
+ the home queue (the most recent, whose data is the most likely to be in cache), or
+ else the first such one of another queue.
+ */
+inline bool thread_pool_execution_policy::run_queued_task(const size_t home, const task_group *within)
+{
+    if (num_queued.load(std::memory_order_acquire) == 0) return false;
+
+    for (size_t k = 0; k < queues.size(); ++k)
+    {
+        task_queue &queue = *queues[(home + k) % queues.size()];
+        task t;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            if (k == 0)
+            {
+                std::deque<task>::reverse_iterator it = queue.tasks.rbegin();
+                while (it != queue.tasks.rend() && !is_within(it->group, within)) ++it;
+                if (it == queue.tasks.rend()) continue;
+                t = *it;
+                queue.tasks.erase(std::next(it).base());
+            }
+            else
+            {
+                std::deque<task>::iterator it = queue.tasks.begin();
+                while (it != queue.tasks.end() && !is_within(it->group, within)) ++it;
+                if (it == queue.tasks.end()) continue;
+                t = *it;
+                queue.tasks.erase(it);
+            }
+        }
+        num_queued.fetch_sub(1, std::memory_order_acq_rel);
+        execute(t);
+        return true;
+    }
+    return false;
+}
+
+/* Whether some queued task is within the group within; called with sleep_mutex held */
+inline bool thread_pool_execution_policy::has_queued_task(const task_group *within)
+{
+    if (num_queued.load(std::memory_order_acquire) == 0) return false;
+
+    for (size_t k = 0; k < queues.size(); ++k)
+    {
+        std::lock_guard<std::mutex> lock(queues[k]->mutex);
+        for (std::deque<task>::const_iterator it = queues[k]->tasks.begin(); it != queues[k]->tasks.end(); ++it)
+        {
+            if (is_within(it->group, within)) return true;
+        }
+    }
+    return false;
+}
+
+inline void thread_pool_execution_policy::worker_loop(const size_t index)
+{
+    _thread_pool_membership &membership = _thread_pool_this_thread();
+    membership.pool = this;
+    membership.index = index;
+
+    while (true)
+    {
+        if (run_queued_task(index, nullptr)) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this]() { return stopping || num_queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && num_queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+inline void thread_pool_execution_policy::run(const size_t num_chunks, const std::function<void(size_t)> &body)
+{
+    if (num_chunks == 0) return;
+
+    task_group group;
+    group.body = &body;
+    group.state = _execution_this_thread();
+    group.parent = current_group();
+    group.remaining.store(num_chunks, std::memory_order_relaxed);
+
+    const size_t home = home_queue();
+    if (num_chunks > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[home]->mutex);
+            for (size_t c = num_chunks - 1; c >= 1; --c)
+            {
+                const task t = { &group, c };
+                queues[home]->tasks.push_back(t);
+            }
+            num_queued.fetch_add(num_chunks - 1, std::memory_order_acq_rel);
+        }
+        notify();
+    }
+
+    const task first = { &group, 0 };
+    execute(first);
+
+    /*
+     Help with the queued chunks of this loop, and of the loops nested in it, until this
+     loop is done. Other work (unrelated loops, or the tasks of submit) could wait for
+     locks that the caller holds, or take far longer than this loop, so it is left to
+     the other threads.
+     */
+    while (group.remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (run_queued_task(home, &group)) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this, &group]() {
+                return group.remaining.load(std::memory_order_acquire) == 0 || has_queued_task(&group);
+            });
+    }
+
+    if (group.error) std::rethrow_exception(group.error);
+}
+
+inline void thread_pool_execution_policy::submit(const std::function<void()> &work)
+{
+    if (workers.empty())
+    {
+        work();
+        return;
+    }
+
+    task_group *group = new task_group();
+    group->owned_body = [work](const size_t) { work(); };
+    group->body = &group->owned_body;
+    group->state.policy = this;
+    group->state.max_threads = 0;
+    group->remaining.store(1, std::memory_order_relaxed);
+    group->detached = true;
+
+    const size_t home = home_queue();
+    {
+        std::lock_guard<std::mutex> lock(queues[home]->mutex);
+        const task t = { group, 0 };
+        queues[home]->tasks.push_back(t);
+        num_queued.fetch_add(1, std::memory_order_acq_rel);
+    }
+    notify();
+}
+
+inline thread_pool_execution_policy &default_execution_pool()
+{
+    static thread_pool_execution_policy pool(std::max((size_t)std::thread::hardware_concurrency(), (size_t)2));
+    return pool;
+}
+
+inline execution_scope::execution_scope(const std::shared_ptr<execution_policy> &policy, const size_t max_threads) :
+    policy(policy)
+{
+    _execution_state &state = _execution_this_thread();
+    saved_policy = state.policy;
+    saved_max_threads = state.max_threads;
+
+    if (policy) state.policy = policy.get();
+    if (max_threads > 0) state.max_threads = (state.max_threads == 0 ? max_threads : std::min(state.max_threads, max_threads));
+}
+
+inline execution_scope::~execution_scope()
+{
+    _execution_state &state = _execution_this_thread();
+    state.policy = saved_policy;
+    state.max_threads = saved_max_threads;
+}
+
+inline size_t execution_concurrency()
+{
+    const _execution_state &state = _execution_this_thread();
+    if (state.policy == nullptr) return _openmp_concurrency(state.max_threads);
+
+    const size_t num_threads = state.policy->concurrency();
+    return std::max((state.max_threads == 0 ? num_threads : std::min(num_threads, state.max_threads)), (size_t)1);
+}
+
+template<typename F>
+void parallel_for(const size_t n, const F &body, const bool parallel)
+{
+    const size_t num_threads = (parallel && n > 1 ? execution_concurrency() : 1);
+    execution_policy *policy = _execution_this_thread().policy;
+
+    if (num_threads <= 1)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            body(i);
+        }
+        return;
+    }
+
+    if (policy == nullptr)
+    {
+        /* The default policy, without going through std::function */
+#ifdef MULTICORE
+        #pragma omp parallel for num_threads((int)num_threads)
+#endif
+        for (size_t i = 0; i < n; ++i)
+        {
+            body(i);
+        }
+        return;
+    }
+
+    /* At most num_threads of the chunks run at a time */
+    const size_t num_chunks = std::min(n, num_threads * LIBFQFFT_EXECUTION_CHUNKS_PER_THREAD);
+    const bool capped = (num_threads < policy->concurrency());
+    const std::function<void(size_t)> chunk = [&body, n, num_chunks](const size_t c) {
+        for (size_t i = c * n / num_chunks; i < (c + 1) * n / num_chunks; ++i)
+        {
+            body(i);
+        }
+    };
+
+    if (!capped)
+    {
+        policy->run(num_chunks, chunk);
+        return;
+    }
+
+    /* Under a cap, num_threads chunks run at a time, each taking the next range from a shared counter */
+    std::atomic<size_t> next(0);
+    policy->run(num_threads, [&chunk, &next, num_chunks](const size_t) {
+            for (size_t c = next.fetch_add(1); c < num_chunks; c = next.fetch_add(1))
+            {
+                chunk(c);
+            }
+        });
+}
+
+/* A shared_ptr to policy that does not own it */
+inline std::shared_ptr<execution_policy> _execution_policy_reference(execution_policy *policy)
+{
+    return std::shared_ptr<execution_policy>(std::shared_ptr<execution_policy>(), policy);
+}
+
+inline std::future<void> execution_async(const std::shared_ptr<execution_policy> &policy, const std::function<void()> &work)
+{
+    std::shared_ptr<std::promise<void> > done(new std::promise<void>());
+    std::future<void> result = done->get_future();
+
+    /* Without a reference of its own: the last one could otherwise go in a thread of the pool */
+    execution_policy *const raw_policy = policy.get();
+    const std::function<void()> task = [raw_policy, work, done]() {
+        try
+        {
+            const execution_scope scope(_execution_policy_reference(raw_policy));
+            work();
+            done->set_value();
+        }
+        catch (...)
+        {
+            done->set_exception(std::current_exception());
+        }
+    };
+
+    if (policy) policy->submit(task);
+    else default_execution_pool().submit(task);
+    return result;
+}
+
+} // libfqfft
+
+#endif // EXECUTION_POLICY_TCC_
@@ -0,0 +1,38 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of traits of field types.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FIELD_TRAITS_HPP_
+#define FIELD_TRAITS_HPP_
+
+#include <type_traits>
+#include <utility>
+
+namespace libfqfft {
+
+/**
+ * Whether FieldT is a prime field with the libff Fp_model interface: as_bigint() (the
+ * canonical representative), field_char(), and a constructor from that bigint (unlike,
+ * e.g., libff::Double).
+ */
+template<typename FieldT>
+class is_prime_field {
+    template<typename T>
+    static std::true_type test(decltype(T(T::field_char())) *, decltype(std::declval<T>().as_bigint()) *);
+    template<typename T>
+    static std::false_type test(...);
+
+public:
+    static const bool value = decltype(test<FieldT>(nullptr, nullptr))::value;
+};
+
+} // libfqfft
+
+#endif // FIELD_TRAITS_HPP_
@@ -0,0 +1,181 @@
+/** @file
+ *****************************************************************************
+
+ Declaration of instrumentation hooks.
+
+ When LIBFQFFT_INSTRUMENTATION is defined, the library keeps, in each thread,
+ counters of
+ - the field additions (and subtractions), multiplications and inversions made by
+   its kernels (the FFTs, batch inversions and element-wise loops), and
+ - the bytes of the temporary vectors that these kernels allocate,
+ and records, for each method of the evaluation domains, the number of calls, the
+ wall time and the counters of those calls. The counts of a kernel are charged to
+ the thread that calls it (even when the kernel splits its work between threads),
+ so the statistics of a method cover all the work done on its behalf. Each thread
+ keeps the statistics of its own calls, which are merged when they are read or exported.
+
+ The statistics can be read back, exported as JSON or in the Prometheus text format,
+ or passed, call by call, to a callback set with set_instrumentation_callback.
+
+ When LIBFQFFT_INSTRUMENTATION is not defined, the hooks (the LIBFQFFT_COUNT_* and
+ LIBFQFFT_INSTRUMENT_* macros) expand to nothing, and the functions below report
+ empty statistics.
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef INSTRUMENTATION_HPP_
+#define INSTRUMENTATION_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <stdint.h>
+
+namespace libfqfft {
+
+struct instrumentation_counters {
+    uint64_t additions;
+    uint64_t multiplications;
+    uint64_t inversions;
+    uint64_t bytes_allocated;
+
+    instrumentation_counters() : additions(0), multiplications(0), inversions(0), bytes_allocated(0) {}
+
+    instrumentation_counters& operator+=(const instrumentation_counters &other);
+    instrumentation_counters operator-(const instrumentation_counters &other) const;
+};
+
+struct instrumentation_method_statistics {
+    uint64_t calls;
+    double seconds;
+    instrumentation_counters counters;
+
+    instrumentation_method_statistics() : calls(0), seconds(0) {}
+};
+
+typedef std::function<void(const std::string &method, const instrumentation_method_statistics &call)> instrumentation_callback;
+
+/**
+ * Whether the library was compiled with LIBFQFFT_INSTRUMENTATION.
+ */
+inline bool instrumentation_enabled();
+
+/**
+ * The counters of the calling thread, and their sum over all threads (including
+ * the threads that have exited), since the last reset_instrumentation.
+ */
+inline instrumentation_counters instrumentation_thread_counters();
+inline instrumentation_counters instrumentation_total_counters();
+
+/**
+ * The statistics of each method (e.g. "basic_radix2_domain::FFT", for all of its
+ * overloads); the time and counters of a method include those of the methods it calls.
+ */
+inline std::map<std::string, instrumentation_method_statistics> instrumentation_statistics();
+
+/**
+ * Reset all the counters and statistics (the callback stays).
+ */
+inline void reset_instrumentation();
+
+/**
+ * Call callback at the end of each method call, in the calling thread, with the
+ * statistics of that call alone (calls == 1). An empty callback removes it.
+ */
+inline void set_instrumentation_callback(const instrumentation_callback &callback);
+
+/**
+ * The statistics, as a JSON object {"methods": {name: {...}}, "totals": {...}},
+ * or as Prometheus counters (libfqfft_method_*_total{method="..."} and libfqfft_*_total).
+ */
+inline std::string instrumentation_json();
+inline std::string instrumentation_prometheus();
+
+/*
+ The state of the instrumentation of one thread. The statistics of the methods are
+ keyed by the address of their name, and merged by name when they are read.
+ */
+struct _instrumentation_thread_state {
+    std::atomic<uint64_t> additions;
+    std::atomic<uint64_t> multiplications;
+    std::atomic<uint64_t> inversions;
+    std::atomic<uint64_t> bytes_allocated;
+    size_t pause_depth;
+
+    /* Only taken by this thread and by the readers of the statistics */
+    std::mutex methods_mutex;
+    std::map<const char*, instrumentation_method_statistics> methods;
+
+    _instrumentation_thread_state();
+    ~_instrumentation_thread_state();
+
+    instrumentation_counters snapshot() const;
+    void count(const uint64_t additions, const uint64_t multiplications, const uint64_t inversions, const uint64_t bytes);
+    void record(const char *method, const instrumentation_method_statistics &call);
+};
+
+inline _instrumentation_thread_state& _instrumentation_this_thread();
+
+/**
+ * Records the wall time and the counters of the calling thread over its lifetime
+ * as one call of method.
+ */
+class instrumentation_scope {
+public:
+
+    explicit instrumentation_scope(const char *method);
+    ~instrumentation_scope();
+
+private:
+
+    const char *method;
+    instrumentation_counters start_counters;
+    std::chrono::steady_clock::time_point start_time;
+
+    instrumentation_scope(const instrumentation_scope&);
+    instrumentation_scope& operator=(const instrumentation_scope&);
+};
+
+/**
+ * Stops the counting in the calling thread over its lifetime, for work that
+ * another thread has already counted.
+ */
+class instrumentation_pause {
+public:
+
+    instrumentation_pause();
+    ~instrumentation_pause();
+
+private:
+
+    instrumentation_pause(const instrumentation_pause&);
+    instrumentation_pause& operator=(const instrumentation_pause&);
+};
+
+} // libfqfft
+
+#ifdef LIBFQFFT_INSTRUMENTATION
+#define LIBFQFFT_INSTRUMENT_SCOPE(method) ::libfqfft::instrumentation_scope _libfqfft_instrumentation_scope(method)
+#define LIBFQFFT_INSTRUMENT_PAUSE() ::libfqfft::instrumentation_pause _libfqfft_instrumentation_pause
+#define LIBFQFFT_COUNT_FIELD_OPERATIONS(additions, multiplications, inversions) \
+    ::libfqfft::_instrumentation_this_thread().count((additions), (multiplications), (inversions), 0)
+#define LIBFQFFT_COUNT_ALLOCATION(bytes) ::libfqfft::_instrumentation_this_thread().count(0, 0, 0, (bytes))
+#else
+#define LIBFQFFT_INSTRUMENT_SCOPE(method)
+#define LIBFQFFT_INSTRUMENT_PAUSE()
+#define LIBFQFFT_COUNT_FIELD_OPERATIONS(additions, multiplications, inversions)
+#define LIBFQFFT_COUNT_ALLOCATION(bytes)
+#endif
+
+#include <libfqfft/tools/instrumentation.tcc>
+
+#endif // INSTRUMENTATION_HPP_
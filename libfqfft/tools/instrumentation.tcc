@@ -0,0 +1,320 @@
+/** @file
+ *****************************************************************************
+
+ Implementation of instrumentation hooks.
+
+ See instrumentation.hpp .
+
+ *****************************************************************************
+ * @author     This file is part of libfqfft, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef INSTRUMENTATION_TCC_
+#define INSTRUMENTATION_TCC_
+
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace libfqfft {
+
+inline instrumentation_counters& instrumentation_counters::operator+=(const instrumentation_counters &other)
+{
+    additions += other.additions;
+    multiplications += other.multiplications;
+    inversions += other.inversions;
+    bytes_allocated += other.bytes_allocated;
+    return *this;
+}
+
+/* Saturates at 0, for counters reset in between */
+inline instrumentation_counters instrumentation_counters::operator-(const instrumentation_counters &other) const
+{
+    instrumentation_counters result;
+    result.additions = (additions >= other.additions ? additions - other.additions : additions);
+    result.multiplications = (multiplications >= other.multiplications ? multiplications - other.multiplications : multiplications);
+    result.inversions = (inversions >= other.inversions ? inversions - other.inversions : inversions);
+    result.bytes_allocated = (bytes_allocated >= other.bytes_allocated ? bytes_allocated - other.bytes_allocated : bytes_allocated);
+    return result;
+}
+
+/*
+ The threads and what the exited ones left. The callback is swapped atomically, and
+ has_callback spares the calls the atomic load when there is none.
+ */
+struct _instrumentation_registry {
+    std::mutex mutex;
+    std::set<_instrumentation_thread_state*> threads;
+    instrumentation_counters exited_threads;
+    std::map<std::string, instrumentation_method_statistics> exited_methods;
+    std::shared_ptr<const instrumentation_callback> callback;
+    std::atomic<bool> has_callback;
+
+    _instrumentation_registry() : has_callback(false) {}
+};
+
+inline void _instrumentation_merge(std::map<std::string, instrumentation_method_statistics> &methods,
+                                   const std::map<const char*, instrumentation_method_statistics> &thread_methods)
+{
+    for (std::map<const char*, instrumentation_method_statistics>::const_iterator it = thread_methods.begin(); it != thread_methods.end(); ++it)
+    {
+        instrumentation_method_statistics &s = methods[it->first];
+        s.calls += it->second.calls;
+        s.seconds += it->second.seconds;
+        s.counters += it->second.counters;
+    }
+}
+
+/*
+ Never destroyed, so that the threads that exit after the static destructors (e.g. those
+ of the default pool, see execution_policy.hpp) can still unregister.
+ */
+inline _instrumentation_registry& _instrumentation_registry_instance()
+{
+    static _instrumentation_registry *registry = new _instrumentation_registry();
+    return *registry;
+}
+
+inline _instrumentation_thread_state::_instrumentation_thread_state() :
+    additions(0), multiplications(0), inversions(0), bytes_allocated(0), pause_depth(0)
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.insert(this);
+}
+
+inline _instrumentation_thread_state::~_instrumentation_thread_state()
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.exited_threads += snapshot();
+    {
+        std::lock_guard<std::mutex> methods_lock(methods_mutex);
+        _instrumentation_merge(registry.exited_methods, methods);
+    }
+    registry.threads.erase(this);
+}
+
+inline instrumentation_counters _instrumentation_thread_state::snapshot() const
+{
+    instrumentation_counters result;
+    result.additions = additions.load(std::memory_order_relaxed);
+    result.multiplications = multiplications.load(std::memory_order_relaxed);
+    result.inversions = inversions.load(std::memory_order_relaxed);
+    result.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+    return result;
+}
+
+inline void _instrumentation_thread_state::count(const uint64_t num_additions, const uint64_t num_multiplications,
+                                                 const uint64_t num_inversions, const uint64_t bytes)
+{
+    if (pause_depth > 0) return;
+
+    /* Only this thread adds to its counters; the atomics let the others read them */
+    additions.fetch_add(num_additions, std::memory_order_relaxed);
+    multiplications.fetch_add(num_multiplications, std::memory_order_relaxed);
+    inversions.fetch_add(num_inversions, std::memory_order_relaxed);
+    bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+inline void _instrumentation_thread_state::record(const char *method, const instrumentation_method_statistics &call)
+{
+    std::lock_guard<std::mutex> lock(methods_mutex);
+    instrumentation_method_statistics &s = methods[method];
+    s.calls += call.calls;
+    s.seconds += call.seconds;
+    s.counters += call.counters;
+}
+
+inline _instrumentation_thread_state& _instrumentation_this_thread()
+{
+    static thread_local _instrumentation_thread_state state;
+    return state;
+}
+
+inline bool instrumentation_enabled()
+{
+#ifdef LIBFQFFT_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline instrumentation_counters instrumentation_thread_counters()
+{
+    return _instrumentation_this_thread().snapshot();
+}
+
+inline instrumentation_counters instrumentation_total_counters()
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    instrumentation_counters total = registry.exited_threads;
+    for (std::set<_instrumentation_thread_state*>::const_iterator it = registry.threads.begin(); it != registry.threads.end(); ++it)
+    {
+        total += (*it)->snapshot();
+    }
+    return total;
+}
+
+inline std::map<std::string, instrumentation_method_statistics> instrumentation_statistics()
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::map<std::string, instrumentation_method_statistics> methods = registry.exited_methods;
+    for (std::set<_instrumentation_thread_state*>::const_iterator it = registry.threads.begin(); it != registry.threads.end(); ++it)
+    {
+        std::lock_guard<std::mutex> methods_lock((*it)->methods_mutex);
+        _instrumentation_merge(methods, (*it)->methods);
+    }
+    return methods;
+}
+
+inline void reset_instrumentation()
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    registry.exited_threads = instrumentation_counters();
+    registry.exited_methods.clear();
+    for (std::set<_instrumentation_thread_state*>::const_iterator it = registry.threads.begin(); it != registry.threads.end(); ++it)
+    {
+        {
+            std::lock_guard<std::mutex> methods_lock((*it)->methods_mutex);
+            (*it)->methods.clear();
+        }
+        (*it)->additions.store(0, std::memory_order_relaxed);
+        (*it)->multiplications.store(0, std::memory_order_relaxed);
+        (*it)->inversions.store(0, std::memory_order_relaxed);
+        (*it)->bytes_allocated.store(0, std::memory_order_relaxed);
+    }
+}
+
+inline void set_instrumentation_callback(const instrumentation_callback &callback)
+{
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    std::shared_ptr<const instrumentation_callback> stored;
+    if (callback) stored = std::make_shared<const instrumentation_callback>(callback);
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::atomic_store(&registry.callback, stored);
+    registry.has_callback.store((bool)stored, std::memory_order_release);
+}
+
+inline std::string _instrumentation_escape(const std::string &s)
+{
+    std::string result;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        if (s[i] == '"' || s[i] == '\\') result += '\\';
+        result += s[i];
+    }
+    return result;
+}
+
+inline void _instrumentation_json_counters(std::ostream &out, const instrumentation_counters &c)
+{
+    out << "\"additions\": " << c.additions
+        << ", \"multiplications\": " << c.multiplications
+        << ", \"inversions\": " << c.inversions
+        << ", \"bytes_allocated\": " << c.bytes_allocated;
+}
+
+inline std::string instrumentation_json()
+{
+    const std::map<std::string, instrumentation_method_statistics> methods = instrumentation_statistics();
+    const instrumentation_counters totals = instrumentation_total_counters();
+
+    std::ostringstream out;
+    out.precision(9);
+    out << "{\"methods\": {";
+    for (std::map<std::string, instrumentation_method_statistics>::const_iterator it = methods.begin(); it != methods.end(); ++it)
+    {
+        if (it != methods.begin()) out << ", ";
+        out << "\"" << _instrumentation_escape(it->first) << "\": {\"calls\": " << it->second.calls
+            << ", \"seconds\": " << std::fixed << it->second.seconds << ", ";
+        _instrumentation_json_counters(out, it->second.counters);
+        out << "}";
+    }
+    out << "}, \"totals\": {";
+    _instrumentation_json_counters(out, totals);
+    out << "}}";
+    return out.str();
+}
+
+inline std::string instrumentation_prometheus()
+{
+    const std::map<std::string, instrumentation_method_statistics> methods = instrumentation_statistics();
+    const instrumentation_counters totals = instrumentation_total_counters();
+
+    const char *names[] = { "calls", "seconds", "field_additions", "field_multiplications", "field_inversions", "bytes_allocated" };
+
+    std::ostringstream out;
+    out.precision(9);
+    for (size_t k = 0; k < 6; ++k)
+    {
+        out << "# TYPE libfqfft_method_" << names[k] << "_total counter\n";
+        for (std::map<std::string, instrumentation_method_statistics>::const_iterator it = methods.begin(); it != methods.end(); ++it)
+        {
+            const instrumentation_method_statistics &s = it->second;
+            out << "libfqfft_method_" << names[k] << "_total{method=\"" << _instrumentation_escape(it->first) << "\"} ";
+            switch (k)
+            {
+            case 0: out << s.calls; break;
+            case 1: out << std::fixed << s.seconds; break;
+            case 2: out << s.counters.additions; break;
+            case 3: out << s.counters.multiplications; break;
+            case 4: out << s.counters.inversions; break;
+            default: out << s.counters.bytes_allocated; break;
+            }
+            out << "\n";
+        }
+    }
+
+    const uint64_t total_values[] = { totals.additions, totals.multiplications, totals.inversions, totals.bytes_allocated };
+    for (size_t k = 2; k < 6; ++k)
+    {
+        out << "# TYPE libfqfft_" << names[k] << "_total counter\n"
+            << "libfqfft_" << names[k] << "_total " << total_values[k-2] << "\n";
+    }
+    return out.str();
+}
+
+inline instrumentation_scope::instrumentation_scope(const char *method) :
+    method(method), start_counters(instrumentation_thread_counters()), start_time(std::chrono::steady_clock::now())
+{
+}
+
+inline instrumentation_scope::~instrumentation_scope()
+{
+    instrumentation_method_statistics call;
+    call.calls = 1;
+    call.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    _instrumentation_thread_state &state = _instrumentation_this_thread();
+    call.counters = state.snapshot() - start_counters;
+    state.record(method, call);
+
+    _instrumentation_registry &registry = _instrumentation_registry_instance();
+    if (!registry.has_callback.load(std::memory_order_acquire)) return;
+    const std::shared_ptr<const instrumentation_callback> callback = std::atomic_load(&registry.callback);
+    if (callback) (*callback)(method, call);
+}
+
+inline instrumentation_pause::instrumentation_pause()
+{
+    ++_instrumentation_this_thread().pause_depth;
+}
+
+inline instrumentation_pause::~instrumentation_pause()
+{
+    --_instrumentation_this_thread().pause_depth;
+}
+
+} // libfqfft
+
+#endif // INSTRUMENTATION_TCC_
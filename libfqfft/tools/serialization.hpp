@@ -58,6 +58,9 @@ namespace libfqfft {
  *
  * The binary serialization of algebraic objects is currently *not*
  * portable between machines of different word sizes.
+ *
+ * For large vectors of field elements, binary_serialization.hpp has a
+ * compact binary format that can also be memory-mapped.
  */
 
 #ifdef BINARY_OUTPUT